@@ -0,0 +1,270 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+
+#include "Benchmark.h"
+
+
+std::string BenchmarkResult::key() const
+{
+    std::ostringstream stream;
+    stream << group << '/' << name << '/' << size << '/' << threads;
+    return stream.str();
+}
+
+Benchmark::Benchmark()
+{}
+
+Benchmark::~Benchmark()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////
+// run one case: warmup (not measured), then the measured repetitions
+////////////////////////////////////////////////////////////////////////////////////
+void Benchmark::run(const std::string &group, const std::string &name, const std::string &size, const int threads,
+                    const double pixels, const std::function<void()> &function)
+{
+    BenchmarkResult result;
+    result.group = group;
+    result.name = name;
+    result.size = size;
+    result.threads = threads;
+    result.pixels = pixels;
+    if (!filter.empty() && result.key().find(filter) == std::string::npos)
+        return;
+
+    // warmup: caches, allocation of the output buffers, thread start
+    for (int i = 0; i < warmup; ++i)
+    {
+        function();
+    }
+
+    std::vector<double> times(std::max(1, repetitions));
+    for (auto &time : times)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        function();
+        time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now() - start).count() / 1000000.0;
+    }
+
+    add(group, name, size, threads, pixels, times);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// statistics of times which were measured by the caller (e.g. the stages of the pipeline)
+////////////////////////////////////////////////////////////////////////////////////
+void Benchmark::add(const std::string &group, const std::string &name, const std::string &size, const int threads,
+                    const double pixels, std::vector<double> times)
+{
+    BenchmarkResult result;
+    result.group = group;
+    result.name = name;
+    result.size = size;
+    result.threads = threads;
+    result.pixels = pixels;
+    if (times.empty() || (!filter.empty() && result.key().find(filter) == std::string::npos))
+        return;
+
+    // statistics
+    std::sort(times.begin(), times.end());
+    size_t n = times.size();
+    result.repetitions = int(n);
+    result.min = times.front();
+    result.max = times.back();
+    result.median = (n % 2) ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+    double sum = 0.0;
+    for (auto time : times)
+        sum += time;
+    result.mean = sum / n;
+    double squares = 0.0;
+    for (auto time : times)
+        squares += (time - result.mean) * (time - result.mean);
+    result.stddev = n > 1 ? std::sqrt(squares / (n - 1)) : 0.0;
+
+    std::cout << std::left << std::setw(16) << group << std::setw(34) << name << std::setw(11) << size
+              << std::right << std::setw(3) << threads << " threads: median " << std::fixed << std::setprecision(3)
+              << std::setw(10) << result.median << " ms (min " << result.min << ", stddev " << result.stddev
+              << ") " << std::setprecision(1) << result.megapixelsPerSecond() << " MP/s\n";
+
+    results.push_back(result);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// machine-readable output (the CSV file can be used as baseline)
+////////////////////////////////////////////////////////////////////////////////////
+void Benchmark::writeCsv(const std::string &fileName) const
+{
+    std::ofstream file(fileName);
+    file << std::fixed << std::setprecision(4);
+    file << "group,name,size,threads,repetitions,min_ms,median_ms,mean_ms,stddev_ms,max_ms,mp_per_s\n";
+    for (const auto &result : results)
+    {
+        file << result.group << ',' << result.name << ',' << result.size << ',' << result.threads << ','
+             << result.repetitions << ',' << result.min << ',' << result.median << ',' << result.mean << ','
+             << result.stddev << ',' << result.max << ',' << result.megapixelsPerSecond() << '\n';
+    }
+}
+
+// text as content of a JSON string: quotes, backslashes and control characters are escaped
+static std::string escapeJson(const std::string &text)
+{
+    std::ostringstream escaped;
+    for (unsigned char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped << '\\' << char(c);
+        else if (c < 0x20)
+            escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+        else
+            escaped << char(c);
+    }
+    return escaped.str();
+}
+
+void Benchmark::writeJson(const std::string &fileName) const
+{
+    std::ofstream file(fileName);
+    file << std::fixed << std::setprecision(4);
+    file << "[\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchmarkResult &result = results[i];
+        file << "  {\"group\": \"" << escapeJson(result.group) << "\", \"name\": \"" << escapeJson(result.name)
+             << "\", \"size\": \"" << escapeJson(result.size) << "\", \"threads\": " << result.threads
+             << ", \"repetitions\": " << result.repetitions
+             << ", \"min_ms\": " << result.min << ", \"median_ms\": " << result.median << ", \"mean_ms\": "
+             << result.mean << ", \"stddev_ms\": " << result.stddev << ", \"max_ms\": " << result.max
+             << ", \"mp_per_s\": " << result.megapixelsPerSecond() << "}" << (i + 1 < results.size() ? "," : "")
+             << "\n";
+    }
+    file << "]\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// read a CSV file written by 'writeCsv'
+////////////////////////////////////////////////////////////////////////////////////
+bool Benchmark::readCsv(const std::string &fileName, std::vector<BenchmarkResult> *baseline)
+{
+    std::ifstream file(fileName);
+    if (!file.is_open())
+    {
+        std::cout << "Benchmark: unable to read baseline '" << fileName << "'\n";
+        return false;
+    }
+
+    std::string line;
+    std::getline(file, line); // header
+    while (std::getline(file, line))
+    {
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+            fields.push_back(field);
+        if (fields.size() < 11)
+            continue;
+
+        BenchmarkResult result;
+        result.group = fields[0];
+        result.name = fields[1];
+        result.size = fields[2];
+        result.threads = std::atoi(fields[3].c_str());
+        result.repetitions = std::atoi(fields[4].c_str());
+        result.min = std::atof(fields[5].c_str());
+        result.median = std::atof(fields[6].c_str());
+        result.mean = std::atof(fields[7].c_str());
+        result.stddev = std::atof(fields[8].c_str());
+        result.max = std::atof(fields[9].c_str());
+        baseline->push_back(result);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// compare the medians with a baseline
+//
+// note: the median is used because single slow repetitions (e.g. the scheduler)
+//       would make the mean unstable
+////////////////////////////////////////////////////////////////////////////////////
+int Benchmark::compare(const std::string &baselineFile, const double tolerance) const
+{
+    std::vector<BenchmarkResult> baseline;
+    if (!readCsv(baselineFile, &baseline))
+        return -1;
+
+    std::map<std::string, double> baselineMedian;
+    for (const auto &result : baseline)
+        baselineMedian[result.key()] = result.median;
+
+    int regressions = 0;
+    int compared = 0;
+    std::cout << "\nComparison with baseline '" << baselineFile << "' (tolerance " << std::setprecision(0)
+              << tolerance * 100.0 << "%):\n";
+    for (const auto &result : results)
+    {
+        auto it = baselineMedian.find(result.key());
+        if (it == baselineMedian.end() || it->second <= 0.0)
+            continue;
+        ++compared;
+
+        double ratio = result.median / it->second;
+        bool regression = ratio > 1.0 + tolerance;
+        bool improvement = ratio < 1.0 - tolerance;
+        if (!regression && !improvement)
+            continue;
+
+        std::cout << (regression ? "  REGRESSION  " : "  improvement ") << std::left << std::setw(60) << result.key()
+                  << std::right << std::fixed << std::setprecision(3) << it->second << " ms -> " << result.median
+                  << " ms (" << std::showpos << std::setprecision(1) << (ratio - 1.0) * 100.0 << std::noshowpos
+                  << "%)\n";
+        if (regression)
+            ++regressions;
+    }
+    std::cout << "  " << compared << " cases compared, " << regressions << " regressions\n";
+    return regressions;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// helpers for the command line
+////////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> splitList(const std::string &text)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        if (!item.empty())
+            items.push_back(item);
+    }
+    return items;
+}
+
+bool parseSize(const std::string &name, cv::Size *size)
+{
+    if (name == "vga")
+        *size = cv::Size(640, 480);
+    else if (name == "hd")
+        *size = cv::Size(1280, 720);
+    else if (name == "fullhd")
+        *size = cv::Size(1920, 1080);
+    else if (name == "4k")
+        *size = cv::Size(3840, 2160);
+    else
+    {
+        // e.g. "800x600"
+        int width = 0, height = 0;
+        char separator = 0;
+        std::istringstream stream(name);
+        if (!(stream >> width >> separator >> height) || separator != 'x' || width < 64 || height < 64)
+            return false;
+        *size = cv::Size(width, height);
+    }
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <opencv2/core/core.hpp>
+
+// statistics of the repetitions of one benchmark case (times in ms)
+struct BenchmarkResult
+{
+    std::string group;  // class of the operator (e.g. "Threshold")
+    std::string name;   // variant (e.g. "loop_ptr2")
+    std::string size;   // image size (e.g. "1920x1080")
+    int threads = 1;
+    int repetitions = 0;
+    double pixels = 0.0; // pixels per run (for the throughput)
+
+    double min = 0.0;
+    double median = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double max = 0.0;
+
+    // key of a case in a baseline (group/name/size/threads)
+    std::string key() const;
+    double megapixelsPerSecond() const { return median > 0.0 ? pixels / (median * 1000.0) : 0.0; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// run benchmark cases: warmup, repetitions, statistics, CSV/JSON output and the
+// comparison with a baseline (a CSV file of a previous run)
+////////////////////////////////////////////////////////////////////////////////////
+class Benchmark
+{
+public:
+    Benchmark();
+    ~Benchmark();
+
+    int warmup = 2;
+    int repetitions = 10;
+    std::string filter; // run only cases whose key contains this text (empty: all)
+
+    // run a case (skipped if it does not match the filter)
+    void run(const std::string &group, const std::string &name, const std::string &size, const int threads,
+             const double pixels, const std::function<void()> &function);
+
+    // add a case whose times (ms) were measured by the caller
+    void add(const std::string &group, const std::string &name, const std::string &size, const int threads,
+             const double pixels, std::vector<double> times);
+
+    const std::vector<BenchmarkResult> &getResults() const { return results; }
+
+    void writeCsv(const std::string &fileName) const;
+    void writeJson(const std::string &fileName) const;
+
+    // cases whose median is slower than (1 + tolerance) * median of the baseline
+    // returns the number of regressions (cases which are not in the baseline are ignored)
+    int compare(const std::string &baselineFile, const double tolerance) const;
+
+private:
+    static bool readCsv(const std::string &fileName, std::vector<BenchmarkResult> *baseline);
+
+    std::vector<BenchmarkResult> results;
+};
+
+// helpers for the command line
+std::vector<std::string> splitList(const std::string &text); // comma separated list
+bool parseSize(const std::string &name, cv::Size *size);    // vga, hd, fullhd, 4k or <w>x<h>
+
+#endif /* BENCHMARK_H */
@@ -0,0 +1,400 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include <opencv2/core/core.hpp>
+
+#include "PipelineBenchmark.h"
+#include "Benchmark.h"
+#include "SceneGenerator.h"
+#include "../Coin Detection/CoinDetector.h"
+
+// coins which are covered more than this are not expected to be found
+static const float minVisible = 0.5f;
+
+// stages of the coin detection (same order as in CoinDetector::detectRegion)
+static const char *stageNames[] = { "prepare", "findCircles", "removeOverlapping", "refineCircles", "classify",
+                                    "total" };
+static const int stageCount = sizeof(stageNames) / sizeof(stageNames[0]);
+
+// accuracy of one setting (sums over all scenes)
+struct PipelineAccuracy
+{
+    std::string size;
+    float cellStep = 1.0f;
+    float phiStep = 1.0f;
+
+    int expected = 0;   // coins in the ground truth (visible >= minVisible)
+    int detected = 0;   // circles after removeOverlappingCircles
+    int matched = 0;    // circles with a coin of the ground truth
+    int ignored = 0;    // circles of strongly covered coins (neither right nor wrong)
+    int classified = 0; // matched circles with the right value
+    double centerError = 0.0; // sum (px)
+    double radiusError = 0.0; // sum (px)
+
+    double recall() const { return expected > 0 ? double(matched) / expected : 0.0; }
+    double precision() const { return detected - ignored > 0 ? double(matched) / (detected - ignored) : 0.0; }
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// match the circles with the ground truth (greedy, closest pairs first)
+//
+// a circle matches a coin if its center is closer than half of the coin's radius
+////////////////////////////////////////////////////////////////////////////////////
+static void matchCircles(const std::vector<SceneCoin> &truth, const std::vector<CircleItem> &circles,
+                         const std::vector<double> &values, PipelineAccuracy *accuracy)
+{
+    struct Pair
+    {
+        float distance;
+        size_t coin, circle;
+    };
+    std::vector<Pair> pairs;
+    for (size_t i = 0; i < truth.size(); ++i)
+    {
+        for (size_t j = 0; j < circles.size(); ++j)
+        {
+            float dx = circles[j].xf - truth[i].center.x;
+            float dy = circles[j].yf - truth[i].center.y;
+            float distance = std::sqrt(dx * dx + dy * dy);
+            if (distance < 0.5f * truth[i].radius)
+                pairs.push_back({ distance, i, j });
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](const Pair &a, const Pair &b) { return a.distance < b.distance; });
+
+    std::vector<bool> coinUsed(truth.size(), false), circleUsed(circles.size(), false);
+    for (const auto &pair : pairs)
+    {
+        if (coinUsed[pair.coin] || circleUsed[pair.circle])
+            continue;
+        coinUsed[pair.coin] = true;
+        circleUsed[pair.circle] = true;
+
+        const SceneCoin &coin = truth[pair.coin];
+        if (coin.visible < minVisible)
+        {
+            ++accuracy->ignored;
+            continue;
+        }
+        ++accuracy->matched;
+        accuracy->centerError += pair.distance;
+        accuracy->radiusError += std::abs(circles[pair.circle].rf - coin.radius);
+        if (std::abs(values[pair.circle] - coin.value) < 0.001)
+            ++accuracy->classified;
+    }
+
+    for (const auto &coin : truth)
+    {
+        if (coin.visible >= minVisible)
+            ++accuracy->expected;
+    }
+    accuracy->detected += int(circles.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// accuracy of all settings (CSV)
+////////////////////////////////////////////////////////////////////////////////////
+static void writeAccuracy(const std::string &fileName, const std::vector<PipelineAccuracy> &accuracies)
+{
+    std::ofstream file(fileName);
+    file << std::fixed << std::setprecision(4);
+    file << "size,cell_step,phi_step,expected,detected,matched,recall,precision,center_error_px,radius_error_px,"
+            "classification\n";
+    for (const auto &accuracy : accuracies)
+    {
+        int matched = std::max(1, accuracy.matched);
+        file << accuracy.size << ',' << accuracy.cellStep << ',' << accuracy.phiStep << ',' << accuracy.expected
+             << ',' << accuracy.detected << ',' << accuracy.matched << ',' << accuracy.recall() << ','
+             << accuracy.precision() << ',' << accuracy.centerError / matched << ','
+             << accuracy.radiusError / matched << ',' << double(accuracy.classified) / matched << '\n';
+    }
+}
+
+static std::string stepName(const float cellStep, const float phiStep)
+{
+    std::ostringstream stream;
+    stream << "cell " << cellStep << " phi " << phiStep;
+    return stream.str();
+}
+
+static double millisecondsSince(const std::chrono::high_resolution_clock::time_point &start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start).count() / 1000000.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// all settings for one image size
+//
+// 1. calibration with a scene of the reference coin (radius and colors of the ground truth,
+//    so the accuracy does not depend on the calibration)
+// 2. every scene runs 'warmup' + 'repetitions' times per setting, every stage is measured
+////////////////////////////////////////////////////////////////////////////////////
+static bool runScenes(Benchmark *benchmark, SceneSettings scene, const int sceneCount, const CoinSettings &baseSettings,
+                      const std::vector<float> &cellSteps, const std::vector<float> &phiSteps,
+                      const AccumulatorType accumulatorType, std::vector<PipelineAccuracy> *accuracies)
+{
+    std::ostringstream sizeStream;
+    sizeStream << scene.size.width << 'x' << scene.size.height;
+    std::string size = sizeStream.str();
+
+    SceneGenerator generator;
+    CoinDetector detector;
+    detector.segmentation->accumulatorType = accumulatorType;
+    Coin coin;
+
+    // calibration
+    cv::Mat image;
+    std::vector<SceneCoin> reference;
+    generator.generateSingle(scene, coin.referenceCoinValue, image, &reference);
+    coin.setReferenceCoin(image, coin.referenceCoinValue, cvRound(reference[0].radius),
+                          cvRound(reference[0].center.x), cvRound(reference[0].center.y));
+    if (coin.radiusMinPixel <= 0 || coin.radiusMaxPixel <= coin.radiusMinPixel)
+    {
+        std::cout << "Pipeline: calibration failed for " << size << "\n";
+        return false;
+    }
+
+    CoinSettings settings = baseSettings;
+    settings.view = cv::Rect(0, 0, scene.size.width, scene.size.height);
+    settings.radiusMin = coin.radiusMinPixel;
+    settings.radiusMax = coin.radiusMaxPixel;
+
+    // scenes (generated once, the same for all settings)
+    std::vector<cv::Mat> images(sceneCount);
+    std::vector<std::vector<SceneCoin>> truths(sceneCount);
+    unsigned int firstSeed = scene.seed;
+    for (int i = 0; i < sceneCount; ++i)
+    {
+        scene.seed = firstSeed + unsigned(i);
+        generator.generate(scene, images[i], &truths[i]);
+    }
+
+    double pixels = double(scene.size.area());
+    CoinFrame frame;
+    for (auto cellStep : cellSteps)
+    {
+        for (auto phiStep : phiSteps)
+        {
+            settings.cellStep = cellStep;
+            settings.phiStep = phiStep;
+
+            PipelineAccuracy accuracy;
+            accuracy.size = size;
+            accuracy.cellStep = cellStep;
+            accuracy.phiStep = phiStep;
+
+            std::vector<std::vector<double>> times(stageCount);
+            double edgePixels = 0.0; // (votes of the Hough transformation per radius and angle)
+            for (int i = 0; i < sceneCount; ++i)
+            {
+                for (int repetition = -benchmark->warmup; repetition < benchmark->repetitions; ++repetition)
+                {
+                    double stageTimes[stageCount];
+                    frame.input = images[i];
+                    frame.settings = settings;
+
+                    // preprocess -> edges (and edge pixels)
+                    auto start = std::chrono::high_resolution_clock::now();
+                    detector.prepareFrame(&frame);
+                    stageTimes[0] = millisecondsSince(start);
+
+                    // Hough transformation
+                    std::vector<CircleItem> circles;
+                    auto stageStart = std::chrono::high_resolution_clock::now();
+                    detector.findCircles(frame.edges, &frame.edgePoints, settings, false, &circles);
+                    stageTimes[1] = millisecondsSince(stageStart);
+
+                    stageStart = std::chrono::high_resolution_clock::now();
+                    coin.removeOverlappingCircles(&circles);
+                    stageTimes[2] = millisecondsSince(stageStart);
+
+                    stageStart = std::chrono::high_resolution_clock::now();
+                    detector.segmentation->refineCircles(frame.edges, &circles, cellStep, phiStep, true);
+                    stageTimes[3] = millisecondsSince(stageStart);
+
+                    // classification (the color model is not adapted, every repetition has the same result)
+                    stageStart = std::chrono::high_resolution_clock::now();
+                    CoinClassification coins = coin.classifyAll(frame.input, circles);
+                    stageTimes[4] = millisecondsSince(stageStart);
+                    stageTimes[5] = millisecondsSince(start);
+
+                    if (repetition < 0)
+                        continue;
+                    for (int stage = 0; stage < stageCount; ++stage)
+                        times[stage].push_back(stageTimes[stage]);
+                    if (repetition == benchmark->repetitions - 1)
+                    {
+                        matchCircles(truths[i], circles, coins.values, &accuracy);
+                        edgePixels += frame.edgePoints.count;
+                    }
+                }
+            }
+
+            std::string name = stepName(cellStep, phiStep);
+            for (int stage = 0; stage < stageCount; ++stage)
+            {
+                benchmark->add("Pipeline", std::string(stageNames[stage]) + " " + name, size, 1, pixels,
+                               times[stage]);
+            }
+
+            int matched = std::max(1, accuracy.matched);
+            std::cout << std::left << std::setw(16) << "Accuracy" << std::setw(34) << name << std::setw(11) << size
+                      << std::right << std::fixed << std::setprecision(3) << "recall " << accuracy.recall()
+                      << ", precision " << accuracy.precision() << ", center error " << accuracy.centerError / matched
+                      << " px, radius error " << accuracy.radiusError / matched << " px, classification "
+                      << double(accuracy.classified) / matched << ", edge pixels " << std::setprecision(0)
+                      << edgePixels / std::max(1, sceneCount) << "\n";
+            accuracies->push_back(accuracy);
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// end-to-end benchmark (see PipelineBenchmark.h)
+////////////////////////////////////////////////////////////////////////////////////
+int runPipelineBenchmark(int argc, char *argv[])
+{
+    Benchmark benchmark;
+    benchmark.warmup = 1;
+    benchmark.repetitions = 3;
+    SceneSettings scene;
+    int sceneCount = 5;
+    std::string sizeList = "hd";
+    std::string cellStepList = "1,2";
+    std::string phiStepList = "1,2,4";
+    std::string csvFile, jsonFile, accuracyFile, baselineFile;
+    double tolerance = 0.10;
+    AccumulatorType accumulatorType = AccumulatorType::UInt16;
+
+    // settings of the coin detection (like the interactive program after the calibration)
+    CoinSettings settings;
+    settings.edgeThreshold = 100;
+    settings.blurKernelSize = 5;
+    settings.blurSigma = 1.0;
+    settings.maxCountPerRadius = 20;
+    settings.enableHough = true;
+    settings.calibrated = true;
+
+    // (argv[1] is "--pipeline")
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--sizes" && i + 1 < argc)
+            sizeList = argv[++i];
+        else if (argument == "--scenes" && i + 1 < argc)
+            sceneCount = std::max(1, std::atoi(argv[++i]));
+        else if (argument == "--coins" && i + 1 < argc)
+            scene.coinCount = std::max(0, std::atoi(argv[++i]));
+        else if (argument == "--occlusion" && i + 1 < argc)
+            scene.occlusion = std::atof(argv[++i]);
+        else if (argument == "--noise" && i + 1 < argc)
+            scene.noiseSigma = std::atof(argv[++i]);
+        else if (argument == "--pixels-per-mm" && i + 1 < argc)
+            scene.pixelsPerMm = std::atof(argv[++i]);
+        else if (argument == "--seed" && i + 1 < argc)
+            scene.seed = unsigned(std::atoi(argv[++i]));
+        else if (argument == "--cell-steps" && i + 1 < argc)
+            cellStepList = argv[++i];
+        else if (argument == "--phi-steps" && i + 1 < argc)
+            phiStepList = argv[++i];
+        else if (argument == "--pyramid" && i + 1 < argc)
+            settings.pyramidLevels = std::max(0, std::atoi(argv[++i]));
+        else if (argument == "--canny" && i + 1 < argc)
+        {
+            // Canny edge detector with the thresholds low,high (instead of threshold -> erode -> subtract)
+            std::vector<std::string> thresholds = splitList(argv[++i]);
+            settings.canny = true;
+            if (thresholds.size() == 2)
+            {
+                settings.cannyLow = std::atoi(thresholds[0].c_str());
+                settings.cannyHigh = std::atoi(thresholds[1].c_str());
+            }
+        }
+        else if (argument == "--smoothing" && i + 1 < argc)
+        {
+            // edge-preserving filter instead of the Gaussian (median or bilateral)
+            std::string smoothing = argv[++i];
+            if (smoothing == "median")
+                settings.smoothing = Smoothing::Median;
+            else if (smoothing == "bilateral")
+                settings.smoothing = Smoothing::Bilateral;
+        }
+        else if (argument == "--accumulator" && i + 1 < argc)
+        {
+            // cell type of the Hough accumulators: 32, 16, 8 or sparse
+            std::string type = argv[++i];
+            accumulatorType = type == "32" ? AccumulatorType::Int32 : type == "8" ? AccumulatorType::UInt8 :
+                              type == "sparse" ? AccumulatorType::Sparse : AccumulatorType::UInt16;
+        }
+        else if (argument == "--serial")
+            settings.useThreads = false;
+        else if (argument == "--warmup" && i + 1 < argc)
+            benchmark.warmup = std::max(0, std::atoi(argv[++i]));
+        else if (argument == "--repetitions" && i + 1 < argc)
+            benchmark.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (argument == "--csv" && i + 1 < argc)
+            csvFile = argv[++i];
+        else if (argument == "--json" && i + 1 < argc)
+            jsonFile = argv[++i];
+        else if (argument == "--accuracy" && i + 1 < argc)
+            accuracyFile = argv[++i];
+        else if (argument == "--compare" && i + 1 < argc)
+            baselineFile = argv[++i];
+        else if (argument == "--tolerance" && i + 1 < argc)
+            tolerance = std::atof(argv[++i]);
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " --pipeline [--sizes hd,<w>x<h>] [--scenes <n>] [--coins <n>]"
+                      << " [--occlusion <0..1>] [--noise <sigma>] [--pixels-per-mm <f>] [--seed <n>]"
+                      << " [--cell-steps 1,2] [--phi-steps 1,2,4] [--pyramid <levels>] [--canny <low>,<high>]"
+                      << " [--smoothing gaussian|median|bilateral] [--accumulator 32|16|8|sparse] [--serial]"
+                      << " [--warmup <n>] [--repetitions <n>] [--csv <file>] [--json <file>] [--accuracy <file>]"
+                      << " [--compare <baseline.csv>] [--tolerance <0.10>]\n";
+            return 2;
+        }
+    }
+
+    Filter filter;
+    filter.setGaussianKernels1D(settings.blurKernelHorizontal, settings.blurKernelVertical, settings.blurKernelSize,
+                                settings.blurSigma);
+
+    std::vector<float> cellSteps, phiSteps;
+    for (const auto &item : splitList(cellStepList))
+        cellSteps.push_back(std::max(0.1f, float(std::atof(item.c_str()))));
+    for (const auto &item : splitList(phiStepList))
+        phiSteps.push_back(std::max(0.1f, float(std::atof(item.c_str()))));
+
+    std::vector<PipelineAccuracy> accuracies;
+    for (const auto &name : splitList(sizeList))
+    {
+        if (!parseSize(name, &scene.size))
+        {
+            std::cout << "Pipeline: unknown image size '" << name << "'\n";
+            return 2;
+        }
+        if (!runScenes(&benchmark, scene, sceneCount, settings, cellSteps, phiSteps, accumulatorType, &accuracies))
+            return 2;
+    }
+
+    if (!csvFile.empty())
+        benchmark.writeCsv(csvFile);
+    if (!jsonFile.empty())
+        benchmark.writeJson(jsonFile);
+    if (!accuracyFile.empty())
+        writeAccuracy(accuracyFile, accuracies);
+
+    if (!baselineFile.empty())
+    {
+        int regressions = benchmark.compare(baselineFile, tolerance);
+        if (regressions != 0)
+            return 1;
+    }
+    return 0;
+}
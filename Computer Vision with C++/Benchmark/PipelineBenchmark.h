@@ -0,0 +1,14 @@
+#ifndef PIPELINEBENCHMARK_H
+#define PIPELINEBENCHMARK_H
+
+// end-to-end benchmark of the coin detection on synthetic scenes (SceneGenerator):
+// latency of every stage and accuracy against the ground truth for a grid of
+// cellStep / phiStep values
+//
+// usage: --pipeline [--sizes hd,<w>x<h>] [--scenes <n>] [--coins <n>] [--occlusion <0..1>] [--noise <sigma>]
+//        [--pixels-per-mm <f>] [--cell-steps 1,2] [--phi-steps 1,2,4] [--pyramid <levels>] [--serial]
+//        [--warmup <n>] [--repetitions <n>] [--csv <file>] [--json <file>] [--accuracy <file>]
+//        [--compare <baseline.csv>] [--tolerance <0.10>]
+int runPipelineBenchmark(int argc, char *argv[]);
+
+#endif /* PIPELINEBENCHMARK_H */
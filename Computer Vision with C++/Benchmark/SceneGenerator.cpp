@@ -0,0 +1,258 @@
+#include <cmath>
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "SceneGenerator.h"
+
+
+SceneGenerator::SceneGenerator()
+{}
+
+SceneGenerator::~SceneGenerator()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////
+// random scene: background -> coins -> noise
+//
+// note: every random value comes from one cv::RNG (seeded with settings.seed),
+//       so a scene depends only on the settings
+////////////////////////////////////////////////////////////////////////////////////
+void SceneGenerator::generate(const SceneSettings &settings, cv::Mat &image, std::vector<SceneCoin> *coins)
+{
+    cv::RNG rng(settings.seed);
+    coins->clear();
+
+    const CoinDefinition *definitions = settings.coins.empty() ? euroCoins : settings.coins.data();
+    int definitionCount = settings.coins.empty() ? euroCoinCount : int(settings.coins.size());
+
+    drawBackground(settings, rng, image);
+
+    // place the coins (rejected if they cover earlier coins too much)
+    std::vector<double> covered; // covered part of the placed coins
+    for (int i = 0; i < settings.coinCount; ++i)
+    {
+        for (int attempt = 0; attempt < 200; ++attempt)
+        {
+            const CoinDefinition &definition = definitions[rng.uniform(0, definitionCount)];
+            SceneCoin coin;
+            coin.radius = float(settings.pixelsPerMm * definition.diameter / 2.0 *
+                                (1.0 + settings.radiusJitter * rng.uniform(-1.0, 1.0)));
+            coin.value = definition.value;
+            coin.colorRing = definition.colorRing;
+            coin.colorCore = definition.colorCore;
+            coin.visible = 1.0f;
+
+            // completely inside of the image (with 2 px for the edge detection)
+            float border = coin.radius + 2.0f;
+            if (2.0f * border >= settings.size.width || 2.0f * border >= settings.size.height)
+                break;
+            coin.center.x = rng.uniform(border, float(settings.size.width) - border);
+            coin.center.y = rng.uniform(border, float(settings.size.height) - border);
+
+            // no overlap: keep a gap, so the edges of neighbouring coins do not touch
+            bool accepted = true;
+            std::vector<double> newCovered = covered;
+            for (size_t j = 0; j < coins->size() && accepted; ++j)
+            {
+                const SceneCoin &other = coins->at(j);
+                float dx = coin.center.x - other.center.x;
+                float dy = coin.center.y - other.center.y;
+                float distance = std::sqrt(dx * dx + dy * dy);
+                if (distance >= coin.radius + other.radius + 4.0f)
+                    continue;
+
+                newCovered[j] += overlapArea(coin, other) / (CV_PI * other.radius * other.radius);
+                accepted = settings.occlusion > 0.0 && newCovered[j] <= settings.occlusion;
+            }
+            if (!accepted)
+                continue;
+
+            covered = newCovered;
+            covered.push_back(0.0);
+            coins->push_back(coin);
+            break;
+        }
+    }
+
+    // later coins are drawn on top of earlier ones
+    labels.create(settings.size, CV_16U);
+    labels.setTo(cv::Scalar(0));
+    std::vector<int> drawn(coins->size());
+    for (size_t i = 0; i < coins->size(); ++i)
+    {
+        drawn[i] = drawCoin(settings, coins->at(i), image, labels, ushort(i + 1));
+    }
+    countVisible(labels, drawn, coins);
+
+    addNoise(settings, rng, image);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// one coin of the given value in the center of the image
+////////////////////////////////////////////////////////////////////////////////////
+void SceneGenerator::generateSingle(const SceneSettings &settings, const double value, cv::Mat &image,
+                                    std::vector<SceneCoin> *coins)
+{
+    cv::RNG rng(settings.seed);
+    coins->clear();
+
+    const CoinDefinition *definitions = settings.coins.empty() ? euroCoins : settings.coins.data();
+    int definitionCount = settings.coins.empty() ? euroCoinCount : int(settings.coins.size());
+    const CoinDefinition *definition = &definitions[0];
+    for (int i = 0; i < definitionCount; ++i)
+    {
+        if (definitions[i].value == value)
+            definition = &definitions[i];
+    }
+
+    drawBackground(settings, rng, image);
+
+    SceneCoin coin;
+    coin.center = cv::Point2f(settings.size.width / 2.0f, settings.size.height / 2.0f);
+    coin.radius = float(settings.pixelsPerMm * definition->diameter / 2.0);
+    coin.value = definition->value;
+    coin.colorRing = definition->colorRing;
+    coin.colorCore = definition->colorCore;
+    coin.visible = 1.0f;
+    coins->push_back(coin);
+
+    labels.create(settings.size, CV_16U);
+    labels.setTo(cv::Scalar(0));
+    drawCoin(settings, coin, image, labels, 1);
+
+    addNoise(settings, rng, image);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// textured background: random values on a coarse grid, interpolated to the image size
+// (structures of about textureScale px, like wood or fabric out of focus)
+////////////////////////////////////////////////////////////////////////////////////
+void SceneGenerator::drawBackground(const SceneSettings &settings, cv::RNG &rng, cv::Mat &image)
+{
+    int scale = std::max(1, settings.textureScale);
+    cv::Mat coarse(settings.size.height / scale + 2, settings.size.width / scale + 2, CV_32F);
+    rng.fill(coarse, cv::RNG::UNIFORM, cv::Scalar(-1.0), cv::Scalar(1.0));
+    cv::resize(coarse, texture, settings.size, 0, 0, cv::INTER_LINEAR);
+
+    image.create(settings.size, CV_8UC3);
+    for (int r = 0; r < image.rows; ++r)
+    {
+        const float *pTexture = texture.ptr<float>(r);
+        uchar *pImage = image.ptr<uchar>(r);
+        for (int c = 0; c < image.cols; ++c)
+        {
+            float gray = float(settings.backgroundGray + settings.textureStrength * pTexture[c]);
+            // slightly brownish (table)
+            *pImage++ = cv::saturate_cast<uchar>(gray * 0.9f);
+            *pImage++ = cv::saturate_cast<uchar>(gray);
+            *pImage++ = cv::saturate_cast<uchar>(gray * 1.1f);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// draw a coin (ring and core, darker at the rim) and mark its pixels in the label image
+// returns the number of drawn pixels
+////////////////////////////////////////////////////////////////////////////////////
+int SceneGenerator::drawCoin(const SceneSettings &settings, const SceneCoin &coin, cv::Mat &image, cv::Mat &labels,
+                             const ushort label)
+{
+    const cv::Scalar &ring = settings.colors[int(coin.colorRing)];
+    const cv::Scalar &core = settings.colors[int(coin.colorCore)];
+    float radiusSquared = coin.radius * coin.radius;
+    float coreSquared = float(settings.coreRatio * settings.coreRatio) * radiusSquared;
+
+    int r0 = std::max(0, int(std::floor(coin.center.y - coin.radius)));
+    int r1 = std::min(image.rows - 1, int(std::ceil(coin.center.y + coin.radius)));
+    int c0 = std::max(0, int(std::floor(coin.center.x - coin.radius)));
+    int c1 = std::min(image.cols - 1, int(std::ceil(coin.center.x + coin.radius)));
+
+    int drawn = 0;
+    for (int r = r0; r <= r1; ++r)
+    {
+        uchar *pImage = image.ptr<uchar>(r) + 3 * c0;
+        ushort *pLabel = labels.ptr<ushort>(r) + c0;
+        float dy = float(r) - coin.center.y;
+        for (int c = c0; c <= c1; ++c, pImage += 3, ++pLabel)
+        {
+            float dx = float(c) - coin.center.x;
+            float distanceSquared = dx * dx + dy * dy;
+            if (distanceSquared > radiusSquared)
+                continue;
+
+            const cv::Scalar &color = distanceSquared <= coreSquared ? core : ring;
+            float light = float(1.0 - settings.shading * distanceSquared / radiusSquared);
+            pImage[0] = cv::saturate_cast<uchar>(color[0] * light);
+            pImage[1] = cv::saturate_cast<uchar>(color[1] * light);
+            pImage[2] = cv::saturate_cast<uchar>(color[2] * light);
+            *pLabel = label;
+            ++drawn;
+        }
+    }
+    return drawn;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// gaussian noise (camera)
+////////////////////////////////////////////////////////////////////////////////////
+void SceneGenerator::addNoise(const SceneSettings &settings, cv::RNG &rng, cv::Mat &image)
+{
+    if (settings.noiseSigma <= 0.0)
+        return;
+
+    noise.create(image.rows, image.cols * 3, CV_32F);
+    rng.fill(noise, cv::RNG::NORMAL, cv::Scalar(0.0), cv::Scalar(settings.noiseSigma));
+    for (int r = 0; r < image.rows; ++r)
+    {
+        const float *pNoise = noise.ptr<float>(r);
+        uchar *pImage = image.ptr<uchar>(r);
+        for (int c = 0; c < image.cols * 3; ++c)
+        {
+            pImage[c] = cv::saturate_cast<uchar>(pImage[c] + pNoise[c]);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// visible part of every coin: pixels with its label / drawn pixels
+////////////////////////////////////////////////////////////////////////////////////
+void SceneGenerator::countVisible(const cv::Mat &labels, const std::vector<int> &drawn, std::vector<SceneCoin> *coins)
+{
+    std::vector<int> count(coins->size() + 1, 0);
+    for (int r = 0; r < labels.rows; ++r)
+    {
+        const ushort *pLabel = labels.ptr<ushort>(r);
+        for (int c = 0; c < labels.cols; ++c)
+        {
+            ++count[pLabel[c]];
+        }
+    }
+    for (size_t i = 0; i < coins->size(); ++i)
+    {
+        coins->at(i).visible = drawn[i] > 0 ? float(count[i + 1]) / float(drawn[i]) : 0.0f;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// area of the intersection of two circles
+////////////////////////////////////////////////////////////////////////////////////
+double SceneGenerator::overlapArea(const SceneCoin &a, const SceneCoin &b)
+{
+    double dx = a.center.x - b.center.x;
+    double dy = a.center.y - b.center.y;
+    double d = std::sqrt(dx * dx + dy * dy);
+    double r1 = a.radius;
+    double r2 = b.radius;
+    if (d >= r1 + r2)
+        return 0.0;
+    if (d <= std::abs(r1 - r2))
+    {
+        double r = std::min(r1, r2);
+        return CV_PI * r * r; // one circle inside of the other
+    }
+
+    double angle1 = std::acos((d * d + r1 * r1 - r2 * r2) / (2.0 * d * r1));
+    double angle2 = std::acos((d * d + r2 * r2 - r1 * r1) / (2.0 * d * r2));
+    return r1 * r1 * (angle1 - std::sin(2.0 * angle1) / 2.0) + r2 * r2 * (angle2 - std::sin(2.0 * angle2) / 2.0);
+}
@@ -0,0 +1,78 @@
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+#include "../Coin Detection/Coin.h"
+
+// parameters of a synthetic scene (the same parameters and seed give the same image)
+struct SceneSettings
+{
+    cv::Size size = cv::Size(1280, 720);
+    int coinCount = 12;
+    double pixelsPerMm = 2.2; // radius of a coin = pixelsPerMm * diameter / 2
+    double radiusJitter = 0.0; // random change of the radius (fraction, e.g. 0.02 = +-2%)
+
+    // coins which are placed (random choice, default: Euro coins)
+    std::vector<CoinDefinition> coins;
+
+    // colors (BGR) of the coin materials, index: CoinColor (bronze, silver, gold)
+    cv::Scalar colors[3] = { cv::Scalar(40, 134, 216), cv::Scalar(170, 170, 165), cv::Scalar(40, 150, 200) };
+    double coreRatio = 0.70; // radius of the core / radius of the coin (bi-color coins)
+    double shading = 0.15;   // coins are darker at the rim (fraction of the color)
+
+    // background
+    double backgroundGray = 50.0;
+    double textureStrength = 20.0; // amplitude of the texture (gray values)
+    int textureScale = 24;         // size of the texture structures (px)
+
+    // max. covered part of a coin (0: coins do not overlap)
+    double occlusion = 0.0;
+
+    // gaussian noise (standard deviation, gray values)
+    double noiseSigma = 6.0;
+
+    unsigned int seed = 1;
+};
+
+// ground truth of a coin in a synthetic scene
+struct SceneCoin
+{
+    cv::Point2f center;
+    float radius;
+    double value;
+    CoinColor colorRing;
+    CoinColor colorCore;
+    float visible; // visible part of the coin (1: not covered by other coins)
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// deterministic synthetic coin scenes (BGR) with ground truth
+////////////////////////////////////////////////////////////////////////////////////
+class SceneGenerator
+{
+public:
+    SceneGenerator();
+    ~SceneGenerator();
+
+    // random scene: coins are placed completely inside of the image
+    // (later coins are drawn on top of earlier ones)
+    void generate(const SceneSettings &settings, cv::Mat &image, std::vector<SceneCoin> *coins);
+
+    // scene with one coin of the given value in the center (e.g. for the calibration)
+    void generateSingle(const SceneSettings &settings, const double value, cv::Mat &image,
+                        std::vector<SceneCoin> *coins);
+
+private:
+    void drawBackground(const SceneSettings &settings, cv::RNG &rng, cv::Mat &image);
+    static int drawCoin(const SceneSettings &settings, const SceneCoin &coin, cv::Mat &image, cv::Mat &labels,
+                        const ushort label);
+    void addNoise(const SceneSettings &settings, cv::RNG &rng, cv::Mat &image);
+    static void countVisible(const cv::Mat &labels, const std::vector<int> &drawn, std::vector<SceneCoin> *coins);
+    static double overlapArea(const SceneCoin &a, const SceneCoin &b);
+
+    cv::Mat texture, noise, labels; // buffers (reused for scenes of the same size)
+};
+
+#endif /* SCENEGENERATOR_H */
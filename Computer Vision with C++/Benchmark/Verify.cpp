@@ -0,0 +1,810 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "Verify.h"
+#include "Benchmark.h"
+#include "SceneGenerator.h"
+#include "../Core/CpuDispatch.h"
+#include "../Core/Threshold.h"
+#include "../Core/EdgePoints.h"
+#include "../Core/Gradient.h"
+#include "../Core/IntegralImage.h"
+#include "../Core/Filter.h"
+#include "../Core/Canny.h"
+#include "../Core/Segmentation.h"
+#include "../Core/HoughAccumulator.h"
+#include "../Coin Detection/CoinDetector.h"
+
+////////////////////////////////////////////////////////////////////////////////////
+// number of checks and failed checks
+////////////////////////////////////////////////////////////////////////////////////
+struct Verification
+{
+    int checks = 0;
+    int failures = 0;
+
+    // digests of the outputs of the SIMD kernels: "<name> <size>" -> digest (see --save, --against)
+    std::map<std::string, uint64_t> digests;
+
+    // differences: number of values which are not equal (0: passed)
+    void report(const std::string &name, const std::string &size, const long differences)
+    {
+        std::ostringstream reason;
+        if (differences != 0)
+            reason << differences << " differences";
+        result(name, size, reason.str());
+    }
+
+    // reason: why the check failed (empty: passed)
+    void result(const std::string &name, const std::string &size, const std::string &reason)
+    {
+        ++checks;
+        if (!reason.empty())
+            ++failures;
+        std::cout << std::left << std::setw(66) << name << std::setw(11) << size
+                  << (reason.empty() ? "ok" : "FAILED") << std::right;
+        if (!reason.empty())
+            std::cout << " (" << reason << ")";
+        std::cout << "\n";
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// comparison of outputs
+////////////////////////////////////////////////////////////////////////////////////
+// pixels which differ in any byte (size or type differ: all pixels)
+static long countDifferences(const cv::Mat &a, const cv::Mat &b)
+{
+    if (a.size() != b.size() || a.type() != b.type())
+        return std::max<long>(1, long(std::max(a.total(), b.total())));
+
+    long differences = 0;
+    size_t pixelBytes = a.elemSize();
+    for (int r = 0; r < a.rows; ++r)
+    {
+        const uchar *pA = a.ptr<uchar>(r);
+        const uchar *pB = b.ptr<uchar>(r);
+        for (int c = 0; c < a.cols; ++c, pA += pixelBytes, pB += pixelBytes)
+        {
+            if (std::memcmp(pA, pB, pixelBytes) != 0)
+                ++differences;
+        }
+    }
+    return differences;
+}
+
+// images of a region: also the position
+static long countDifferences(const RoiImage &a, const RoiImage &b)
+{
+    if (a.origin != b.origin)
+        return std::max<long>(1, long(std::max(a.mat.total(), b.mat.total())));
+    return countDifferences(a.mat, b.mat);
+}
+
+// edge pixels in the same order
+static long countDifferences(const EdgePoints &a, const EdgePoints &b)
+{
+    if (a.count != b.count || a.size != b.size || a.origin != b.origin)
+        return std::max(1, std::abs(a.count - b.count));
+
+    long differences = 0;
+    for (int i = 0; i < a.count; ++i)
+    {
+        if (a.x[i] != b.x[i] || a.y[i] != b.y[i])
+            ++differences;
+    }
+    return differences;
+}
+
+// circles in the same order with the same values
+static long countDifferences(const std::vector<CircleItem> &a, const std::vector<CircleItem> &b)
+{
+    long differences = long(std::max(a.size(), b.size()) - std::min(a.size(), b.size()));
+    for (size_t i = 0; i < std::min(a.size(), b.size()); ++i)
+    {
+        if (a[i].x != b[i].x || a[i].y != b[i].y || a[i].r != b[i].r || a[i].v != b[i].v ||
+            a[i].xf != b[i].xf || a[i].yf != b[i].yf || a[i].rf != b[i].rf)
+            ++differences;
+    }
+    return differences;
+}
+
+// cells with a different number of votes
+static long countDifferences(const HoughAccumulator &a, const HoughAccumulator &b)
+{
+    if (a.rows != b.rows || a.cols != b.cols)
+        return std::max<long>(1, std::max(long(a.rows) * a.cols, long(b.rows) * b.cols));
+
+    long differences = 0;
+    for (int r = 0; r < a.rows; ++r)
+    {
+        for (int c = 0; c < a.cols; ++c)
+        {
+            if (a.value(r, c) != b.value(r, c))
+                ++differences;
+        }
+    }
+    return differences;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// digests of outputs (FNV-1a, 64 bit): the SIMD kernels are selected once per process,
+// so the outputs of different instruction sets are compared by their digests in
+// separate runs (CORE_CPU=scalar ... --save, then ... --against)
+////////////////////////////////////////////////////////////////////////////////////
+static uint64_t fnv1a(const void *data, const size_t bytes, uint64_t hash = 14695981039346656037ULL)
+{
+    const uchar *pData = static_cast<const uchar *>(data);
+    for (size_t i = 0; i < bytes; ++i)
+    {
+        hash ^= pData[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// size, type and the pixels (not the padding of a view)
+static uint64_t digestOf(const cv::Mat &image)
+{
+    int header[3] = { image.rows, image.cols, image.type() };
+    uint64_t hash = fnv1a(header, sizeof(header));
+    for (int r = 0; r < image.rows; ++r)
+        hash = fnv1a(image.ptr<uchar>(r), image.cols * image.elemSize(), hash);
+    return hash;
+}
+
+static uint64_t digestOf(const EdgePoints &points)
+{
+    int header[5] = { points.count, points.size.width, points.size.height, points.origin.x, points.origin.y };
+    uint64_t hash = fnv1a(header, sizeof(header));
+    hash = fnv1a(points.x.data(), points.count * sizeof(short), hash);
+    return fnv1a(points.y.data(), points.count * sizeof(short), hash);
+}
+
+static void recordDigest(Verification *verification, const std::string &name, const std::string &size,
+                         const uint64_t digest)
+{
+    verification->digests[name + " " + size] = digest;
+}
+
+// digests of a file of --save (a run with other kernels)
+static bool loadDigests(const std::string &filename, std::map<std::string, uint64_t> *digests)
+{
+    std::ifstream file(filename.c_str());
+    if (!file)
+    {
+        std::cout << "Verify: cannot read '" << filename << "'\n";
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        std::string name, size, digest;
+        if (fields >> name >> size >> digest)
+            (*digests)[name + " " + size] = std::strtoull(digest.c_str(), nullptr, 16);
+    }
+    return true;
+}
+
+// compare the digests of this run with those of the other run
+static void compareDigests(Verification *verification, const std::map<std::string, uint64_t> &reference,
+                           const std::string &filename)
+{
+    for (const auto &entry : verification->digests)
+    {
+        size_t split = entry.first.rfind(' ');
+        std::string name = "digest/" + entry.first.substr(0, split);
+        std::string size = entry.first.substr(split + 1);
+
+        auto found = reference.find(entry.first);
+        if (found == reference.end())
+            verification->result(name, size, "not in " + filename);
+        else if (found->second != entry.second)
+            verification->result(name, size, "differs from " + filename);
+        else
+            verification->result(name, size, "");
+    }
+}
+
+static bool saveDigests(const Verification &verification, const std::string &filename)
+{
+    std::ofstream file(filename.c_str());
+    if (!file)
+    {
+        std::cout << "Verify: cannot write '" << filename << "'\n";
+        return false;
+    }
+    file << "# output digests, CPU kernels: " << cpuLevelName(cpuLevel()) << "\n";
+    for (const auto &entry : verification.digests)
+        file << entry.first << " " << std::hex << std::setw(16) << std::setfill('0') << entry.second
+             << std::dec << std::setfill(' ') << "\n";
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Threshold and EdgePoints: the SIMD row kernels against the plain loops
+// (the views start and end inside of the SIMD blocks)
+////////////////////////////////////////////////////////////////////////////////////
+static void verifyRowKernels(Verification *verification, const cv::Mat &gray, const std::string &size)
+{
+    Threshold threshold;
+    const cv::Rect views[] = { cv::Rect(0, 0, gray.cols, gray.rows),
+                               cv::Rect(gray.cols / 5 + 1, gray.rows / 7, gray.cols / 2 + 3, gray.rows / 2 + 5) };
+    const char *viewNames[] = { "image", "view" };
+
+    for (int v = 0; v < 2; ++v)
+    {
+        cv::Mat input = gray(views[v]);
+        for (int value : { 0, 1, 97, 128, 255 })
+        {
+            cv::Mat simd, reference;
+            threshold.loop_ptr2(input, simd, uchar(value));
+            threshold.loop(input, reference, uchar(value));
+
+            std::ostringstream name;
+            name << "Threshold/loop_ptr2_" << value << "_" << viewNames[v];
+            verification->report(name.str(), size, countDifferences(simd, reference));
+            recordDigest(verification, name.str(), size, digestOf(simd));
+
+            // edge pixels of the threshold image: compacted rows against a scan of all pixels
+            EdgePoints points, scan;
+            EdgePoints::fromImage(simd, &points, views[v].tl());
+            scan.reset(simd.size(), views[v].tl());
+            for (int r = 0; r < simd.rows; ++r)
+            {
+                for (int c = 0; c < simd.cols; ++c)
+                {
+                    if (simd.at<uchar>(r, c) != 0)
+                    {
+                        scan.x.push_back(short(c));
+                        scan.y.push_back(short(r));
+                        ++scan.count;
+                    }
+                }
+            }
+            std::ostringstream pointsName;
+            pointsName << "EdgePoints/fromImage_" << value << "_" << viewNames[v];
+            verification->report(pointsName.str(), size, countDifferences(points, scan));
+            recordDigest(verification, pointsName.str(), size, digestOf(points));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Gradient::sobel: the SIMD rows against the formulas of the magnitude and Gradient::binOf
+// (gray image and its threshold image: the largest gradients)
+////////////////////////////////////////////////////////////////////////////////////
+static void sobelReference(const cv::Mat &input, cv::Mat &magnitude, cv::Mat &orientation, const GradientNorm norm,
+                           const int orientationBins)
+{
+    magnitude = cv::Mat::zeros(input.size(), CV_8U);
+    orientation = cv::Mat::zeros(input.size(), CV_8U);
+    for (int r = 1; r < input.rows - 1; ++r)
+    {
+        for (int c = 1; c < input.cols - 1; ++c)
+        {
+            int gx = input.at<uchar>(r - 1, c + 1) - input.at<uchar>(r - 1, c - 1) +
+                     2 * (input.at<uchar>(r, c + 1) - input.at<uchar>(r, c - 1)) +
+                     input.at<uchar>(r + 1, c + 1) - input.at<uchar>(r + 1, c - 1);
+            int gy = input.at<uchar>(r + 1, c - 1) + 2 * input.at<uchar>(r + 1, c) + input.at<uchar>(r + 1, c + 1) -
+                     input.at<uchar>(r - 1, c - 1) - 2 * input.at<uchar>(r - 1, c) - input.at<uchar>(r - 1, c + 1);
+            int ax = std::abs(gx);
+            int ay = std::abs(gy);
+
+            // norm / 8, rounded (see Gradient.h)
+            int value;
+            if (norm == GradientNorm::L1)
+                value = (ax + ay + 4) >> 3;
+            else if (norm == GradientNorm::FastL2)
+                value = (8 * std::max(ax, ay) + 3 * std::min(ax, ay) + 32) >> 6;
+            else
+                value = int(std::lrint(std::sqrt(float(gx * gx + gy * gy)) * 0.125f));
+            magnitude.at<uchar>(r, c) = uchar(value);
+            orientation.at<uchar>(r, c) = uchar(Gradient::binOf(gx, gy, orientationBins));
+        }
+    }
+}
+
+static void verifyGradient(Verification *verification, const cv::Mat &gray, const std::string &size)
+{
+    Gradient gradient;
+    Threshold threshold;
+    cv::Mat binary;
+    threshold.loop(gray, binary, 128);
+
+    const cv::Mat inputs[] = { gray, binary,
+                               gray(cv::Rect(gray.cols / 5 + 1, gray.rows / 7, gray.cols / 2 + 3, gray.rows / 2 + 5)) };
+    const char *inputNames[] = { "gray", "binary", "view" };
+    const GradientNorm norms[] = { GradientNorm::L1, GradientNorm::L2, GradientNorm::FastL2 };
+    const char *normNames[] = { "L1", "L2", "FastL2" };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int n = 0; n < 3; ++n)
+        {
+            for (int bins : { 4, 8 })
+            {
+                cv::Mat magnitude, orientation, magnitudeReference, orientationReference;
+                gradient.sobel(inputs[i], magnitude, &orientation, norms[n], bins);
+                sobelReference(inputs[i], magnitudeReference, orientationReference, norms[n], bins);
+
+                std::ostringstream name;
+                name << "Gradient/sobel_" << normNames[n] << "_orientation" << bins << "_" << inputNames[i];
+                verification->report(name.str() + " magnitude", size,
+                                     countDifferences(magnitude, magnitudeReference));
+                verification->report(name.str() + " orientation", size,
+                                     countDifferences(orientation, orientationReference));
+                recordDigest(verification, name.str() + "_magnitude", size, digestOf(magnitude));
+                recordDigest(verification, name.str() + "_orientation", size, digestOf(orientation));
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Canny: the bands of the threads (stitched at their borders) give the edges of one band,
+// the edge points are the pixels of the edge image with the same directions
+////////////////////////////////////////////////////////////////////////////////////
+static void verifyCanny(Verification *verification, const cv::Mat &gray, const std::string &size)
+{
+    Canny canny;
+    const GradientNorm norms[] = { GradientNorm::L1, GradientNorm::L2 };
+    const char *normNames[] = { "L1", "L2" };
+
+    for (int n = 0; n < 2; ++n)
+    {
+        cv::Mat edges;
+        EdgePoints points, scan;
+        canny.detect(gray, edges, 40, 100, &points, 1, norms[n]);
+        EdgePoints::fromImage(edges, &scan);
+
+        std::string name = std::string("Canny/detect_") + normNames[n];
+        verification->report(name + " points", size, countDifferences(points, scan));
+        recordDigest(verification, name + "_edges", size, digestOf(edges));
+        recordDigest(verification, name + "_points", size, digestOf(points));
+
+        for (int threads : { 3, 8 })
+        {
+            cv::Mat bandEdges;
+            EdgePoints bandPoints;
+            canny.detect(gray, bandEdges, 40, 100, &bandPoints, threads, norms[n]);
+
+            long directions = points.hasDirection() == bandPoints.hasDirection() ? 0 : std::max(1, points.count);
+            for (int i = 0; directions == 0 && i < std::min(points.count, bandPoints.count); ++i)
+            {
+                if (points.direction[i] != bandPoints.direction[i])
+                    ++directions;
+            }
+
+            std::ostringstream threadName;
+            threadName << name << " threads" << threads;
+            verification->report(threadName.str() + " edges", size, countDifferences(bandEdges, edges));
+            verification->report(threadName.str() + " points", size, countDifferences(bandPoints, points));
+            verification->report(threadName.str() + " directions", size, directions);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// IntegralImage: the SIMD prefix sums against sums of 64 bit integers (exact for CV_8U),
+// the window means and variances against the sums of each window, threads 1 and 4
+////////////////////////////////////////////////////////////////////////////////////
+static void verifyIntegralImage(Verification *verification, const cv::Mat &gray, const std::string &size)
+{
+    // exact integral of the pixels and of their squares
+    cv::Mat sums(gray.rows + 1, gray.cols + 1, CV_64F, cv::Scalar(0));
+    cv::Mat squares(gray.rows + 1, gray.cols + 1, CV_64F, cv::Scalar(0));
+    for (int r = 0; r < gray.rows; ++r)
+    {
+        int64_t rowSum = 0, rowSquares = 0;
+        for (int c = 0; c < gray.cols; ++c)
+        {
+            int value = gray.at<uchar>(r, c);
+            rowSum += value;
+            rowSquares += value * value;
+            sums.at<double>(r + 1, c + 1) = sums.at<double>(r, c + 1) + double(rowSum);
+            squares.at<double>(r + 1, c + 1) = squares.at<double>(r, c + 1) + double(rowSquares);
+        }
+    }
+
+    const cv::Size windows[] = { cv::Size(5, 5), cv::Size(31, 31), cv::Size(4, 7) };
+    for (int threads : { 1, 4 })
+    {
+        IntegralImage integral;
+        integral.compute(gray, true, threads);
+
+        std::ostringstream name;
+        name << "IntegralImage/threads" << threads;
+        verification->report(name.str() + " sums", size, countDifferences(integral.sums, sums));
+        verification->report(name.str() + " squares", size, countDifferences(integral.squares, squares));
+        recordDigest(verification, name.str() + "_sums", size, digestOf(integral.sums));
+        recordDigest(verification, name.str() + "_squares", size, digestOf(integral.squares));
+
+        for (const cv::Size &window : windows)
+        {
+            cv::Mat mean, variance, box;
+            integral.meanVariance(gray, mean, variance, window, threads);
+            integral.boxFilter(gray, box, window, threads);
+
+            // the same arithmetic as IntegralImage (see windowMeans) on the exact sums
+            Border border = integral.getBorder(window);
+            cv::Rect valid = border.valid(gray.size());
+            cv::Mat meanReference = cv::Mat::zeros(gray.size(), CV_32F);
+            cv::Mat varianceReference = cv::Mat::zeros(gray.size(), CV_32F);
+            double scale = 1.0 / window.area();
+            for (int r = valid.y; r < valid.y + valid.height; ++r)
+            {
+                int y0 = r - border.top;
+                int y1 = y0 + window.height;
+                for (int c = valid.x; c < valid.x + valid.width; ++c)
+                {
+                    int x0 = c - border.left;
+                    int x1 = x0 + window.width;
+                    double meanValue = (sums.at<double>(y1, x1) - sums.at<double>(y1, x0) -
+                                        sums.at<double>(y0, x1) + sums.at<double>(y0, x0)) * scale;
+                    double meanOfSquares = (squares.at<double>(y1, x1) - squares.at<double>(y1, x0) -
+                                            squares.at<double>(y0, x1) + squares.at<double>(y0, x0)) * scale;
+                    meanReference.at<float>(r, c) = float(meanValue);
+                    varianceReference.at<float>(r, c) = float(std::max(0.0, meanOfSquares - meanValue * meanValue));
+                }
+            }
+
+            std::ostringstream windowName;
+            windowName << name.str() << "_" << window.width << "x" << window.height;
+            verification->report(windowName.str() + " mean", size, countDifferences(mean, meanReference));
+            verification->report(windowName.str() + " variance", size, countDifferences(variance, varianceReference));
+            verification->report(windowName.str() + " boxFilter", size, countDifferences(box, meanReference));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Filter::gaussianRecursive: in place and of a view (rows with padding) the same output, the
+// vertical passes (SIMD across the columns) are compared by the digests of the runs
+////////////////////////////////////////////////////////////////////////////////////
+static void verifyRecursiveGaussian(Verification *verification, const cv::Mat &gray, const std::string &size)
+{
+    Filter filter;
+    cv::Mat grayFloat;
+    gray.convertTo(grayFloat, CV_32F);
+    cv::Mat view = grayFloat(cv::Rect(gray.cols / 5 + 1, gray.rows / 7, gray.cols / 2 + 3, gray.rows / 2 + 5));
+
+    for (double sigma : { 1.3, 2.0, 5.0 })
+    {
+        cv::Mat blur, inPlace, viewBlur, viewCopyBlur;
+        filter.gaussianRecursive(grayFloat, blur, sigma);
+        inPlace = grayFloat.clone();
+        filter.gaussianRecursive(inPlace, inPlace, sigma);
+        filter.gaussianRecursive(view, viewBlur, sigma);
+        filter.gaussianRecursive(view.clone(), viewCopyBlur, sigma);
+
+        std::ostringstream name;
+        name << "Filter/gaussianRecursive_" << sigma;
+        verification->report(name.str() + " in place", size, countDifferences(inPlace, blur));
+        verification->report(name.str() + " view", size, countDifferences(viewBlur, viewCopyBlur));
+        recordDigest(verification, name.str(), size, digestOf(blur));
+        recordDigest(verification, name.str() + "_view", size, digestOf(viewBlur));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Filter::median: the column histograms (SIMD updates) against sorting each window, the
+// pixels outside of the image are the edge pixels. bands of threads: the same output
+////////////////////////////////////////////////////////////////////////////////////
+static void medianReference(const cv::Mat &input, cv::Mat &output, const int radius)
+{
+    output.create(input.size(), CV_8U);
+    std::vector<uchar> window;
+    for (int r = 0; r < input.rows; ++r)
+    {
+        for (int c = 0; c < input.cols; ++c)
+        {
+            window.clear();
+            for (int dy = -radius; dy <= radius; ++dy)
+            {
+                const uchar *pRow = input.ptr<uchar>(std::min(std::max(r + dy, 0), input.rows - 1));
+                for (int dx = -radius; dx <= radius; ++dx)
+                    window.push_back(pRow[std::min(std::max(c + dx, 0), input.cols - 1)]);
+            }
+            std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+            output.at<uchar>(r, c) = window[window.size() / 2];
+        }
+    }
+}
+
+static void verifyEdgePreserving(Verification *verification, const cv::Mat &gray, const std::string &size)
+{
+    Filter filter;
+    for (int radius : { 1, 2, 7 })
+    {
+        cv::Mat reference, single, bands;
+        medianReference(gray, reference, radius);
+        filter.median(gray, single, radius, 1);
+        filter.median(gray, bands, radius, 4);
+
+        std::ostringstream name;
+        name << "Filter/median_r" << radius;
+        verification->report(name.str(), size, countDifferences(single, reference));
+        verification->report(name.str() + " threads4", size, countDifferences(bands, reference));
+        recordDigest(verification, name.str(), size, digestOf(single));
+    }
+
+    // bilateral: no SIMD, the bands of the threads must not change the result
+    cv::Mat single, bands;
+    filter.bilateral(gray, single, 2.0, 30.0, 1);
+    filter.bilateral(gray, bands, 2.0, 30.0, 4);
+    verification->report("Filter/bilateral_2 threads4", size, countDifferences(bands, single));
+    recordDigest(verification, "Filter/bilateral_2", size, digestOf(single));
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// HoughAccumulator: the 16 bit, 8 bit (+ side table) and sparse cells have the same votes and
+// give the same maxima and circles as the 32 bit cells, the sparse cells also if the votes are
+// added by 4 threads (one table per thread, merged afterwards). (the edge pixels of Canny, a phi step
+// of 0.5 deg gives more than 255 votes at the centers of the coins: the side table is used)
+////////////////////////////////////////////////////////////////////////////////////
+struct AccumulatorCase
+{
+    const char *name;
+    AccumulatorType type;
+    int threads;
+};
+
+// maxima found one after another (each one is removed before the next is searched)
+// returns the center (image coordinates) and the votes of each maximum: x, y, votes, x, y, ...
+static std::vector<int> removeMaxima(HoughAccumulator &accumulator, const int radius, const float cellStep)
+{
+    std::vector<int> maxima;
+    for (int i = 0; i < 8; ++i)
+    {
+        int value = 0;
+        cv::Point center = Segmentation::findAndRemoveMaximum(accumulator, &value, radius, cellStep);
+        maxima.push_back(center.x);
+        maxima.push_back(center.y);
+        maxima.push_back(value);
+    }
+    return maxima;
+}
+
+// strongest circle searched radius by radius (one 32 bit accumulator per radius)
+static CircleItem strongestCircleReference(const EdgePoints &points, const int radiusMin, const int radiusMax,
+                                           const float cellStep, const float phiStep)
+{
+    CircleItem best;
+    best.x = best.y = best.r = -1;
+    best.v = 0;
+
+    HoughAccumulator accumulator;
+    accumulator.type = AccumulatorType::Int32;
+    for (int radius = radiusMin; radius <= radiusMax; ++radius)
+    {
+        Segmentation::houghCircle(points, accumulator, radius, cellStep, phiStep);
+        int value;
+        cv::Point center = Segmentation::findAndRemoveMaximum(accumulator, &value, radius, cellStep);
+        if (value > best.v)
+        {
+            best.x = center.x;
+            best.y = center.y;
+            best.r = radius;
+            best.v = value;
+        }
+    }
+
+    best.xf = float(best.x);
+    best.yf = float(best.y);
+    best.rf = float(best.r);
+    return best;
+}
+
+static void verifyAccumulators(Verification *verification, const cv::Mat &gray, const std::string &size)
+{
+    const AccumulatorCase cases[] = { { "UInt16", AccumulatorType::UInt16, 1 },
+                                      { "UInt8", AccumulatorType::UInt8, 1 },
+                                      { "Sparse", AccumulatorType::Sparse, 1 },
+                                      { "Sparse", AccumulatorType::Sparse, 4 } };
+    const float phiStep = 0.5f;
+    const int radius = 25;
+
+    Canny canny;
+    cv::Mat edges;
+    EdgePoints points;
+    canny.detect(gray, edges, 40, 100, &points);
+
+    Segmentation segmentation;
+    for (float cellStep : { 1.0f, 0.5f })
+    {
+        HoughAccumulator reference, removed;
+        reference.type = AccumulatorType::Int32;
+        removed.type = AccumulatorType::Int32;
+        Segmentation::houghCircle(points, reference, radius, cellStep, phiStep);
+        Segmentation::houghCircle(points, removed, radius, cellStep, phiStep);
+        std::vector<int> referenceMaxima = removeMaxima(removed, radius, cellStep);
+
+        std::vector<CircleItem> referenceCircles;
+        segmentation.accumulatorType = AccumulatorType::Int32;
+        segmentation.accumulatorThreads = 1;
+        segmentation.findCircles(points, &referenceCircles, 17, 29, cellStep, phiStep, 5);
+
+        std::vector<CircleItem> referenceStrongest(1, strongestCircleReference(points, 17, 29, cellStep, phiStep));
+        std::vector<CircleItem> strongest(1, Segmentation::findStrongestCircle(points, 17, 29, cellStep, phiStep));
+        std::ostringstream strongestName;
+        strongestName << "Segmentation/findStrongestCircle_Int32_cell" << cellStep;
+        verification->report(strongestName.str(), size, countDifferences(strongest, referenceStrongest));
+
+        for (const AccumulatorCase &test : cases)
+        {
+            HoughAccumulator accumulator;
+            accumulator.type = test.type;
+            accumulator.threads = test.threads;
+            Segmentation::houghCircle(points, accumulator, radius, cellStep, phiStep);
+
+            std::ostringstream name;
+            name << "HoughAccumulator/" << test.name;
+            if (test.threads > 1)
+                name << "_threads" << test.threads;
+            name << "_cell" << cellStep;
+            verification->report(name.str() + " votes", size, countDifferences(accumulator, reference));
+
+            std::vector<int> maxima = removeMaxima(accumulator, radius, cellStep);
+            long differences = 0;
+            for (size_t i = 0; i < maxima.size(); i += 3)
+            {
+                if (!std::equal(maxima.begin() + i, maxima.begin() + i + 3, referenceMaxima.begin() + i))
+                    ++differences;
+            }
+            verification->report(name.str() + " maxima", size, differences);
+
+            std::vector<CircleItem> circles;
+            segmentation.accumulatorType = test.type;
+            segmentation.accumulatorThreads = test.threads;
+            segmentation.findCircles(points, &circles, 17, 29, cellStep, phiStep, 5);
+            verification->report(name.str() + " findCircles", size, countDifferences(circles, referenceCircles));
+
+            if (test.threads > 1)
+                continue;
+            strongest[0] = Segmentation::findStrongestCircle(points, 17, 29, cellStep, phiStep, test.type);
+            verification->report(name.str() + " findStrongestCircle", size,
+                                 countDifferences(strongest, referenceStrongest));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// EdgeStream: the same prepared image, edge image and edge pixels as the chain of
+// operators in CoinDetector::prepare (whole image and a view, several blur kernels)
+////////////////////////////////////////////////////////////////////////////////////
+static void verifyEdgeStream(Verification *verification, const cv::Mat &image, const std::string &size)
+{
+    CoinDetector detector;
+    CoinDetector::PrepareBuffers streamBuffers, chainBuffers;
+    Filter filter;
+
+    CoinSettings settings;
+    settings.brightness = 10;
+    settings.contrast = 1.2f;
+    settings.edgeThreshold = 90;
+
+    // (sigma 0: identity kernels, the blur only crops the edges)
+    const int kernelSizes[] = { 3, 5, 7 };
+    const double sigmas[] = { 0.0, 1.0, 1.5 };
+    const cv::Rect views[] = { cv::Rect(0, 0, image.cols, image.rows),
+                               cv::Rect(image.cols / 5, image.rows / 7, image.cols / 2 + 3, image.rows / 2 + 5) };
+    const char *viewNames[] = { "image", "view" };
+
+    for (int kernel = 0; kernel < 3; ++kernel)
+    {
+        settings.blurKernelSize = kernelSizes[kernel];
+        settings.blurSigma = sigmas[kernel];
+        filter.setGaussianKernels1D(settings.blurKernelHorizontal, settings.blurKernelVertical,
+                                    settings.blurKernelSize, settings.blurSigma);
+        for (int v = 0; v < 2; ++v)
+        {
+            RoiImage view = RoiImage::of(image, views[v]);
+            RoiImage blurStream, edgesStream, blurChain, edgesChain;
+            EdgePoints pointsStream, pointsChain;
+            settings.streamEdges = true;
+            detector.prepare(view, settings, blurStream, edgesStream, &pointsStream, &streamBuffers);
+            settings.streamEdges = false;
+            detector.prepare(view, settings, blurChain, edgesChain, &pointsChain, &chainBuffers);
+
+            std::ostringstream name;
+            name << "EdgeStream/kernel" << settings.blurKernelSize << "_" << viewNames[v] << " ";
+            verification->report(name.str() + "blur", size, countDifferences(blurStream, blurChain));
+            verification->report(name.str() + "edges", size, countDifferences(edgesStream, edgesChain));
+            verification->report(name.str() + "points", size, countDifferences(pointsStream, pointsChain));
+
+            std::ostringstream digestName;
+            digestName << "CoinDetector/prepare_kernel" << settings.blurKernelSize << "_" << viewNames[v];
+            recordDigest(verification, digestName.str() + "_edges", size, digestOf(edgesStream.mat));
+            recordDigest(verification, digestName.str() + "_points", size, digestOf(pointsStream));
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// output check (see Verify.h)
+////////////////////////////////////////////////////////////////////////////////////
+int runVerify(int argc, char *argv[])
+{
+    std::string sizeList = "vga,333x251"; // (odd size: the remainders of the SIMD kernels)
+    std::string saveFile, againstFile;
+
+    // (argv[1] is "--verify")
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--sizes" && i + 1 < argc)
+            sizeList = argv[++i];
+        else if (argument == "--save" && i + 1 < argc)
+            saveFile = argv[++i];
+        else if (argument == "--against" && i + 1 < argc)
+            againstFile = argv[++i];
+        else
+        {
+            std::cout << "Usage: " << argv[0]
+                      << " --verify [--sizes vga,<w>x<h>] [--save <file>] [--against <file>]\n";
+            return 2;
+        }
+    }
+
+    std::map<std::string, uint64_t> reference;
+    if (!againstFile.empty() && !loadDigests(againstFile, &reference))
+        return 2;
+
+    std::cout << "CPU kernels: " << cpuLevelName(cpuLevel()) << "\n";
+
+    Verification verification;
+    SceneGenerator generator;
+    for (const auto &name : splitList(sizeList))
+    {
+        SceneSettings scene;
+        if (!parseSize(name, &scene.size))
+        {
+            std::cout << "Verify: unknown image size '" << name << "'\n";
+            return 2;
+        }
+        scene.coinCount = std::max(2, scene.size.area() / 40000);
+        scene.occlusion = 0.2;
+
+        std::ostringstream sizeStream;
+        sizeStream << scene.size.width << 'x' << scene.size.height;
+        std::string size = sizeStream.str();
+
+        cv::Mat image;
+        std::vector<SceneCoin> coins;
+        generator.generate(scene, image, &coins);
+        cv::Mat gray;
+        cv::cvtColor(image, gray, cv::COLOR_BGR2GRAY);
+
+        verifyRowKernels(&verification, gray, size);
+        verifyGradient(&verification, gray, size);
+        verifyCanny(&verification, gray, size);
+        verifyIntegralImage(&verification, gray, size);
+        verifyRecursiveGaussian(&verification, gray, size);
+        verifyEdgePreserving(&verification, gray, size);
+        verifyAccumulators(&verification, gray, size);
+        verifyEdgeStream(&verification, image, size);
+    }
+
+    if (!againstFile.empty())
+        compareDigests(&verification, reference, againstFile);
+    if (!saveFile.empty() && !saveDigests(verification, saveFile))
+        return 2;
+
+    std::cout << "Verify: " << verification.checks << " checks, " << verification.failures << " failed\n";
+    return verification.failures == 0 ? 0 : 1;
+}
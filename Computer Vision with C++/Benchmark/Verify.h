@@ -0,0 +1,17 @@
+#ifndef VERIFY_H
+#define VERIFY_H
+
+// output check of the optimized paths (no timing): results which are documented as
+// equal (bit for bit) are computed both ways on synthetic coin scenes (SceneGenerator)
+// and compared, every difference is reported
+//
+// the SIMD kernels are selected once per process (see CpuDispatch.h), so the outputs
+// of two instruction sets are compared by digests of two runs:
+//   CORE_CPU=scalar benchmark --verify --save scalar.txt
+//   benchmark --verify --against scalar.txt
+//
+// usage: --verify [--sizes vga,<w>x<h>] [--save <file>] [--against <file>]
+// returns 0 if all outputs are equal, 1 if any output differs
+int runVerify(int argc, char *argv[]);
+
+#endif /* VERIFY_H */
@@ -0,0 +1,477 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <algorithm>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "Benchmark.h"
+#include "PipelineBenchmark.h"
+#include "Verify.h"
+#include "../Core/Threshold.h"
+#include "../Core/PointOperations.h"
+#include "../Core/Histogram.h"
+#include "../Core/Filter.h"
+#include "../Core/Morphology.h"
+#include "../Core/Segmentation.h"
+#include "../Core/EdgePoints.h"
+#include "../Core/Gradient.h"
+#include "../Core/Canny.h"
+#include "../Core/IntegralImage.h"
+#include "../Core/HoughAccumulator.h"
+#include "../Core/CpuDispatch.h"
+#include "../Coin Detection/EdgeStream.h"
+
+// an operator: input image -> output image
+typedef std::function<void(const cv::Mat &, cv::Mat &)> Operator;
+
+////////////////////////////////////////////////////////////////////////////////////
+// synthetic test images (deterministic, the same for every run)
+////////////////////////////////////////////////////////////////////////////////////
+
+// circles of the test images (radius 20 .. 30 px, one per 150 x 150 px)
+static std::vector<cv::Vec3i> createCircles(const cv::Size &size, const unsigned int seed)
+{
+    cv::RNG rng(seed);
+    std::vector<cv::Vec3i> circles;
+    int count = std::max(1, size.area() / (150 * 150));
+    for (int i = 0; i < count; ++i)
+    {
+        int r = rng.uniform(20, 31);
+        circles.push_back(cv::Vec3i(rng.uniform(r, size.width - r), rng.uniform(r, size.height - r), r));
+    }
+    return circles;
+}
+
+// BGR image: gradient background, filled circles and gaussian noise
+static cv::Mat createColorImage(const cv::Size &size, const unsigned int seed)
+{
+    cv::RNG rng(seed);
+    cv::Mat image(size, CV_8UC3);
+    for (int r = 0; r < size.height; ++r)
+    {
+        uchar *pImage = image.ptr<uchar>(r);
+        for (int c = 0; c < size.width; ++c)
+        {
+            int value = 20 + 160 * c / size.width + 60 * r / size.height;
+            *pImage++ = cv::saturate_cast<uchar>(value + rng.gaussian(12.0));
+            *pImage++ = cv::saturate_cast<uchar>(value + rng.gaussian(12.0));
+            *pImage++ = cv::saturate_cast<uchar>(value + rng.gaussian(12.0));
+        }
+    }
+
+    for (auto circle : createCircles(size, seed))
+    {
+        cv::Scalar color = (circle[2] % 2) ? cv::Scalar(60, 160, 200) : cv::Scalar(180, 180, 170);
+        cv::circle(image, cv::Point(circle[0], circle[1]), circle[2], color, -1);
+    }
+    return image;
+}
+
+// edge image: outlines of the circles and 0.5% random edge pixels
+static cv::Mat createEdgeImage(const cv::Size &size, const unsigned int seed)
+{
+    cv::RNG rng(seed);
+    cv::Mat edges = cv::Mat::zeros(size, CV_8U);
+    for (auto circle : createCircles(size, seed))
+    {
+        cv::circle(edges, cv::Point(circle[0], circle[1]), circle[2], cv::Scalar(255), 1);
+    }
+    int noise = size.area() / 200;
+    for (int i = 0; i < noise; ++i)
+    {
+        edges.at<uchar>(rng.uniform(0, size.height), rng.uniform(0, size.width)) = 255;
+    }
+    return edges;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// run an operator on 'threads' horizontal stripes of the image in parallel
+//
+// overlap: rows above and below a stripe which the operator needs (kernel border)
+// note: the threads are started for every call, like in the programs
+////////////////////////////////////////////////////////////////////////////////////
+static void runStripes(const cv::Mat &input, std::vector<cv::Mat> *outputs, const int threads, const int overlap,
+                       const Operator &op)
+{
+    outputs->resize(threads);
+    if (threads == 1)
+    {
+        op(input, outputs->at(0));
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    int stripeRows = (input.rows + threads - 1) / threads;
+    for (int i = 0; i < threads; ++i)
+    {
+        int start = std::max(0, i * stripeRows - overlap);
+        int end = std::min(input.rows, (i + 1) * stripeRows + overlap);
+        if (start >= end)
+            continue;
+        cv::Mat stripe = input.rowRange(start, end);
+        workers.push_back(std::thread(op, stripe, std::ref(outputs->at(i))));
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// benchmark cases of all operators for one image size
+////////////////////////////////////////////////////////////////////////////////////
+static void runImageSize(Benchmark *benchmark, const cv::Size &size, const std::vector<int> &threadCounts)
+{
+    std::ostringstream sizeStream;
+    sizeStream << size.width << 'x' << size.height;
+    std::string sizeName = sizeStream.str();
+    double pixels = double(size.area());
+
+    // inputs
+    cv::Mat color = createColorImage(size, 42);
+    cv::Mat gray;
+    cv::cvtColor(color, gray, cv::COLOR_BGR2GRAY);
+    cv::Mat grayFloat;
+    gray.convertTo(grayFloat, CV_32F);
+    cv::Mat binary;
+    cv::threshold(gray, binary, 128, 255, cv::THRESH_BINARY);
+    cv::Mat edges = createEdgeImage(size, 42);
+
+    Threshold threshold;
+    PointOperations pointOperations;
+    Histogram histogram;
+    Filter filter;
+    Morphology morphology;
+    Segmentation segmentation;
+    Gradient gradient;
+    Canny canny;
+
+    cv::Mat binomial3 = filter.getBinomial(3);
+    cv::Mat binomial5 = filter.getBinomial(5);
+    cv::Mat gaussHorizontal, gaussVertical;
+    filter.setGaussianKernels1D(gaussHorizontal, gaussVertical, 7, 1.5);
+    cv::Mat gaussHorizontalLarge, gaussVerticalLarge; // sigma 5: 6 sigma + 1 taps
+    filter.setGaussianKernels1D(gaussHorizontalLarge, gaussVerticalLarge, 31, 5.0);
+    cv::Mat kernel3x3 = morphology.getKernelFull(3);
+    cv::Mat sobelX = filter.getSobelX(3);
+    cv::Mat sobelY = filter.getSobelY(3);
+    cv::Mat eroded;
+    morphology.erode(binary, eroded, kernel3x3);
+
+    //
+    // operators which can be split into stripes: every thread count
+    //
+    for (int threads : threadCounts)
+    {
+        std::vector<cv::Mat> outputs;
+        auto add = [&](const std::string &group, const std::string &name, const cv::Mat &input, const int overlap,
+                       const Operator &op)
+        {
+            benchmark->run(group, name, sizeName, threads, pixels,
+                           [&]() { runStripes(input, &outputs, threads, overlap, op); });
+        };
+
+        // Threshold
+        add("Threshold", "cv", gray, 0, [&](const cv::Mat &in, cv::Mat &out) { threshold.cv(in, out, 128); });
+        add("Threshold", "loop", gray, 0, [&](const cv::Mat &in, cv::Mat &out) { threshold.loop(in, out, 128); });
+        add("Threshold", "loop_ptr", gray, 0, [&](const cv::Mat &in, cv::Mat &out) { threshold.loop_ptr(in, out, 128); });
+        add("Threshold", "loop_ptr2", gray, 0, [&](const cv::Mat &in, cv::Mat &out) { threshold.loop_ptr2(in, out, 128); });
+        add("Threshold", "adaptive_31", gray, 15,
+            [&](const cv::Mat &in, cv::Mat &out) { threshold.adaptive(in, out, 31, 5); });
+
+        // PointOperations
+        add("PointOperations", "adjustBrightness", gray, 0,
+            [&](const cv::Mat &in, cv::Mat &out) { pointOperations.adjustBrightness(in, out, 20); });
+        add("PointOperations", "adjustContrast", gray, 0,
+            [&](const cv::Mat &in, cv::Mat &out) { pointOperations.adjustContrast(in, out, 1.5f); });
+        add("PointOperations", "invert", gray, 0,
+            [&](const cv::Mat &in, cv::Mat &out) { pointOperations.invert(in, out); });
+        add("PointOperations", "quantize", gray, 0,
+            [&](const cv::Mat &in, cv::Mat &out) { pointOperations.quantize(in, out, 3); });
+
+        // in place: the output is the (copied) input stripe
+        cv::Mat scratch = gray.clone();
+        add("PointOperations", "adjustBrightness_inplace", scratch, 0,
+            [&](const cv::Mat &in, cv::Mat &out) { out = in; pointOperations.adjustBrightness(in, out, 0); });
+
+        // Histogram
+        add("Histogram", "calcHist_cv", gray, 0, [&](const cv::Mat &in, cv::Mat &out) { histogram.calcHist_cv(in, out); });
+        add("Histogram", "calcHist", gray, 0, [&](const cv::Mat &in, cv::Mat &out) { histogram.calcHist(in, out); });
+
+        // Filter
+        add("Filter", "convolve_cv_3x3", gray, 1,
+            [&](const cv::Mat &in, cv::Mat &out) { filter.convolve_cv(in, out, binomial3); });
+        add("Filter", "convolve_3x3", grayFloat, 1,
+            [&](const cv::Mat &in, cv::Mat &out) { filter.convolve_3x3(in, out, binomial3); });
+        add("Filter", "convolve_generic_5x5", grayFloat, 2,
+            [&](const cv::Mat &in, cv::Mat &out) { filter.convolve_generic(in, out, binomial5); });
+        add("Filter", "convolve_extrapolate_5x5", grayFloat, 2,
+            [&](const cv::Mat &in, cv::Mat &out) { filter.convolve_extrapolate(in, out, binomial5); });
+        add("Filter", "gauss_separated_7", grayFloat, 3, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            cv::Mat horizontal;
+            filter.convolve_generic_normalized_float_kernel(in, horizontal, gaussHorizontal);
+            filter.convolve_generic_normalized_float_kernel(horizontal, out, gaussVertical);
+        });
+        add("Filter", "gauss_separated_31", grayFloat, 15, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            cv::Mat horizontal;
+            filter.convolve_generic_normalized_float_kernel(in, horizontal, gaussHorizontalLarge);
+            filter.convolve_generic_normalized_float_kernel(horizontal, out, gaussVerticalLarge);
+        });
+        // (infinite impulse response: the stripes overlap by 3 sigma)
+        add("Filter", "gauss_recursive_5", grayFloat, 15,
+            [&](const cv::Mat &in, cv::Mat &out) { filter.gaussianRecursive(in, out, 5.0); });
+        // integral image: the same runtime for every window size (one object per stripe)
+        add("Filter", "box_integral_5", gray, 2,
+            [&](const cv::Mat &in, cv::Mat &out) { IntegralImage().boxFilter(in, out, cv::Size(5, 5)); });
+        add("Filter", "box_integral_31", gray, 15,
+            [&](const cv::Mat &in, cv::Mat &out) { IntegralImage().boxFilter(in, out, cv::Size(31, 31)); });
+        // edge-preserving: median (the same runtime for every radius) and separable bilateral filter
+        add("Filter", "median_r2", gray, 2, [&](const cv::Mat &in, cv::Mat &out) { filter.median(in, out, 2); });
+        add("Filter", "median_r7", gray, 7, [&](const cv::Mat &in, cv::Mat &out) { filter.median(in, out, 7); });
+        add("Filter", "bilateral_2", gray, 4,
+            [&](const cv::Mat &in, cv::Mat &out) { filter.bilateral(in, out, 2.0, 30.0); });
+
+        // Gradient: 2 convolutions + magnitude vs. fused Sobel
+        add("Gradient", "convolve_3x3_abs", grayFloat, 1, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            cv::Mat gx, gy;
+            filter.convolve_3x3(in, gx, sobelX);
+            filter.convolve_3x3(in, gy, sobelY);
+            filter.getAbsOfSobel(gx, gy, out);
+        });
+        add("Gradient", "sobel_L1", gray, 1,
+            [&](const cv::Mat &in, cv::Mat &out) { gradient.sobel(in, out, nullptr, GradientNorm::L1); });
+        add("Gradient", "sobel_L2", gray, 1,
+            [&](const cv::Mat &in, cv::Mat &out) { gradient.sobel(in, out, nullptr, GradientNorm::L2); });
+        add("Gradient", "sobel_FastL2", gray, 1,
+            [&](const cv::Mat &in, cv::Mat &out) { gradient.sobel(in, out, nullptr, GradientNorm::FastL2); });
+        add("Gradient", "sobel_L2_orientation8", gray, 1, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            cv::Mat orientation;
+            gradient.sobel(in, out, &orientation, GradientNorm::L2, 8);
+        });
+
+        // Canny: its own bands (stitched at the borders) instead of independent stripes
+        cv::Mat cannyEdges;
+        benchmark->run("Canny", "detect", sizeName, threads, pixels,
+                       [&]() { canny.detect(gray, cannyEdges, 40, 100, nullptr, threads); });
+        benchmark->run("Canny", "detect_L2", sizeName, threads, pixels,
+                       [&]() { canny.detect(gray, cannyEdges, 40, 100, nullptr, threads, GradientNorm::L2); });
+
+        // Morphology
+        add("Morphology", "erode_3x3", binary, 1,
+            [&](const cv::Mat &in, cv::Mat &out) { morphology.erode(in, out, kernel3x3); });
+        add("Morphology", "dilate_3x3", binary, 1,
+            [&](const cv::Mat &in, cv::Mat &out) { morphology.dilate(in, out, kernel3x3); });
+        add("Morphology", "subtract", binary, 0, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            // (the stripe of the eroded image at the same position)
+            cv::Size whole;
+            cv::Point offset;
+            in.locateROI(whole, offset);
+            morphology.subtract(in, out, eroded.rowRange(offset.y, offset.y + in.rows));
+        });
+
+        // edge extraction of the coin detection: chain of operators vs. streaming
+        // (both allocate their buffers for every call)
+        int chainOverlap = gaussVertical.rows / 2 + 2;
+        add("EdgeChain", "operators", color, chainOverlap, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            RoiImage grayImage, grayFloatImage, horizontal, vertical, blur, thresh, erodedImage, edgeImage;
+            cv::cvtColor(in, grayImage.mat, cv::COLOR_BGR2GRAY);
+            pointOperations.adjustBrightness(grayImage, grayImage, 10);
+            pointOperations.adjustContrast(grayImage, grayImage, 1.2f);
+            grayImage.mat.convertTo(grayFloatImage.mat, CV_32F);
+            filter.convolve_generic_normalized_float_kernel(grayFloatImage, horizontal, gaussHorizontal);
+            filter.convolve_generic_normalized_float_kernel(horizontal, vertical, gaussVertical);
+            vertical.mat.convertTo(blur.mat, CV_8U);
+            blur.origin = vertical.origin;
+            threshold.loop_ptr2(blur, thresh, 128);
+            morphology.erode(thresh, erodedImage, kernel3x3);
+            morphology.subtract(thresh, edgeImage, erodedImage);
+            out = edgeImage.mat;
+        });
+        add("EdgeChain", "canny", color, canny.getBorder().top, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            Canny stripeCanny;
+            RoiImage grayImage, edgeImage;
+            cv::cvtColor(in, grayImage.mat, cv::COLOR_BGR2GRAY);
+            pointOperations.adjustBrightness(grayImage, grayImage, 10);
+            pointOperations.adjustContrast(grayImage, grayImage, 1.2f);
+            stripeCanny.detect(grayImage, edgeImage, 40, 100);
+            out = edgeImage.mat;
+        });
+        add("EdgeChain", "stream", color, chainOverlap, [&](const cv::Mat &in, cv::Mat &out)
+        {
+            EdgeStream stream; // (ring buffers: one per thread)
+            RoiImage edgeImage;
+            stream.run(RoiImage(in), 10, 1.2f, gaussHorizontal, gaussVertical, 128, kernel3x3, nullptr, edgeImage);
+            out = edgeImage.mat;
+        });
+    }
+
+    //
+    // Hough transformation: single-threaded, findCirclesThread uses its own 4 threads
+    //
+    const float cellStep = 1.0f;
+    const float phiStep = 2.0f;
+    const int radiusMin = 20;
+    const int radiusMax = 30;
+    const int maxCount = 5;
+    EdgePoints edgePoints;
+    EdgePoints::fromImage(edges, &edgePoints);
+    cv::Mat hough;
+    std::vector<CircleItem> circles;
+
+    benchmark->run("Segmentation", "edgePoints_fromImage", sizeName, 1, pixels,
+                   [&]() { EdgePoints::fromImage(edges, &edgePoints); });
+    benchmark->run("Segmentation", "houghCircle_image", sizeName, 1, pixels,
+                   [&]() { segmentation.houghCircle(edges, hough, 25, cellStep, phiStep); });
+    benchmark->run("Segmentation", "houghCircle_points", sizeName, 1, pixels,
+                   [&]() { segmentation.houghCircle(edgePoints, hough, 25, cellStep, phiStep); });
+
+    // accumulator cell types (32, 16, 8 bit, sparse), also with the fine grid of the Circle Detection demo
+    HoughAccumulator accumulator;
+    const std::vector<std::pair<std::string, AccumulatorType>> accumulatorTypes = {
+        {"32", AccumulatorType::Int32}, {"16", AccumulatorType::UInt16}, {"8", AccumulatorType::UInt8},
+        {"sparse", AccumulatorType::Sparse}};
+    for (const auto &type : accumulatorTypes)
+    {
+        accumulator.type = type.second;
+        benchmark->run("Segmentation", "houghCircle_points_" + type.first, sizeName, 1, pixels,
+                       [&]() { segmentation.houghCircle(edgePoints, accumulator, 25, cellStep, phiStep); });
+        benchmark->run("Segmentation", "houghCircle_points_cell0.2_" + type.first, sizeName, 1, pixels,
+                       [&]() { segmentation.houghCircle(edgePoints, accumulator, 25, 0.2f, phiStep); });
+        segmentation.accumulatorType = type.second;
+        benchmark->run("Segmentation", "findCircles_points_" + type.first, sizeName, 1, pixels, [&]()
+        {
+            segmentation.findCircles(edgePoints, &circles, radiusMin, radiusMax, cellStep, phiStep, maxCount);
+        });
+    }
+    segmentation.accumulatorType = AccumulatorType::Int32;
+
+    // sparse: the votes of 4 threads in their own tables (+ merge)
+    accumulator.type = AccumulatorType::Sparse;
+    accumulator.threads = 4;
+    benchmark->run("Segmentation", "houghCircle_points_cell0.2_sparse", sizeName, 4, pixels,
+                   [&]() { segmentation.houghCircle(edgePoints, accumulator, 25, 0.2f, phiStep); });
+
+    benchmark->run("Segmentation", "houghTransform_points", sizeName, 1, pixels,
+                   [&]() { segmentation.houghTransform(edgePoints, 1.0f, hough); });
+    benchmark->run("Segmentation", "findCircles", sizeName, 1, pixels, [&]()
+    {
+        segmentation.findCircles(edges, &circles, radiusMin, radiusMax, cellStep, phiStep, maxCount);
+    });
+    benchmark->run("Segmentation", "findCircles_points", sizeName, 1, pixels, [&]()
+    {
+        segmentation.findCircles(edgePoints, &circles, radiusMin, radiusMax, cellStep, phiStep, maxCount);
+    });
+    benchmark->run("Segmentation", "findCirclesThread", sizeName, 4, pixels, [&]()
+    {
+        segmentation.findCirclesThread(edgePoints, &circles, radiusMin, radiusMax, cellStep, phiStep, maxCount);
+    });
+    benchmark->run("Segmentation", "findCirclesPyramid_1", sizeName, 1, pixels, [&]()
+    {
+        segmentation.findCirclesPyramid(edgePoints, &circles, radiusMin, radiusMax, cellStep, phiStep, maxCount, 1);
+    });
+    benchmark->run("Segmentation", "findStrongestCircle", sizeName, 1, pixels, [&]()
+    {
+        segmentation.findStrongestCircle(edgePoints, radiusMin, radiusMax, cellStep, phiStep);
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// main
+////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char *argv[])
+{
+    // end-to-end benchmark of the coin detection on synthetic scenes
+    if (argc > 1 && std::string(argv[1]) == "--pipeline")
+        return runPipelineBenchmark(argc, argv);
+
+    // outputs of the optimized paths which must be equal (no timing)
+    if (argc > 1 && std::string(argv[1]) == "--verify")
+        return runVerify(argc, argv);
+
+    Benchmark benchmark;
+    std::string sizeList = "vga,hd,fullhd,4k";
+    std::string threadList;
+    std::string csvFile, jsonFile, baselineFile;
+    double tolerance = 0.10;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--sizes" && i + 1 < argc)
+            sizeList = argv[++i];
+        else if (argument == "--threads" && i + 1 < argc)
+            threadList = argv[++i];
+        else if (argument == "--warmup" && i + 1 < argc)
+            benchmark.warmup = std::max(0, std::atoi(argv[++i]));
+        else if (argument == "--repetitions" && i + 1 < argc)
+            benchmark.repetitions = std::max(1, std::atoi(argv[++i]));
+        else if (argument == "--filter" && i + 1 < argc)
+            benchmark.filter = argv[++i];
+        else if (argument == "--csv" && i + 1 < argc)
+            csvFile = argv[++i];
+        else if (argument == "--json" && i + 1 < argc)
+            jsonFile = argv[++i];
+        else if (argument == "--compare" && i + 1 < argc)
+            baselineFile = argv[++i];
+        else if (argument == "--tolerance" && i + 1 < argc)
+            tolerance = std::atof(argv[++i]);
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--sizes vga,hd,fullhd,4k,<w>x<h>] [--threads 1,2,4]"
+                      << " [--warmup <n>] [--repetitions <n>] [--filter <text>] [--csv <file>] [--json <file>]"
+                      << " [--compare <baseline.csv>] [--tolerance <0.10>]\n";
+            return 2;
+        }
+    }
+
+    std::cout << "CPU kernels: " << cpuLevelName(cpuLevel()) << "\n";
+
+    // thread counts: 1 and all cores (default)
+    std::vector<int> threadCounts;
+    for (const auto &item : splitList(threadList))
+        threadCounts.push_back(std::max(1, std::atoi(item.c_str())));
+    if (threadCounts.empty())
+    {
+        threadCounts.push_back(1);
+        int cores = int(std::thread::hardware_concurrency());
+        if (cores > 1)
+            threadCounts.push_back(cores);
+    }
+
+    for (const auto &name : splitList(sizeList))
+    {
+        cv::Size size;
+        if (!parseSize(name, &size))
+        {
+            std::cout << "Benchmark: unknown image size '" << name << "'\n";
+            return 2;
+        }
+        runImageSize(&benchmark, size, threadCounts);
+    }
+
+    if (!csvFile.empty())
+        benchmark.writeCsv(csvFile);
+    if (!jsonFile.empty())
+        benchmark.writeJson(jsonFile);
+
+    // regressions -> exit code 1 (e.g. for a script which runs the benchmark after every change)
+    if (!baselineFile.empty())
+    {
+        int regressions = benchmark.compare(baselineFile, tolerance);
+        if (regressions != 0)
+            return 1;
+    }
+    return 0;
+}
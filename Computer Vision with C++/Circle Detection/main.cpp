@@ -8,12 +8,12 @@
 #include <stdio.h>
 #include <vector>
 
-#include "Threshold.h"
-#include "Histogram.h"
-#include "PointOperations.h"
-#include "Filter.h"
-#include "Morphology.h"
-#include "Segmentation.h"
+#include "../Core/Threshold.h"
+#include "../Core/Histogram.h"
+#include "../Core/PointOperations.h"
+#include "../Core/Filter.h"
+#include "../Core/Morphology.h"
+#include "../Core/Segmentation.h"
 #include "Timer.h"
 #include "imshow_multiple.h"
 
@@ -126,6 +126,7 @@ int main(int argc, char *argv[])
     // min. and max. radius
     int rMin = 10;
     int rMax = 35;
+    int maxCountPerRadius = 100; // circles per radius (the test images have only a few circles)
     
     //
     // image with 1 circle
@@ -144,7 +145,7 @@ int main(int argc, char *argv[])
         std::vector<CircleItem> circles;
 
         // find cirlces
-        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep);
+        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep, maxCountPerRadius);
 
         // draw circles in BGR image
         for (auto circle : circles)
@@ -174,7 +175,7 @@ int main(int argc, char *argv[])
         std::vector<CircleItem> circles;
 
         // find cirlces
-        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep);
+        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep, maxCountPerRadius);
 
         // draw circles in BGR image
         for (auto circle : circles)
@@ -204,7 +205,7 @@ int main(int argc, char *argv[])
         std::vector<CircleItem> circles;
 
         // find cirlces
-        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep);
+        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep, maxCountPerRadius);
 
         // draw circles in BGR image
         for (auto circle : circles)
@@ -234,7 +235,7 @@ int main(int argc, char *argv[])
         std::vector<CircleItem> circles;
 
         // find cirlces
-        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep);
+        segmentation->findCircles(imgGray, &circles, rMin, rMax, cellStep, phiStep, maxCountPerRadius);
 
         // draw circles in BGR image
         for (auto circle : circles)
@@ -0,0 +1,288 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <sys/stat.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "Batch.h"
+#include "Coin.h"
+#include "CoinDetector.h"
+
+// results of one image
+struct BatchResult
+{
+    std::string fileName;
+    bool loaded = false;
+    std::vector<CircleItem> circles; // image coordinates
+    std::vector<double> values;
+    double sum = 0.0;
+    double milliseconds = 0.0;
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// add an image file or all image files of a directory to the list
+////////////////////////////////////////////////////////////////////////////////////
+static void addImageFiles(const std::string &path, std::vector<std::string> *files)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+    {
+        std::cout << "Batch: '" << path << "' does not exist.\n";
+        return;
+    }
+
+    if (!(info.st_mode & S_IFDIR))
+    {
+        files->push_back(path);
+        return;
+    }
+
+    // directory: use all files with a known image extension (sorted by name)
+    std::vector<cv::string> entries;
+    cv::glob(path + "/*", entries, false);
+    const char *extensions[] = { ".tiff", ".tif", ".png", ".jpg", ".jpeg", ".bmp" };
+    for (auto entry : entries)
+    {
+        std::string lower = entry;
+        for (auto &c : lower)
+            c = tolower(c);
+
+        for (auto extension : extensions)
+        {
+            std::string ext(extension);
+            if (lower.size() > ext.size() && lower.compare(lower.size() - ext.size(), ext.size(), ext) == 0)
+            {
+                files->push_back(entry);
+                break;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// process the images [nextIndex, files.size()) (every thread takes the next image)
+////////////////////////////////////////////////////////////////////////////////////
+static void batchWorker(const std::vector<std::string> *files, std::vector<BatchResult> *results,
+                        std::atomic<size_t> *nextIndex, const CoinSettings *calibratedSettings, const Coin *calibratedCoin)
+{
+    // every thread has its own detector and coin (with its own mask cache)
+    CoinDetector detector;
+    Coin coin = *calibratedCoin;
+
+    while (true)
+    {
+        size_t index = (*nextIndex)++;
+        if (index >= files->size())
+            return;
+
+        auto start = std::chrono::high_resolution_clock::now();
+        BatchResult *result = &results->at(index);
+        result->fileName = files->at(index);
+
+        CoinFrame frame;
+        frame.settings = *calibratedSettings;
+        frame.input = cv::imread(result->fileName, CV_LOAD_IMAGE_COLOR);
+        if (frame.input.empty())
+        {
+            std::cout << "Batch: unable to read '" << result->fileName << "'\n";
+            continue;
+        }
+        result->loaded = true;
+
+        // use the calibrated view if it fits into the image, otherwise the whole image
+        cv::Rect image(0, 0, frame.input.cols, frame.input.rows);
+        if (frame.settings.view.area() == 0 || (frame.settings.view & image) != frame.settings.view)
+            frame.settings.view = image;
+
+        detector.prepareFrame(&frame);
+        detector.detectFrame(&frame, &coin);
+        frame.coins = coin.classifyAll(frame.input, frame.circles);
+
+        result->circles = frame.circles;
+        result->values = frame.coins.values;
+        for (auto value : result->values)
+        {
+            if (value >= 0.01)
+                result->sum += value;
+        }
+        result->milliseconds = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start).count() / 1000.0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// write the results as CSV (one line per circle) and JSON (one object per image)
+////////////////////////////////////////////////////////////////////////////////////
+
+// text as CSV field (RFC 4180): in quotes, quotes inside are doubled
+static std::string escapeCsv(const std::string &text)
+{
+    std::string escaped = "\"";
+    for (char c : text)
+    {
+        if (c == '"')
+            escaped += '"';
+        escaped += c;
+    }
+    return escaped + '"';
+}
+
+static void writeCsv(const std::string &fileName, const std::vector<BatchResult> &results)
+{
+    std::ofstream file(fileName);
+    file << std::fixed << std::setprecision(2);
+    file << "image,circle,x,y,r,value,image_sum\n";
+    for (const auto &result : results)
+    {
+        if (!result.loaded)
+            continue;
+        for (size_t i = 0; i < result.circles.size(); ++i)
+        {
+            const CircleItem &circle = result.circles[i];
+            file << escapeCsv(result.fileName) << ',' << i << ',' << circle.xf << ',' << circle.yf << ','
+                 << circle.rf << ',' << result.values[i] << ',' << result.sum << '\n';
+        }
+    }
+}
+
+// text as content of a JSON string: quotes, backslashes and control characters are escaped
+static std::string escapeJson(const std::string &text)
+{
+    std::ostringstream escaped;
+    for (unsigned char c : text)
+    {
+        if (c == '"' || c == '\\')
+            escaped << '\\' << char(c);
+        else if (c < 0x20)
+            escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec;
+        else
+            escaped << char(c);
+    }
+    return escaped.str();
+}
+
+static void writeJson(const std::string &fileName, const std::vector<BatchResult> &results)
+{
+    std::ofstream file(fileName);
+    file << std::fixed << std::setprecision(2);
+    file << "[\n";
+    bool first = true;
+    for (const auto &result : results)
+    {
+        if (!result.loaded)
+            continue;
+        file << (first ? "" : ",\n") << "  {\"image\": \"" << escapeJson(result.fileName) << "\", \"sum\": "
+             << result.sum << ", \"time_ms\": " << result.milliseconds << ", \"coins\": [";
+        for (size_t i = 0; i < result.circles.size(); ++i)
+        {
+            const CircleItem &circle = result.circles[i];
+            file << (i ? ", " : "") << "{\"x\": " << circle.xf << ", \"y\": " << circle.yf
+                 << ", \"r\": " << circle.rf << ", \"value\": " << result.values[i] << "}";
+        }
+        file << "]}";
+        first = false;
+    }
+    file << "\n]\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// headless coin detection for a list of images and/or directories
+////////////////////////////////////////////////////////////////////////////////////
+int runBatch(int argc, char *argv[])
+{
+    std::vector<std::string> files;
+    std::string calibrationFile, coinFile, csvFile, jsonFile;
+    int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    // parse arguments (argv[1] is "--batch")
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string argument(argv[i]);
+        if (argument == "--calibration" && i + 1 < argc)
+            calibrationFile = argv[++i];
+        else if (argument == "--coins" && i + 1 < argc)
+            coinFile = argv[++i];
+        else if (argument == "--csv" && i + 1 < argc)
+            csvFile = argv[++i];
+        else if (argument == "--json" && i + 1 < argc)
+            jsonFile = argv[++i];
+        else if (argument == "--threads" && i + 1 < argc)
+            threadCount = std::max(1, atoi(argv[++i]));
+        else
+            addImageFiles(argument, &files);
+    }
+
+    if (files.empty() || calibrationFile.empty())
+    {
+        std::cout << "usage: " << argv[0] << " --batch <directory or image> [...] --calibration <file>"
+                  << " [--coins <file>] [--csv <file>] [--json <file>] [--threads <n>]\n";
+        return -1;
+    }
+
+    // load calibration
+    CoinSettings settings;
+    Coin coin;
+    if (!coinFile.empty() && !coin.loadCoinDefinitions(coinFile))
+        return -1;
+    if (!loadCalibrationFile(calibrationFile, &settings, &coin))
+    {
+        std::cout << "Batch: unable to load calibration file '" << calibrationFile << "'\n";
+        return -1;
+    }
+    settings.enableHough = true;
+    settings.calibrated = true;
+    settings.tracking = false;   // images are independent
+    settings.useThreads = false; // the images are processed in parallel
+
+    // process all images in parallel
+    std::cout << "Batch: " << files.size() << " images, " << threadCount << " threads\n";
+    std::vector<BatchResult> results(files.size());
+    std::atomic<size_t> nextIndex(0);
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.push_back(std::thread(batchWorker, &files, &results, &nextIndex, &settings, &coin));
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - start).count() / 1000000.0;
+
+    // results
+    if (!csvFile.empty())
+        writeCsv(csvFile, results);
+    if (!jsonFile.empty())
+        writeJson(jsonFile, results);
+
+    int processed = 0;
+    double sumMilliseconds = 0.0;
+    for (const auto &result : results)
+    {
+        if (!result.loaded)
+            continue;
+        ++processed;
+        sumMilliseconds += result.milliseconds;
+        if (csvFile.empty() && jsonFile.empty())
+            std::cout << result.fileName << "\tcoins=" << result.circles.size() << "\tsum=" << std::fixed
+                      << std::setprecision(2) << result.sum << " " << coin.currency << "\n";
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << "Batch: " << processed << " images in " << seconds << " s ("
+              << (seconds > 0.0 ? processed / seconds : 0.0) << " images/s, "
+              << (processed > 0 ? sumMilliseconds / processed : 0.0) << " ms per image and thread)\n";
+
+    return processed == int(files.size()) ? 0 : 1;
+}
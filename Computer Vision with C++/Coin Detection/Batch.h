@@ -0,0 +1,10 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+// headless coin detection for image files (no windows, no keyboard)
+//
+// usage: --batch <directory or image> [...] --calibration <file>
+//        [--coins <file>] [--csv <file>] [--json <file>] [--threads <n>]
+int runBatch(int argc, char *argv[]);
+
+#endif /* BATCH_H */
@@ -0,0 +1,232 @@
+#include <iostream>
+#include <algorithm>
+
+#include "CircleTracker.h"
+
+
+////////////////////////////////////////////////////////////////////////////////////
+// constructor and destructor
+////////////////////////////////////////////////////////////////////////////////////
+CircleTracker::CircleTracker() {}
+
+CircleTracker::~CircleTracker() {}
+
+////////////////////////////////////////////////////////////////////////////////////
+// forget the previous frame (the next update runs a full detection)
+////////////////////////////////////////////////////////////////////////////////////
+void CircleTracker::reset()
+{
+    previousEdges.release();
+    previousCircles.clear();
+    previousSupport.clear();
+    previousRadiusMin = -1;
+    previousRadiusMax = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// compare the edge image with the previous one tile by tile and return the
+// bounding boxes of connected changed tiles (enlarged by 'margin')
+////////////////////////////////////////////////////////////////////////////////////
+void CircleTracker::findChangedRegions(const cv::Mat &edges, const int margin, std::vector<cv::Rect> *regions)
+{
+    int rows = edges.rows;
+    int cols = edges.cols;
+    int tilesX = (cols + tileSize - 1) / tileSize;
+    int tilesY = (rows + tileSize - 1) / tileSize;
+
+    // count changed pixels per tile
+    std::vector<int> count(tilesX * tilesY, 0);
+    for (int r = 0; r < rows; ++r)
+    {
+        const uchar *pEdges = edges.ptr<uchar>(r);
+        const uchar *pPrevious = previousEdges.ptr<uchar>(r);
+        int *pCount = &count[(r / tileSize) * tilesX];
+
+        for (int c = 0; c < cols; ++c)
+        {
+            pCount[c / tileSize] += (*pEdges++ != *pPrevious++);
+        }
+    }
+
+    // mark changed tiles
+    int minCount = std::max(1, int(changeRatio * tileSize * tileSize));
+    std::vector<uchar> changed(tilesX * tilesY, 0);
+    changedTiles = 0;
+    for (size_t i = 0; i < count.size(); ++i)
+    {
+        if (count[i] >= minCount)
+        {
+            changed[i] = 1;
+            ++changedTiles;
+        }
+    }
+
+    // group connected tiles (4-neighborhood) and get their bounding boxes
+    cv::Rect image(0, 0, cols, rows);
+    std::vector<int> stack;
+    for (int i = 0; i < tilesX * tilesY; ++i)
+    {
+        if (!changed[i])
+            continue;
+
+        int xMin = i % tilesX, xMax = xMin;
+        int yMin = i / tilesX, yMax = yMin;
+        changed[i] = 0;
+        stack.push_back(i);
+        while (!stack.empty())
+        {
+            int tile = stack.back();
+            stack.pop_back();
+            int x = tile % tilesX;
+            int y = tile / tilesX;
+            xMin = std::min(xMin, x);
+            xMax = std::max(xMax, x);
+            yMin = std::min(yMin, y);
+            yMax = std::max(yMax, y);
+
+            if (x > 0 && changed[tile - 1]) { changed[tile - 1] = 0; stack.push_back(tile - 1); }
+            if (x < tilesX - 1 && changed[tile + 1]) { changed[tile + 1] = 0; stack.push_back(tile + 1); }
+            if (y > 0 && changed[tile - tilesX]) { changed[tile - tilesX] = 0; stack.push_back(tile - tilesX); }
+            if (y < tilesY - 1 && changed[tile + tilesX]) { changed[tile + tilesX] = 0; stack.push_back(tile + tilesX); }
+        }
+
+        // a circle with its center in the changed area may reach out of it -> add margin
+        cv::Rect region(xMin * tileSize - margin, yMin * tileSize - margin,
+                        (xMax - xMin + 1) * tileSize + 2 * margin, (yMax - yMin + 1) * tileSize + 2 * margin);
+        regions->push_back(region & image);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// find circles in the edge image using the circles of the previous frame
+//
+// - unchanged regions: verify the previous circles by their edge support
+//   (number of edge pixels on the circumference)
+// - changed regions (and circles which lost their support):
+//   Hough transformation of that region only
+//
+// note: if nothing changed, the cost is one comparison per pixel plus
+//       one support check per circle
+////////////////////////////////////////////////////////////////////////////////////
+void CircleTracker::update(Segmentation *segmentation, const cv::Mat &edges, std::vector<CircleItem> *circles,
+                           const int radiusMin, const int radiusMax, const float cellStep,
+                           const float phiStep, const int maxCountPerRadius)
+{
+    circles->clear();
+    verifiedCircles = 0;
+    houghRegions = 0;
+
+    std::vector<cv::Rect> regions;
+    std::vector<int> support; // edge support (at detection) of the circles in the list
+    bool fullDetection = previousEdges.empty() || previousEdges.size() != edges.size() ||
+                         previousRadiusMin != radiusMin || previousRadiusMax != radiusMax;
+    if (fullDetection)
+    {
+        regions.push_back(cv::Rect(0, 0, edges.cols, edges.rows));
+        changedTiles = -1;
+    }
+    else
+    {
+        findChangedRegions(edges, radiusMax, &regions);
+
+        // keep previous circles which are outside of changed regions and still have edge support
+        cv::Rect image(0, 0, edges.cols, edges.rows);
+        for (size_t i = 0; i < previousCircles.size(); ++i)
+        {
+            const CircleItem &circle = previousCircles[i];
+            cv::Rect bounds(circle.x - circle.r, circle.y - circle.r, 2 * circle.r + 1, 2 * circle.r + 1);
+
+            bool inChangedRegion = false;
+            for (auto region : regions)
+            {
+                if ((region & bounds).area() > 0)
+                {
+                    inChangedRegion = true;
+                    break;
+                }
+            }
+            if (inChangedRegion)
+                continue; // will be detected again
+
+            int currentSupport = Segmentation::getCircleSupport(edges, circle.xf, circle.yf, circle.rf, phiStep);
+            if (currentSupport >= supportRatio * previousSupport[i])
+            {
+                circles->push_back(circle);
+                support.push_back(previousSupport[i]);
+                ++verifiedCircles;
+            }
+            else
+            {
+                // circle disappeared or moved only a little -> search again around it
+                int margin = radiusMax;
+                regions.push_back(cv::Rect(circle.x - margin, circle.y - margin, 2 * margin + 1, 2 * margin + 1) & image);
+            }
+        }
+    }
+
+    // Hough transformation of the changed regions
+    size_t keptCircles = circles->size();
+    for (auto region : regions)
+    {
+        if (region.width <= 2 * radiusMin || region.height <= 2 * radiusMin)
+            continue; // no circle fits into the region
+
+        // circles in edge image coordinates
+        ++houghRegions;
+        std::vector<CircleItem> found;
+        segmentation->findCirclesThread(RoiImage(edges).cropLocal(region), &found, radiusMin, radiusMax, cellStep,
+                                        phiStep, maxCountPerRadius);
+
+        for (auto circle : found)
+        {
+            // regions are enlarged by a margin -> a circle may have been kept or found already
+            bool duplicate = false;
+            for (size_t j = 0; j < circles->size(); ++j)
+            {
+                const CircleItem &other = circles->at(j);
+                int dx = circle.x - other.x;
+                int dy = circle.y - other.y;
+                int minDistance = std::max(circle.r, other.r);
+                if (dx * dx + dy * dy < minDistance * minDistance)
+                {
+                    duplicate = true;
+                    if (j >= keptCircles && other.v < circle.v)
+                        circles->at(j) = circle; // better circle in overlapping region
+                    break;
+                }
+            }
+            if (!duplicate)
+                circles->push_back(circle);
+        }
+    }
+
+    // remember this frame
+    edges.copyTo(previousEdges);
+    previousCircles = *circles;
+    for (size_t i = keptCircles; i < circles->size(); ++i)
+    {
+        const CircleItem &circle = circles->at(i);
+        support.push_back(Segmentation::getCircleSupport(edges, circle.xf, circle.yf, circle.rf, phiStep));
+    }
+    previousSupport = support;
+    previousRadiusMin = radiusMin;
+    previousRadiusMax = radiusMax;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// like 'update' for an edge image of a region of interest (frame coordinates)
+////////////////////////////////////////////////////////////////////////////////////
+void CircleTracker::update(Segmentation *segmentation, const RoiImage &edges, std::vector<CircleItem> *circles,
+                           const int radiusMin, const int radiusMax, const float cellStep,
+                           const float phiStep, const int maxCountPerRadius)
+{
+    // the previous circles are stored in edge image coordinates
+    if (edges.origin != previousOrigin)
+        reset();
+    previousOrigin = edges.origin;
+
+    std::vector<CircleItem> found;
+    update(segmentation, edges.mat, &found, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius);
+    Segmentation::shiftCircles(&found, edges.origin);
+    circles->insert(circles->end(), found.begin(), found.end());
+}
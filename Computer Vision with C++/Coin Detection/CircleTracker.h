@@ -0,0 +1,48 @@
+#ifndef CIRCLETRACKER_H
+#define CIRCLETRACKER_H
+
+#include <opencv2/core/core.hpp>
+#include "../Core/Segmentation.h"
+
+class CircleTracker
+{
+public:
+    CircleTracker();
+    ~CircleTracker();
+
+    // find circles in the current edge image, but run the Hough transformation
+    // only in regions that changed since the last frame
+    void update(Segmentation *segmentation, const cv::Mat &edges, std::vector<CircleItem> *circles,
+                const int radiusMin, const int radiusMax, const float cellStep,
+                const float phiStep, const int maxCountPerRadius);
+    void reset();
+
+    // region of interest: circles in frame coordinates, a moved region forces a full detection
+    void update(Segmentation *segmentation, const RoiImage &edges, std::vector<CircleItem> *circles,
+                const int radiusMin, const int radiusMax, const float cellStep,
+                const float phiStep, const int maxCountPerRadius);
+
+    // values
+    int tileSize = 32; // px
+    float changeRatio = 0.02f; // a tile changed if more than this part of its pixels changed
+    float supportRatio = 0.7f; // a circle is kept if it has this part of its original edge support
+
+    // statistics of the last update
+    int changedTiles = 0;
+    int verifiedCircles = 0;
+    int houghRegions = 0;
+
+private:
+    void findChangedRegions(const cv::Mat &edges, const int margin, std::vector<cv::Rect> *regions);
+
+    cv::Mat previousEdges;
+    std::vector<CircleItem> previousCircles;
+    std::vector<int> previousSupport; // edge support of the previous circles (at detection)
+
+    // parameters of the previous detection (a change forces a full detection)
+    int previousRadiusMin = -1;
+    int previousRadiusMax = -1;
+    cv::Point previousOrigin;
+};
+
+#endif /* CIRCLETRACKER_H */
@@ -1,83 +1,121 @@
 #include <iostream>
 #include <algorithm>
+#include <math.h>
+#include <thread>
+#include <functional>
 #include "Coin.h"
 
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 
 ////////////////////////////////////////////////////////////////////////////////////
 // constructor and destructor
 ////////////////////////////////////////////////////////////////////////////////////
 Coin::Coin()
 {
-    // add Euro coins to list (sorted by diameter)
-    CoinPrototype *coin;
-
-    // 1 Euro Cent
-    coin = new CoinPrototype();
-    coin->value = 0.01;
-    coin->diameter = 16.25;
-    coin->colorCore = CoinColor::Bronze;
-    coin->colorRing = CoinColor::Bronze;
-    coinList.push_back(*coin);
-
-    // 2 Euro Cent
-    coin = new CoinPrototype();
-    coin->value = 0.02;
-    coin->diameter = 18.75;
-    coin->colorCore = CoinColor::Bronze;
-    coin->colorRing = CoinColor::Bronze;
-    coinList.push_back(*coin);
-
-    // 10 Euro Cent
-    coin = new CoinPrototype();
-    coin->value = 0.10;
-    coin->diameter = 19.75;
-    coin->colorCore = CoinColor::Gold;
-    coin->colorRing = CoinColor::Gold;
-    coinList.push_back(*coin);
-
-    // 5 Euro Cent
-    coin = new CoinPrototype();
-    coin->value = 0.05;
-    coin->diameter = 21.25;
-    coin->colorCore = CoinColor::Bronze;
-    coin->colorRing = CoinColor::Bronze;
-    coinList.push_back(*coin);
-
-    // 20 Euro Cent
-    coin = new CoinPrototype();
-    coin->value = 0.20;
-    coin->diameter = 22.25;
-    coin->colorCore = CoinColor::Gold;
-    coin->colorRing = CoinColor::Gold;
-    coinList.push_back(*coin);
-
-    // 1 Euro 
-    coin = new CoinPrototype();
-    coin->value = 1.00;
-    coin->diameter = 23.25;
-    coin->colorCore = CoinColor::Silver;
-    coin->colorRing = CoinColor::Gold;
-    coinList.push_back(*coin);
-
-    // 50 Euro Cent
-    coin = new CoinPrototype();
-    coin->value = 0.50;
-    coin->diameter = 24.25;
-    coin->colorCore = CoinColor::Gold;
-    coin->colorRing = CoinColor::Gold;
-    coinList.push_back(*coin);
-
-    // 2 Euro 
-    coin = new CoinPrototype();
-    coin->value = 2.00;
-    coin->diameter = 25.75;
-    coin->colorCore = CoinColor::Gold;
-    coin->colorRing = CoinColor::Silver;
-    coinList.push_back(*coin);
+    // Euro coins (sorted by diameter)
+    setCoinDefinitions("EUR", euroCoins, euroCoinCount, 1.00);
 }
 
 Coin::~Coin(){}
 
+////////////////////////////////////////////////////////////////////////////////////
+// set the coins which can be detected (sorted by diameter), the coin with the value
+// 'referenceValue' is used for the calibration
+////////////////////////////////////////////////////////////////////////////////////
+void Coin::setCoinDefinitions(const std::string &currency, const CoinDefinition *definitions, const int count,
+                              const double referenceValue)
+{
+    coinList.clear();
+    for (int i = 0; i < count; ++i)
+    {
+        CoinPrototype coin;
+        coin.value = definitions[i].value;
+        coin.diameter = definitions[i].diameter;
+        coin.colorRing = definitions[i].colorRing;
+        coin.colorCore = definitions[i].colorCore;
+        coin.radius = 0;
+        coin.radiusSubpixel = 0.0f;
+        coinList.push_back(coin);
+    }
+    std::sort(coinList.begin(), coinList.end(),
+              [](const CoinPrototype &a, const CoinPrototype &b) { return a.diameter < b.diameter; });
+
+    this->currency = currency;
+    referenceCoinValue = referenceValue;
+
+    // not calibrated for these coins
+    coinLookup.clear();
+    lookupBins = 0;
+    this->referenceValue = 0.0;
+    referenceRadius = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// read the coin definitions from a file (see Coin.h)
+////////////////////////////////////////////////////////////////////////////////////
+bool Coin::loadCoinDefinitions(const std::string &fileName)
+{
+    cv::FileStorage fs;
+    try
+    {
+        if (!fs.open(fileName, cv::FileStorage::READ))
+        {
+            std::cout << "Unable to open coin definitions '" << fileName << "'\n";
+            return false;
+        }
+    }
+    catch (const cv::Exception &)
+    {
+        std::cout << "Coin definitions '" << fileName << "' are corrupt.\n";
+        return false;
+    }
+
+    std::string newCurrency;
+    double reference = 0.0;
+    fs["currency"] >> newCurrency;
+    fs["reference"] >> reference;
+
+    std::vector<CoinDefinition> definitions;
+    bool referenceFound = false;
+    cv::FileNode coins = fs["coins"];
+    for (size_t i = 0; i < coins.size(); ++i)
+    {
+        cv::FileNode node = coins[int(i)];
+        CoinDefinition definition;
+        std::string ring, core;
+        node["value"] >> definition.value;
+        node["diameter"] >> definition.diameter;
+        node["ring"] >> ring;
+        node["core"] >> core;
+        definition.colorRing = stringToColorName(ring);
+        definition.colorCore = stringToColorName(core);
+        if (definition.value <= 0.0 || definition.diameter <= 0.0 ||
+            definition.colorRing == CoinColor::Unknown || definition.colorCore == CoinColor::Unknown)
+        {
+            std::cout << "Coin definitions '" << fileName << "': invalid coin #" << i << "\n";
+            return false;
+        }
+        referenceFound |= definition.value == reference;
+        definitions.push_back(definition);
+    }
+
+    // the lookup table uses 'signed char' indices
+    if (newCurrency.empty() || definitions.empty() || definitions.size() > 127 || !referenceFound)
+    {
+        std::cout << "Coin definitions '" << fileName << "': currency, coins or reference coin missing.\n";
+        return false;
+    }
+
+    setCoinDefinitions(newCurrency, definitions.data(), int(definitions.size()), reference);
+    std::cout << "Coin definitions loaded: " << definitions.size() << " coins (" << currency << ")\n";
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // convert CoinColor to string
 ////////////////////////////////////////////////////////////////////////////////////
@@ -95,6 +133,17 @@ std::string Coin::colorNameToString(const CoinColor color)
     return "unknown";
 }
 
+CoinColor Coin::stringToColorName(const std::string &name)
+{
+    if (name == "bronze")
+        return CoinColor::Bronze;
+    if (name == "silver")
+        return CoinColor::Silver;
+    if (name == "gold")
+        return CoinColor::Gold;
+    return CoinColor::Unknown;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // show the list of circles
 ////////////////////////////////////////////////////////////////////////////////////
@@ -110,15 +159,59 @@ void Coin::showCirleList(std::vector<CircleItem> *circles)
 
 ////////////////////////////////////////////////////////////////////////////////////
 // we use a 1 Euro coin as reference to get the size (in pixel) and
-// the BGR values of the colors 'gold' and 'silver' from the reference coin
+// the colors 'gold' and 'silver' (color model) from the pixels of the reference coin
 ////////////////////////////////////////////////////////////////////////////////////
-void Coin::setReferenceCoin(cv::Mat image, double value, const int radiusInPixel, const int centerX, const int centerY)
+void Coin::setReferenceCoin(const cv::Mat &image, double value, const int radiusInPixel, const int centerX, const int centerY)
 {
     // set radii (in px) of all euro coins
     setReferenceCoinRadii(value, radiusInPixel);
 
-    // define colors gold and silver based on the colors of the reference coin
-    getCoinColorBGR(image, centerX, centerY, radiusInPixel, referenceGold, referenceSilver);
+    // fit the colors of ring and core of the reference coin
+    std::vector<cv::Point2f> samplesRing, samplesCore;
+    const CoinMaskSpans &spans = getMaskSpans(radiusInPixel);
+    getChromaticitySamples(image, centerX - radiusInPixel, centerY - radiusInPixel, spans.ring, &samplesRing);
+    getChromaticitySamples(image, centerX - radiusInPixel, centerY - radiusInPixel, spans.core, &samplesCore);
+
+    colorModel.reset();
+    for (const auto &coin : coinList)
+    {
+        if (coin.value != value)
+            continue;
+
+        if (coin.colorRing == coin.colorCore)
+        {
+            // one color: use all pixels
+            samplesRing.insert(samplesRing.end(), samplesCore.begin(), samplesCore.end());
+            colorModel.fit(coin.colorRing, samplesRing);
+        }
+        else
+        {
+            colorModel.fit(coin.colorRing, samplesRing);
+            colorModel.fit(coin.colorCore, samplesCore);
+        }
+        if (coin.colorRing != CoinColor::Bronze && coin.colorCore != CoinColor::Bronze)
+            colorModel.deriveBronzeFromGold();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// rg chromaticity of the (not too dark) pixels of the spans
+// (x, y: top left corner of the coin's bounding box)
+////////////////////////////////////////////////////////////////////////////////////
+void Coin::getChromaticitySamples(const cv::Mat &image, const int x, const int y,
+                                  const std::vector<CoinMaskSpan> &spans, std::vector<cv::Point2f> *samples)
+{
+    for (auto span : spans)
+    {
+        const uchar *pPixel = image.ptr<uchar>(y + span.row) + 3 * (x + span.x0);
+        for (int i = span.x0; i < span.x1; ++i, pPixel += 3)
+        {
+            float sum = float(pPixel[0] + pPixel[1] + pPixel[2]);
+            if (sum < 30.0f)
+                continue; // dark pixels have no reliable color
+            samples->push_back(cv::Point2f(pPixel[2] / sum, pPixel[1] / sum));
+        }
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -131,7 +224,7 @@ void Coin::setReferenceCoinRadii(double value, const int radiusInPixel)
     radiusMaxPixel = 0;
     
     // get reference coin from coinList
-    for (auto coinRef : coinList) 
+    for (const auto &coinRef : coinList)
     {
         if (coinRef.value == value)
         {
@@ -141,180 +234,446 @@ void Coin::setReferenceCoinRadii(double value, const int radiusInPixel)
             for (size_t i = 0; i < coinList.size(); ++i)
             {
                 CoinPrototype *coin = &coinList[i];
-                coin->radius = round(rDouble / refRadius * (coin->diameter / 2.0));
+                coin->radiusSubpixel = rDouble / refRadius * (coin->diameter / 2.0);
+                coin->radius = round(coin->radiusSubpixel);
                 if (radiusMinPixel > coin->radius)
                     radiusMinPixel = coin->radius;
                 if (radiusMaxPixel < coin->radius)
                     radiusMaxPixel = coin->radius;
 
-                std::cout << "\tcoin\tvalue=" << coin->value << " EUR\tradius=" << coin->radius << " px\n";
+                std::cout << "\tcoin\tvalue=" << coin->value << " " << currency << "\tradius=" << coin->radius << " px\n";
             }
 
+            buildLookupTable();
+
             // add tolerance
             radiusMinPixel -= radiusTolerance;
             radiusMaxPixel += radiusTolerance;
 
             if (radiusMinPixel > 0 && radiusMaxPixel > radiusMinPixel)
+            {
+                referenceValue = value;
+                referenceRadius = radiusInPixel;
                 return; // no error
+            }
         }
     }
 
     // some error(s) occured
-    std::cout << "Error: Reference coin (value=" << value << ") is not in coin list or detected radius is invalid.\n";
+    std::cout << "Error: Reference coin (value=" << value << " " << currency
+              << ") is not in coin list or detected radius is invalid.\n";
     exit(-1);
 }
 
+////////////////////////////////////////////////////////////////////////////////////
+// lookup table radius bin x (ring, core) -> coin
+//
+// every bin (1/radiusBinsPerPixel px) gets the coin whose radius is closest to the
+// center of the bin (within the tolerance), so 'getValue' needs no search
+////////////////////////////////////////////////////////////////////////////////////
+void Coin::buildLookupTable()
+{
+    float radiusMax = 0.0f;
+    for (const auto &coin : coinList)
+    {
+        radiusMax = std::max(radiusMax, coin.radiusSubpixel);
+    }
+    lookupBins = int(ceil((radiusMax + radiusToleranceSubpixel) * radiusBinsPerPixel)) + 1;
+
+    const int pairs = colorCount * colorCount;
+    coinLookup.assign(lookupBins * pairs, -1);
+    std::vector<float> bestDiff(lookupBins * pairs, radiusToleranceSubpixel);
+
+    for (size_t i = 0; i < coinList.size(); ++i)
+    {
+        const CoinPrototype &coin = coinList[i];
+        int pair = colorPairIndex(coin.colorRing, coin.colorCore);
+        int binStart = std::max(0, int(floor((coin.radiusSubpixel - radiusToleranceSubpixel) * radiusBinsPerPixel)));
+        int binEnd = std::min(lookupBins - 1, int(ceil((coin.radiusSubpixel + radiusToleranceSubpixel) * radiusBinsPerPixel)));
+        for (int bin = binStart; bin <= binEnd; ++bin)
+        {
+            // more than one coin may fit, therefore, use the coin which fits best
+            float diff = fabs(float(bin) / radiusBinsPerPixel - coin.radiusSubpixel);
+            int index = bin * pairs + pair;
+            if (diff <= bestDiff[index])
+            {
+                bestDiff[index] = diff;
+                coinLookup[index] = (signed char)i;
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// write the calibration (reference coin and its colors) to a file
+////////////////////////////////////////////////////////////////////////////////////
+void Coin::writeCalibration(cv::FileStorage &fs)
+{
+    fs << "currency" << currency;
+    fs << "reference_value" << referenceValue;
+    fs << "reference_radius" << referenceRadius;
+    colorModel.write(fs);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// read the calibration written by 'writeCalibration'
+//
+// returns false if the file contains no calibration
+////////////////////////////////////////////////////////////////////////////////////
+bool Coin::readCalibration(const cv::FileStorage &fs)
+{
+    double value = 0.0;
+    int radius = 0;
+    fs["reference_value"] >> value;
+    fs["reference_radius"] >> radius;
+    if (value <= 0.0 || radius < 1)
+        return false;
+
+    // calibration for other coins?
+    std::string storedCurrency;
+    fs["currency"] >> storedCurrency;
+    if (storedCurrency != currency || std::none_of(coinList.begin(), coinList.end(),
+                                                   [value](const CoinPrototype &coin) { return coin.value == value; }))
+    {
+        std::cout << "Calibration is for other coins (" << storedCurrency << ", reference " << value << ").\n";
+        return false;
+    }
+
+    // the smallest coin must keep a radius > 0 with the tolerance (else setReferenceCoinRadii exits)
+    double referenceDiameter = 0.0, minDiameter = 1e9;
+    for (const auto &coin : coinList)
+    {
+        if (coin.value == value)
+            referenceDiameter = coin.diameter;
+        minDiameter = std::min(minDiameter, coin.diameter);
+    }
+    if (round(double(radius) / referenceDiameter * minDiameter) - radiusTolerance < 1)
+    {
+        std::cout << "Calibration has an invalid reference radius (" << radius << " px).\n";
+        return false;
+    }
+
+    ColorModel model;
+    if (!model.read(fs))
+        return false;
+
+    // set radii (in px) of all euro coins
+    setReferenceCoinRadii(value, radius);
+    colorModel = model;
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // get the coin value in Euro (or 0 if it is not a Euro coin)
 ////////////////////////////////////////////////////////////////////////////////////
-double Coin::getCoinValue(cv::Mat image, const int circleX, const int circleY, const int circleR)
+double Coin::getCoinValue(const cv::Mat &image, const float circleX, const float circleY, const float circleR)
+{
+    CoinColor colorRing, colorCore;
+    float ring[3], core[3];
+    return classify(image, circleX, circleY, circleR, &colorRing, &colorCore, ring, core);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// get the coin value in Euro and the colors of ring and core
+////////////////////////////////////////////////////////////////////////////////////
+double Coin::classify(const cv::Mat &image, const float circleX, const float circleY, const float circleR,
+                      CoinColor *colorRing, CoinColor *colorCore, float *ring, float *core)
 {
+    *colorRing = CoinColor::Unknown;
+    *colorCore = CoinColor::Unknown;
+    std::fill(ring, ring + 3, 0.0f);
+    std::fill(core, core + 3, 0.0f);
+
+    // the color masks use full pixels
+    int x = cvRound(circleX);
+    int y = cvRound(circleY);
+    int r = cvRound(circleR);
+
     // coin (partially) not in image?
-    if (circleX < circleR || circleY < circleR || image.cols < circleX + circleR || image.rows < circleY + circleR)
+    if (x < r || y < r || image.cols < x + r || image.rows < y + r)
         return 0.0;
 
     // get colors (ring and core)
-    float ring[3];
-    float core[3];
-    getCoinColorBGR(image, circleX, circleY, circleR, ring, core);
+    getCoinColorBGR(image, x, y, r, ring, core);
+    *colorRing = colorModel.classify(ring[0], ring[1], ring[2]);
+    *colorCore = colorModel.classify(core[0], core[1], core[2]);
 
     // compare colors and radius with coins in list and return the value in Euro
-    return getValue(circleR, getCoinColorName(ring[0], ring[1], ring[2]), getCoinColorName(core[0], core[1], core[2]));
+    return getValue(circleR, *colorRing, *colorCore);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
-// get the color values (BGR) of the coin's ring and core
+// classify the circles [begin, end) (for the threads of 'classifyAll')
+////////////////////////////////////////////////////////////////////////////////////
+void Coin::classifyRange(Coin *coin, const cv::Mat &image, const std::vector<CircleItem> &circles,
+                         CoinClassification *result, const size_t begin, const size_t end)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        const CircleItem &circle = circles[i];
+        result->values[i] = coin->classify(image, circle.xf, circle.yf, circle.rf,
+                                           &result->colorsRing[i], &result->colorsCore[i],
+                                           &result->bgrRing[i][0], &result->bgrCore[i][0]);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// get values and colors of all circles (image coordinates) of a frame
+//
+// note: the circles are split among up to 4 threads, the masks are created
+//       before the threads start, so the threads only read shared data
+////////////////////////////////////////////////////////////////////////////////////
+CoinClassification Coin::classifyAll(const cv::Mat &image, const std::vector<CircleItem> &circles,
+                                     const bool adaptColors)
+{
+    size_t count = circles.size();
+
+    CoinClassification result;
+    result.values.resize(count);
+    result.colorsRing.resize(count);
+    result.colorsCore.resize(count);
+    result.bgrRing.resize(count);
+    result.bgrCore.resize(count);
+
+    // create all masks (not thread safe)
+    for (const auto &circle : circles)
+    {
+        getMaskSpans(cvRound(circle.rf));
+    }
+
+    // starting threads costs more than classifying a few coins
+    const size_t minCoinsPerThread = 4;
+    size_t threadCount = std::min<size_t>(4, count / minCoinsPerThread);
+    if (threadCount < 2)
+    {
+        classifyRange(this, image, circles, &result, 0, count);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            size_t begin = count * t / threadCount;
+            size_t end = count * (t + 1) / threadCount;
+            threads.push_back(std::thread(classifyRange, this, std::cref(image), std::cref(circles), &result, begin, end));
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    // follow the colors of the found coins (after the threads: they read the color model)
+    if (adaptColors)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (result.values[i] <= 0.0)
+                continue; // only coins which fit in size and colors
+            const cv::Vec3f &ring = result.bgrRing[i];
+            const cv::Vec3f &core = result.bgrCore[i];
+            colorModel.update(result.colorsRing[i], ring[0], ring[1], ring[2], colorAdaptRate);
+            colorModel.update(result.colorsCore[i], core[0], core[1], core[2], colorAdaptRate);
+        }
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// get the masks for the ring and the core of a coin with radius 'circleR'
 //
 // note:
-// - a cirlce was found: center (circleX, circleY), radius 'circleR'
-// - the radius is not a sufficient criterion to decide which coins was found
 // - a Euro coin has eigher 1 or 2 (ring and core) colors
 // - 1 and 2 euro coins: max. core radius about 72% of the max. coin radius
-// - we create a mask for the ring, overlay it with the color image and every
-//   pixel that fits to the mask is used to get the BGR color of the ring or core
+// - the masks are drawn once per radius and stored as spans (row, x0, x1),
+//   a pixel which is in both masks belongs to the core
 ////////////////////////////////////////////////////////////////////////////////////
-void Coin::getCoinColorBGR(cv::Mat image, const int circleX, const int circleY, const int circleR, float *ringF, float *coreF)
+const CoinMaskSpans &Coin::getMaskSpans(const int circleR)
 {
-    unsigned long int ring[3] = { 0, 0, 0 };
-    unsigned long int core[3] = { 0, 0, 0 };
+    auto cached = maskCache.find(circleR);
+    if (cached != maskCache.end())
+        return cached->second;
+
     cv::Scalar colorWhite = cv::Scalar(255, 255, 255);
-    
+
     int thickness = 1 + cvRound(float(circleR) * 0.05f); // thickness >= 1
     int radiusRing = cvRound(float(circleR) * 0.86f) - thickness;
     int radiusCore = cvRound(float(circleR) * 0.36f) - thickness;
     int diameter = circleR * 2;
 
-    // use part of the main image where the reference coin was found
-    cv::Mat imgCoin = image(cv::Rect(circleX - circleR, circleY - circleR, diameter, diameter));
-
     // create masks for ring and core
     cv::Mat maskRing = cv::Mat::zeros(cv::Size(diameter, diameter), CV_8U);
     cv::Mat maskCore = cv::Mat::zeros(cv::Size(diameter, diameter), CV_8U);
     cv::circle(maskRing, cv::Point(circleR, circleR), radiusRing, colorWhite, thickness);
     cv::circle(maskCore, cv::Point(circleR, circleR), radiusCore, colorWhite, thickness);
 
+    // run-length encoding of the masks
+    CoinMaskSpans &spans = maskCache[circleR];
     for (int row = 0; row < diameter; ++row)
     {
-        const uchar *pImage = imgCoin.ptr<uchar>(row);
         const uchar *pMaskRing = maskRing.ptr<uchar>(row);
         const uchar *pMaskCore = maskCore.ptr<uchar>(row);
 
-        for (int col = 0; col < diameter; ++col)
+        int ringStart = -1;
+        int coreStart = -1;
+        for (int col = 0; col <= diameter; ++col)
         {
-            // check every pixel if it is in the mask
-            if (*pMaskCore)
-            {
-                core[0] += *pImage++;
-                core[1] += *pImage++;
-                core[2] += *pImage++;
-            }
-            else if (*pMaskRing)
+            bool core = col < diameter && pMaskCore[col];
+            bool ring = col < diameter && pMaskRing[col] && !core;
+
+            if (core && coreStart < 0)
+                coreStart = col;
+            if (!core && coreStart >= 0)
             {
-                ring[0] += *pImage++;
-                ring[1] += *pImage++;
-                ring[2] += *pImage++;
+                spans.core.push_back({ row, coreStart, col });
+                coreStart = -1;
             }
-            else
+
+            if (ring && ringStart < 0)
+                ringStart = col;
+            if (!ring && ringStart >= 0)
             {
-                pImage += 3;
+                spans.ring.push_back({ row, ringStart, col });
+                ringStart = -1;
             }
-            pMaskCore++;
-            pMaskRing++;
         }
     }
-
-    // scale BGR values to [0, 1]
-    float sum = float(ring[0] + ring[1] + ring[2]);
-    ringF[0] = float(ring[0]) / sum;
-    ringF[1] = float(ring[1]) / sum;
-    ringF[2] = float(ring[2]) / sum;
-
-    sum = float(core[0] + core[1] + core[2]);
-    coreF[0] = float(core[0]) / sum;
-    coreF[1] = float(core[1]) / sum;
-    coreF[2] = float(core[2]) / sum;
+    return spans;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
-// estimate pre-defined color based on the BGR values
+// add the BGR values of 'count' consecutive pixels to sum[0..2]
 ////////////////////////////////////////////////////////////////////////////////////
-CoinColor Coin::getCoinColorName(const float b, const float g, const float r)
+void Coin::sumSpanBGR(const uchar *pImage, const int count, unsigned long int *sum)
 {
-    float max = std::max({ b, g, r });
-    float min = std::min({ b, g, r });
-    
-    //
-    // color calibration (color depend on the image number)
-    //
-    float refMin = imageNo > 11 ? 0.29 : 0.31;
-    float refMax = imageNo > 11 ? 0.37 : 0.35;
-    
-    if (min > refMin && max < refMax)
-        return CoinColor::Silver;
+    unsigned long int b = 0, g = 0, r = 0;
+    int i = 0;
 
-    if (g < b || r < g || b < 0.05)
-        return CoinColor::Unknown;
-
-    if (r - g > g - b)
-        return CoinColor::Bronze;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    // 8 pixels per step (the 16 bit sums are flushed after 32 steps: 32 * 255 < 2^16)
+    while (i + 8 <= count)
+    {
+        uint16x8_t sumB = vdupq_n_u16(0);
+        uint16x8_t sumG = vdupq_n_u16(0);
+        uint16x8_t sumR = vdupq_n_u16(0);
+        for (int block = 0; block < 32 && i + 8 <= count; ++block, i += 8)
+        {
+            uint8x8x3_t bgr = vld3_u8(pImage + 3 * i);
+            sumB = vaddw_u8(sumB, bgr.val[0]);
+            sumG = vaddw_u8(sumG, bgr.val[1]);
+            sumR = vaddw_u8(sumR, bgr.val[2]);
+        }
+        uint64x2_t b64 = vpaddlq_u32(vpaddlq_u16(sumB));
+        uint64x2_t g64 = vpaddlq_u32(vpaddlq_u16(sumG));
+        uint64x2_t r64 = vpaddlq_u32(vpaddlq_u16(sumR));
+        b += vgetq_lane_u64(b64, 0) + vgetq_lane_u64(b64, 1);
+        g += vgetq_lane_u64(g64, 0) + vgetq_lane_u64(g64, 1);
+        r += vgetq_lane_u64(r64, 0) + vgetq_lane_u64(r64, 1);
+    }
+#elif defined(__SSE2__)
+    // 16 pixels (= 48 bytes = 3 registers) per step:
+    // byte j of register k belongs to channel (16 * k + j) % 3 -> mask the channel and sum the bytes
+    static const __m128i channelMask[3][3] = { // [channel][register]
+        { _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1),
+          _mm_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0),
+          _mm_setr_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0) },
+        { _mm_setr_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0),
+          _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1),
+          _mm_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0) },
+        { _mm_setr_epi8(0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0),
+          _mm_setr_epi8(0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0),
+          _mm_setr_epi8(-1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1, 0, 0, -1) } };
+
+    __m128i zero = _mm_setzero_si128();
+    __m128i sumB = zero, sumG = zero, sumR = zero;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i *pBlock = (const __m128i *) (pImage + 3 * i);
+        for (int k = 0; k < 3; ++k)
+        {
+            __m128i bytes = _mm_loadu_si128(pBlock + k);
+            sumB = _mm_add_epi64(sumB, _mm_sad_epu8(_mm_and_si128(bytes, channelMask[0][k]), zero));
+            sumG = _mm_add_epi64(sumG, _mm_sad_epu8(_mm_and_si128(bytes, channelMask[1][k]), zero));
+            sumR = _mm_add_epi64(sumR, _mm_sad_epu8(_mm_and_si128(bytes, channelMask[2][k]), zero));
+        }
+    }
+    unsigned long long lanes[2];
+    _mm_storeu_si128((__m128i *) lanes, sumB);
+    b += lanes[0] + lanes[1];
+    _mm_storeu_si128((__m128i *) lanes, sumG);
+    g += lanes[0] + lanes[1];
+    _mm_storeu_si128((__m128i *) lanes, sumR);
+    r += lanes[0] + lanes[1];
+#endif
+
+    // remaining pixels
+    for (const uchar *pPixel = pImage + 3 * i; i < count; ++i)
+    {
+        b += *pPixel++;
+        g += *pPixel++;
+        r += *pPixel++;
+    }
 
-    return CoinColor::Gold;
+    sum[0] += b;
+    sum[1] += g;
+    sum[2] += r;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
-// returns the value in Euro
+// get the color values (BGR) of the coin's ring and core
 //
-// input: radius, color of the ring, color of the core
+// note:
+// - a cirlce was found: center (circleX, circleY), radius 'circleR'
+// - the radius is not a sufficient criterion to decide which coins was found
+// - the pixels of the ring and the core are given by the (cached) masks of the radius
+//   and are summed span by span, no pixel outside of the masks is read
 ////////////////////////////////////////////////////////////////////////////////////
-double Coin::getValue(const int radius, const CoinColor colorRing, const CoinColor colorCore)
+void Coin::getCoinColorBGR(const cv::Mat &image, const int circleX, const int circleY, const int circleR, float *ringF, float *coreF)
 {
-    // radius tolerance
-    int rMin = radius - radiusTolerance;
-    int rMax = radius + radiusTolerance;
+    unsigned long int ring[3] = { 0, 0, 0 };
+    unsigned long int core[3] = { 0, 0, 0 };
+
+    const CoinMaskSpans &spans = getMaskSpans(circleR);
 
-    int bestDiff = rMax; // huge number
-    double bestValue = 0.0;
+    // top left corner of the coin's bounding box
+    int x = circleX - circleR;
+    int y = circleY - circleR;
 
-    // find the coin in the list based on the radius (+/- tolerance) and the colors (ring/core)
-    for (auto coin : coinList)
+    for (auto span : spans.ring)
     {
-        // coinList is sorted by increasing radius
-        if (coin.radius > rMax)
-            break; // radius in list is already grater then the searched one -> stop searching
+        sumSpanBGR(image.ptr<uchar>(y + span.row) + 3 * (x + span.x0), span.x1 - span.x0, ring);
+    }
+    for (auto span : spans.core)
+    {
+        sumSpanBGR(image.ptr<uchar>(y + span.row) + 3 * (x + span.x0), span.x1 - span.x0, core);
+    }
 
-        if (coin.radius < rMin || coin.colorRing != colorRing || coin.colorCore != colorCore)
-            continue; // radius is to small or colors does not match
+    // scale BGR values to [0, 1]
+    float sum = float(ring[0] + ring[1] + ring[2]);
+    ringF[0] = float(ring[0]) / sum;
+    ringF[1] = float(ring[1]) / sum;
+    ringF[2] = float(ring[2]) / sum;
 
-        // more than one coin may fulfil the above criteria,
-        // therefore, use the coin which fits best
-        int diff = radius > coin.radius ? radius - coin.radius : coin.radius - radius;
-        if (diff < bestDiff)
-        {
-            bestDiff = diff;
-            bestValue = coin.value;
-        }
-    }
-    return bestValue > 0.0 ? bestValue : -radius;
+    sum = float(core[0] + core[1] + core[2]);
+    coreF[0] = float(core[0]) / sum;
+    coreF[1] = float(core[1]) / sum;
+    coreF[2] = float(core[2]) / sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// returns the value (in units of the currency), or 0 if no coin fits
+//
+// input: radius (sub-pixel), color of the ring, color of the core
+////////////////////////////////////////////////////////////////////////////////////
+double Coin::getValue(const float radius, const CoinColor colorRing, const CoinColor colorCore)
+{
+    // coin with matching radius (+/- tolerance) and colors (ring/core)
+    int bin = cvRound(radius * radiusBinsPerPixel);
+    if (bin < 0 || bin >= lookupBins)
+        return 0.0;
+
+    int index = coinLookup[bin * colorCount * colorCount + colorPairIndex(colorRing, colorCore)];
+    return index >= 0 ? coinList[index].value : 0.0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////
@@ -371,11 +730,3 @@ void Coin::removeOverlappingCircles(std::vector<CircleItem> *circles)
         }
     }
 }
-
-////////////////////////////////////////////////////////////////////////////////////
-// number of the image
-////////////////////////////////////////////////////////////////////////////////////
-void Coin::setImageNo(int no)
-{
-    imageNo = no;
-}
@@ -1,27 +1,77 @@
 #ifndef COIN_H
 #define COIN_H
 
+#include <map>
+#include <string>
 #include <opencv2/core/core.hpp>
-#include "Segmentation.h"
+#include "../Core/Segmentation.h"
+#include "ColorModel.h"
 
-enum class CoinColor
+// definition of a coin (constexpr tables below or loaded from a file)
+struct CoinDefinition
 {
-    Bronze,
-    Silver,
-    Gold,
-    Unknown
+    double value;    // in units of the currency
+    double diameter; // mm
+    CoinColor colorRing;
+    CoinColor colorCore;
 };
 
+// Euro coins (sorted by diameter)
+constexpr CoinDefinition euroCoins[] = {
+    { 0.01, 16.25, CoinColor::Bronze, CoinColor::Bronze },
+    { 0.02, 18.75, CoinColor::Bronze, CoinColor::Bronze },
+    { 0.10, 19.75, CoinColor::Gold, CoinColor::Gold },
+    { 0.05, 21.25, CoinColor::Bronze, CoinColor::Bronze },
+    { 0.20, 22.25, CoinColor::Gold, CoinColor::Gold },
+    { 1.00, 23.25, CoinColor::Gold, CoinColor::Silver },
+    { 0.50, 24.25, CoinColor::Gold, CoinColor::Gold },
+    { 2.00, 25.75, CoinColor::Silver, CoinColor::Gold }
+};
+constexpr int euroCoinCount = sizeof(euroCoins) / sizeof(euroCoins[0]);
+
+// index of a (ring, core) color pair in the lookup table of 'Coin'
+constexpr int colorCount = int(CoinColor::Unknown) + 1;
+constexpr int colorPairIndex(const CoinColor colorRing, const CoinColor colorCore)
+{
+    return int(colorRing) * colorCount + int(colorCore);
+}
+
 struct CoinPrototype
 {
-    // definition of Euro coins
-    double value; // Euro
+    // definition of the coin
+    double value; // in units of the currency
     double diameter; // mm
     CoinColor colorRing;
     CoinColor colorCore;
 
     // calculated values (depend on the calibration)
     int radius; // pixel
+    float radiusSubpixel; // pixel (not rounded)
+};
+
+// pixels x0 ... x1-1 in a row of a mask (coordinates relative to the coin's bounding box)
+struct CoinMaskSpan
+{
+    int row;
+    int x0;
+    int x1;
+};
+
+// run-length encoded masks for the ring and the core of a coin (depend only on the radius)
+struct CoinMaskSpans
+{
+    std::vector<CoinMaskSpan> ring;
+    std::vector<CoinMaskSpan> core;
+};
+
+// classification of all circles of a frame (same order as the circles)
+struct CoinClassification
+{
+    std::vector<double> values; // Euro (or 0 if it is not a Euro coin)
+    std::vector<CoinColor> colorsRing;
+    std::vector<CoinColor> colorsCore;
+    std::vector<cv::Vec3f> bgrRing; // normalized (b + g + r = 1)
+    std::vector<cv::Vec3f> bgrCore;
 };
 
 class Coin
@@ -30,36 +80,79 @@ public:
     Coin();
     ~Coin();
 
+    // coins which can be detected (replaces the Euro coins, needs a new calibration)
+    void setCoinDefinitions(const std::string &currency, const CoinDefinition *definitions, const int count,
+                            const double referenceValue);
+
+    // coin definitions from a file (cv::FileStorage, e.g. YAML):
+    //   currency: "EUR"
+    //   reference: 1.0   (value of the coin which is used for the calibration)
+    //   coins: [ { value: 0.01, diameter: 16.25, ring: "bronze", core: "bronze" }, ... ]
+    bool loadCoinDefinitions(const std::string &fileName);
+
     // fuctions that may help for debugging
     std::string colorNameToString(const CoinColor color);
+    static CoinColor stringToColorName(const std::string &name);
     void showCirleList(std::vector<CircleItem> *circles);
 
     // functions for coin detections
-    double getCoinValue(cv::Mat image, const int circleX, const int circleY, const int circleR);
+    double getCoinValue(const cv::Mat &image, const float circleX, const float circleY, const float circleR);
+    // adaptColors: the color model follows the colors of the found coins (lighting drift)
+    CoinClassification classifyAll(const cv::Mat &image, const std::vector<CircleItem> &circles,
+                                   const bool adaptColors = false);
     void removeOverlappingCircles(std::vector<CircleItem> *circles);
-    void setImageNo(int no);
-    void setReferenceCoin(cv::Mat image, double value, const int radiusInPixel, const int centerX, const int centerY);
+    void setReferenceCoin(const cv::Mat &image, double value, const int radiusInPixel, const int centerX, const int centerY);
     void setReferenceCoinRadii(double value, const int radiusInPixel);
 
+    // store the calibration (reference coin)
+    void writeCalibration(cv::FileStorage &fs);
+    bool readCalibration(const cv::FileStorage &fs);
+
     // values
     int radiusMinPixel = 0;
     int radiusMaxPixel = 0;
 
+    // currency of the coin definitions and value of the coin used for the calibration
+    std::string currency = "EUR";
+    double referenceCoinValue = 1.00;
+
 private:
-    void getCoinColorBGR(cv::Mat image, const int circleX, const int circleY, const int circleR, float *ringF, float *coreF);
-    CoinColor getCoinColorName(const float b, const float g, const float r);
-    double getValue(const int radius, const CoinColor colorRing, const CoinColor colorCore);
+    void getCoinColorBGR(const cv::Mat &image, const int circleX, const int circleY, const int circleR, float *ringF, float *coreF);
+    void getChromaticitySamples(const cv::Mat &image, const int circleX, const int circleY,
+                                const std::vector<CoinMaskSpan> &spans, std::vector<cv::Point2f> *samples);
+    double classify(const cv::Mat &image, const float circleX, const float circleY, const float circleR,
+                    CoinColor *colorRing, CoinColor *colorCore, float *bgrRing, float *bgrCore);
+    static void classifyRange(Coin *coin, const cv::Mat &image, const std::vector<CircleItem> &circles,
+                              CoinClassification *result, const size_t begin, const size_t end);
+    const CoinMaskSpans &getMaskSpans(const int circleR);
+    static void sumSpanBGR(const uchar *pImage, const int count, unsigned long int *sum);
+    double getValue(const float radius, const CoinColor colorRing, const CoinColor colorCore);
+    void buildLookupTable();
+
+    std::vector<CoinPrototype> coinList; // list of all coins, sorted by radius
 
-    std::vector<CoinPrototype> coinList; // list of all Euro coins, sorted by radius
+    // lookup table: [radius bin][colorPairIndex(ring, core)] -> index in coinList (-1: no coin)
+    // (built by the calibration, the coin which fits best for the center of the bin)
+    static const int radiusBinsPerPixel = 4;
+    std::vector<signed char> coinLookup;
+    int lookupBins = 0;
 
-    // BGR color values picked from the reference coin
-    float referenceGold[3];
-    float referenceSilver[3];
+    // masks for getCoinColorBGR (key: radius)
+    std::map<int, CoinMaskSpans> maskCache;
+
+    // reference coin (set by the calibration)
+    double referenceValue = 0.0;
+    int referenceRadius = 0; // px
+
+    // colors (fitted from the pixels of the reference coin)
+    ColorModel colorModel;
+    float colorAdaptRate = 0.02f; // weight of a found coin in 'classifyAll' with 'adaptColors'
 
     // radii are rough rounded -> we need a tolerance of some pixel
     int radiusTolerance = 2; // px
-    
-    int imageNo = 0;
+
+    // sub-pixel refined radii are compared with a smaller tolerance
+    float radiusToleranceSubpixel = 1.0f; // px
 };
 
 #endif /* COIN_H */
@@ -0,0 +1,415 @@
+#include <iostream>
+#include <thread>
+#include <functional>
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "CoinDetector.h"
+
+
+////////////////////////////////////////////////////////////////////////////////////
+// constructor and destructor
+////////////////////////////////////////////////////////////////////////////////////
+CoinDetector::CoinDetector()
+{
+    threshold = new Threshold();
+    pointOperations = new PointOperations();
+    filter = new Filter();
+    morphology = new Morphology();
+    segmentation = new Segmentation();
+    tracker = new CircleTracker();
+
+    // 16 bit accumulators: half the memory, the same circles (the cells of the coin
+    // radii get far fewer than 65535 votes)
+    segmentation->accumulatorType = AccumulatorType::UInt16;
+}
+
+CoinDetector::~CoinDetector()
+{
+    delete threshold;
+    delete pointOperations;
+    delete filter;
+    delete morphology;
+    delete segmentation;
+    delete tracker;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// prepare a view of the input image for the circle detection
+//
+// grayscale -> brightness -> contrast -> blur (Gaussian, median or bilateral) -> edges (threshold -> erode -> substract)
+// or: grayscale -> brightness -> contrast -> Canny (blur, gradient, suppression, hysteresis)
+//
+// note: every operator returns only the pixels it computed (e.g. the convolution
+//       crops the edges) together with their position, so the edge image needs
+//       no border handling and its origin is its position in the input image
+////////////////////////////////////////////////////////////////////////////////////
+void CoinDetector::prepare(const RoiImage &view, const CoinSettings &settings, RoiImage &imgBlur,
+                           RoiImage &imgEdges, EdgePoints *points, PrepareBuffers *buffers)
+{
+    //
+    // streaming: the whole chain row by row without full-frame intermediates
+    //
+    // (not for the recursive Gaussian: its vertical pass runs backwards from the last row)
+    if (settings.streamEdges && !settings.canny && settings.smoothing == Smoothing::Gaussian &&
+        !Filter::useRecursiveGaussian(settings.blurSigma, settings.blurKernelSize) &&
+        buffers->stream.run(view, settings.brightness, settings.contrast, settings.blurKernelHorizontal,
+                            settings.blurKernelVertical, settings.edgeThreshold, morphology->getKernelFull(3),
+                            &imgBlur, imgEdges, points))
+        return;
+
+    //
+    // convert to grayscale
+    //
+    cv::cvtColor(view.mat, buffers->gray.mat, cv::COLOR_BGR2GRAY);
+    buffers->gray.origin = view.origin;
+
+    //
+    // adjust brightness and contrast
+    //
+    // (in place, no extra buffers)
+    pointOperations->adjustBrightness(buffers->gray, buffers->gray, settings.brightness);
+    pointOperations->adjustContrast(buffers->gray, buffers->gray, settings.contrast);
+
+    //
+    // Canny: the blur is part of its gradient, the prepared grayscale image is not blurred
+    //
+    if (settings.canny)
+    {
+        RoiImage::reuseBuffer(imgBlur.mat, buffers->gray.mat.size(), CV_8U);
+        buffers->gray.mat.copyTo(imgBlur.mat);
+        imgBlur.origin = buffers->gray.origin;
+
+        buffers->canny.detect(buffers->gray, imgEdges, settings.cannyLow, settings.cannyHigh, points,
+                              settings.useThreads ? 4 : 1);
+        return;
+    }
+
+    //
+    // blur
+    //
+    if (settings.smoothing == Smoothing::Median)
+    {
+        // edge-preserving, uchar -> uchar (no cropped edges)
+        filter->median(buffers->gray, imgBlur, std::max(1, settings.blurKernelSize / 2),
+                       settings.useThreads ? 4 : 1);
+    }
+    else if (settings.smoothing == Smoothing::Bilateral)
+    {
+        filter->bilateral(buffers->gray, imgBlur, std::max(settings.blurSigma, 0.5),
+                          settings.bilateralSigmaRange, settings.useThreads ? 4 : 1);
+    }
+    else
+    {
+        // convloution uses float -> convert to float
+        buffers->gray.mat.convertTo(buffers->grayFloat.mat, CV_32F);
+        buffers->grayFloat.origin = buffers->gray.origin;
+
+        // 2x convolution with 1D kernel (cropped edges are removed), for a large sigma the recursive Gaussian
+        filter->gaussianBlur(buffers->grayFloat, buffers->blurVertical, buffers->blurHorizontal,
+                             settings.blurKernelHorizontal, settings.blurKernelVertical, settings.blurSigma);
+
+        // convert back to uchar
+        buffers->blurVertical.mat.convertTo(imgBlur.mat, CV_8U);
+        imgBlur.origin = buffers->blurVertical.origin;
+    }
+
+    //
+    // edge detection (threshold -> erode -> substract)
+    //
+    threshold->loop_ptr2(imgBlur, buffers->thresh, settings.edgeThreshold);
+    morphology->erode(buffers->thresh, buffers->eroded, morphology->getKernelFull(3));
+    morphology->subtract(buffers->thresh, imgEdges, buffers->eroded, points);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// find circles with the method selected in the settings
+////////////////////////////////////////////////////////////////////////////////////
+void CoinDetector::findCircles(const RoiImage &edges, const EdgePoints *points, const CoinSettings &settings,
+                               const bool useTracker, std::vector<CircleItem> *circles)
+{
+    if (settings.tracking && useTracker)
+    {
+        tracker->update(segmentation, edges, circles, settings.radiusMin, settings.radiusMax,
+                        settings.cellStep, settings.phiStep, settings.maxCountPerRadius);
+        return;
+    }
+
+    // edge pixels of the edge extraction -> the edge image is not scanned again
+    if (points)
+    {
+        std::vector<CircleItem> found;
+        if (settings.pyramidLevels > 0)
+            segmentation->findCirclesPyramid(*points, &found, settings.radiusMin, settings.radiusMax,
+                                             settings.cellStep, settings.phiStep, settings.maxCountPerRadius,
+                                             settings.pyramidLevels);
+        else if (!settings.useThreads)
+            segmentation->findCircles(*points, &found, settings.radiusMin, settings.radiusMax,
+                                      settings.cellStep, settings.phiStep, settings.maxCountPerRadius);
+        else
+            segmentation->findCirclesThread(*points, &found, settings.radiusMin, settings.radiusMax,
+                                            settings.cellStep, settings.phiStep, settings.maxCountPerRadius);
+
+        Segmentation::shiftCircles(&found, points->origin);
+        circles->insert(circles->end(), found.begin(), found.end());
+    }
+    else if (settings.pyramidLevels > 0)
+        segmentation->findCirclesPyramid(edges, circles, settings.radiusMin, settings.radiusMax,
+                                         settings.cellStep, settings.phiStep, settings.maxCountPerRadius,
+                                         settings.pyramidLevels);
+    else if (!settings.useThreads)
+        segmentation->findCircles(edges, circles, settings.radiusMin, settings.radiusMax,
+                                  settings.cellStep, settings.phiStep, settings.maxCountPerRadius);
+    else
+        segmentation->findCirclesThread(edges, circles, settings.radiusMin, settings.radiusMax,
+                                        settings.cellStep, settings.phiStep, settings.maxCountPerRadius);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// prepare the camera image of a frame (grayscale, blur and edge image)
+//
+// note: the extra views are prepared in threads (one per extra view)
+////////////////////////////////////////////////////////////////////////////////////
+void CoinDetector::prepareFrame(CoinFrame *frame)
+{
+    const CoinSettings &settings = frame->settings;
+    cv::Rect image(0, 0, frame->input.cols, frame->input.rows);
+
+    // buffers are resized before the threads start
+    size_t extraCount = settings.extraViews.size();
+    buffers.resize(1 + extraCount);
+    frame->extraEdges.resize(extraCount);
+    frame->extraEdgePoints.resize(extraCount);
+
+    std::vector<RoiImage> extraBlur(extraCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < extraCount; ++i)
+    {
+        // (too small for the blur and the edge detection?)
+        cv::Rect extraView = settings.extraViews[i] & image;
+        if (extraView.width < settings.blurKernelSize + 4 || extraView.height < settings.blurKernelSize + 4)
+        {
+            frame->extraEdges[i] = RoiImage();
+            frame->extraEdgePoints[i].reset(cv::Size(0, 0));
+            continue;
+        }
+
+        RoiImage view = RoiImage::of(frame->input, extraView);
+        threads.push_back(std::thread(&CoinDetector::prepare, this, view, std::cref(settings), std::ref(extraBlur[i]),
+                                      std::ref(frame->extraEdges[i]), &frame->extraEdgePoints[i], &buffers[1 + i]));
+    }
+
+    prepare(RoiImage::of(frame->input, settings.view), settings, frame->blur, frame->edges, &frame->edgePoints,
+            &buffers[0]);
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// find the circles of one view (frame coordinates)
+//
+// note: if the coin detection is calibrated, overlapping circles are removed
+//       and the circles are refined to sub-pixel accuracy
+////////////////////////////////////////////////////////////////////////////////////
+void CoinDetector::detectRegion(const RoiImage &edges, const EdgePoints *points, const CoinSettings &settings,
+                                const bool useTracker, Coin *coin, std::vector<CircleItem> *circles)
+{
+    findCircles(edges, points, settings, useTracker, circles);
+
+    if (settings.calibrated)
+    {
+        coin->removeOverlappingCircles(circles);
+
+        // sub-pixel center and radius (the coin radii differ by only 1-2 px)
+        segmentation->refineCircles(edges, circles, settings.cellStep, settings.phiStep, true);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// find the circles of a frame (camera image coordinates)
+//
+// note: the extra views are processed in threads (one per extra view)
+////////////////////////////////////////////////////////////////////////////////////
+void CoinDetector::detectFrame(CoinFrame *frame, Coin *coin)
+{
+    frame->circles.clear();
+    if (!frame->settings.enableHough)
+        return;
+
+    const CoinSettings &settings = frame->settings;
+    size_t extraCount = frame->extraEdges.size();
+    std::vector<std::vector<CircleItem>> extraCircles(extraCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < extraCount; ++i)
+    {
+        if (frame->extraEdges[i].empty())
+            continue;
+        threads.push_back(std::thread(&CoinDetector::detectRegion, this, std::cref(frame->extraEdges[i]),
+                                      &frame->extraEdgePoints[i], std::cref(settings), false, coin,
+                                      &extraCircles[i]));
+    }
+
+    detectRegion(frame->edges, &frame->edgePoints, settings, true, coin, &frame->circles);
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    for (const auto &circles : extraCircles)
+    {
+        frame->circles.insert(frame->circles.end(), circles.begin(), circles.end());
+    }
+
+    // views may overlap
+    if (settings.calibrated && extraCount > 0)
+        coin->removeOverlappingCircles(&frame->circles);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// write the settings of the image preparation and the circle detection to a file
+////////////////////////////////////////////////////////////////////////////////////
+void writeSettings(cv::FileStorage &fs, const CoinSettings &settings)
+{
+    fs << "view_x" << settings.view.x;
+    fs << "view_y" << settings.view.y;
+    fs << "view_width" << settings.view.width;
+    fs << "view_height" << settings.view.height;
+    fs << "brightness" << settings.brightness;
+    fs << "contrast" << settings.contrast;
+    fs << "blur_kernel_size" << settings.blurKernelSize;
+    fs << "blur_sigma" << settings.blurSigma;
+    fs << "edge_threshold" << settings.edgeThreshold;
+    fs << "canny" << int(settings.canny);
+    fs << "canny_low" << settings.cannyLow;
+    fs << "canny_high" << settings.cannyHigh;
+    fs << "smoothing" << int(settings.smoothing);
+    fs << "bilateral_sigma_range" << settings.bilateralSigmaRange;
+    fs << "cell_step" << settings.cellStep;
+    fs << "phi_step" << settings.phiStep;
+    fs << "radius_min" << settings.radiusMin;
+    fs << "radius_max" << settings.radiusMax;
+    fs << "max_count_per_radius" << settings.maxCountPerRadius;
+    fs << "pyramid_levels" << settings.pyramidLevels;
+
+    // extra views: x, y, width, height of every view
+    std::vector<int> extraViews;
+    for (auto view : settings.extraViews)
+    {
+        extraViews.insert(extraViews.end(), { view.x, view.y, view.width, view.height });
+    }
+    fs << "extra_views" << extraViews;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// read the settings written by 'writeSettings' (and create the blur kernels)
+////////////////////////////////////////////////////////////////////////////////////
+void readSettings(const cv::FileStorage &fs, CoinSettings *settings)
+{
+    int x = 0, y = 0, width = 0, height = 0;
+    fs["view_x"] >> x;
+    fs["view_y"] >> y;
+    fs["view_width"] >> width;
+    fs["view_height"] >> height;
+    settings->view = cv::Rect(x, y, width, height);
+
+    fs["brightness"] >> settings->brightness;
+    fs["contrast"] >> settings->contrast;
+    fs["blur_kernel_size"] >> settings->blurKernelSize;
+    fs["blur_sigma"] >> settings->blurSigma;
+    fs["edge_threshold"] >> settings->edgeThreshold;
+    if (!fs["canny"].empty()) // (not in older files)
+    {
+        int canny = 0;
+        fs["canny"] >> canny;
+        settings->canny = canny != 0;
+        fs["canny_low"] >> settings->cannyLow;
+        fs["canny_high"] >> settings->cannyHigh;
+    }
+    if (!fs["smoothing"].empty()) // (not in older files)
+    {
+        int smoothing = 0;
+        fs["smoothing"] >> smoothing;
+        settings->smoothing = Smoothing(smoothing);
+        fs["bilateral_sigma_range"] >> settings->bilateralSigmaRange;
+    }
+    fs["cell_step"] >> settings->cellStep;
+    fs["phi_step"] >> settings->phiStep;
+    fs["radius_min"] >> settings->radiusMin;
+    fs["radius_max"] >> settings->radiusMax;
+    fs["max_count_per_radius"] >> settings->maxCountPerRadius;
+    fs["pyramid_levels"] >> settings->pyramidLevels;
+
+    std::vector<int> extraViews;
+    fs["extra_views"] >> extraViews;
+    settings->extraViews.clear();
+    for (size_t i = 0; i + 3 < extraViews.size(); i += 4)
+    {
+        settings->extraViews.push_back(cv::Rect(extraViews[i], extraViews[i + 1], extraViews[i + 2], extraViews[i + 3]));
+    }
+
+    Filter filter;
+    filter.setGaussianKernels1D(settings->blurKernelHorizontal, settings->blurKernelVertical,
+                                settings->blurKernelSize, settings->blurSigma);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// write settings and reference coin to a calibration file
+////////////////////////////////////////////////////////////////////////////////////
+bool saveCalibrationFile(const std::string &fileName, const CoinSettings &settings, Coin *coin)
+{
+    cv::FileStorage fs(fileName, cv::FileStorage::WRITE);
+    if (!fs.isOpened())
+    {
+        std::cout << "Unable to write calibration file '" << fileName << "'\n";
+        return false;
+    }
+    fs << "calibration_version" << calibrationFileVersion;
+    writeSettings(fs, settings);
+    coin->writeCalibration(fs);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// read a calibration file written by 'saveCalibrationFile'
+//
+// returns false (settings and coin unchanged) if the file is missing, has another
+// version or contains no reference coin
+////////////////////////////////////////////////////////////////////////////////////
+bool loadCalibrationFile(const std::string &fileName, CoinSettings *settings, Coin *coin)
+{
+    cv::FileStorage fs;
+    try
+    {
+        if (!fs.open(fileName, cv::FileStorage::READ))
+            return false;
+    }
+    catch (const cv::Exception &)
+    {
+        std::cout << "Calibration file '" << fileName << "' is corrupt.\n";
+        return false;
+    }
+
+    int version = 0;
+    fs["calibration_version"] >> version;
+    if (version != calibrationFileVersion)
+    {
+        std::cout << "Calibration file '" << fileName << "' has version " << version << ", expected "
+                  << calibrationFileVersion << " -> ignored.\n";
+        return false;
+    }
+
+    CoinSettings newSettings = *settings;
+    readSettings(fs, &newSettings);
+    if (!coin->readCalibration(fs))
+    {
+        std::cout << "Calibration file '" << fileName << "' contains no reference coin.\n";
+        return false;
+    }
+    *settings = newSettings;
+    settings->calibrated = true;
+    return true;
+}
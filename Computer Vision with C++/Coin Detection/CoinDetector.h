@@ -0,0 +1,146 @@
+#ifndef COINDETECTOR_H
+#define COINDETECTOR_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+#include "../Core/Threshold.h"
+#include "../Core/PointOperations.h"
+#include "../Core/Filter.h"
+#include "../Core/Morphology.h"
+#include "../Core/Segmentation.h"
+#include "../Core/Canny.h"
+#include "CircleTracker.h"
+#include "Coin.h"
+#include "../Core/RoiImage.h"
+#include "EdgeStream.h"
+
+// smoothing of the grayscale image before the edge detection
+enum class Smoothing
+{
+    Gaussian, // blur kernels (or the recursive Gaussian for a large sigma)
+    Median,   // radius: blur kernel size / 2 (edge-preserving)
+    Bilateral // sigma space: blur sigma, sigma range: bilateralSigmaRange (edge-preserving)
+};
+
+// all values which control the coin detection (trackbars, calibration, view)
+struct CoinSettings
+{
+    // view (area in which coins are detected)
+    cv::Rect view;
+
+    // more (disjoint) areas in which coins are detected, processed in parallel with the view
+    std::vector<cv::Rect> extraViews;
+
+    // preparation of the grayscale image
+    int brightness = 0;
+    float contrast = 1.0f;
+    cv::Mat blurKernelHorizontal, blurKernelVertical;
+    int blurKernelSize = 1;
+    double blurSigma = 0.0;
+    int edgeThreshold = 90;
+    bool streamEdges = true; // edge image row by row (EdgeStream), same result as the operators
+    Smoothing smoothing = Smoothing::Gaussian; // (the median and bilateral filter are not streamed)
+    float bilateralSigmaRange = 30.0f;
+
+    // Canny edge detector instead of threshold -> erode -> subtract
+    // (blur kernel and edge threshold are not used, thresholds of the gradient magnitude)
+    bool canny = false;
+    int cannyLow = 40;
+    int cannyHigh = 100;
+
+    // Hough Transformation for circles
+    float cellStep = 1.0f;
+    float phiStep = 1.0f;
+    int radiusMin = 15;
+    int radiusMax = 40;
+    int maxCountPerRadius = 5;
+    int pyramidLevels = 0;
+    bool useThreads = true;
+    bool tracking = false;
+
+    // state of the program
+    bool enableHough = false;
+    bool calibrated = false;
+    bool adaptColors = false; // color model follows the colors of the found coins
+    int imageNo = 0;
+};
+
+// a frame and all results of the coin detection
+struct CoinFrame
+{
+    long number = 0;
+    CoinSettings settings; // settings used for this frame
+    std::chrono::high_resolution_clock::time_point timeCaptured;
+
+    cv::Mat input;  // camera image (BGR)
+    RoiImage blur;  // prepared grayscale image of the view
+    RoiImage edges; // edge image of the view
+    std::vector<RoiImage> extraEdges; // edge images of the extra views
+    EdgePoints edgePoints; // edge pixels of the view (for the Hough transformation)
+    std::vector<EdgePoints> extraEdgePoints; // edge pixels of the extra views
+
+    std::vector<CircleItem> circles; // camera image coordinates
+    CoinClassification coins; // only if calibrated
+};
+
+// store the settings which are needed to process images like the interactive program
+void writeSettings(cv::FileStorage &fs, const CoinSettings &settings);
+void readSettings(const cv::FileStorage &fs, CoinSettings *settings);
+
+// calibration file: settings + reference coin, rejected if the version does not match
+// (increase the version if the meaning of a stored value changes)
+const int calibrationFileVersion = 2;
+bool saveCalibrationFile(const std::string &fileName, const CoinSettings &settings, Coin *coin);
+bool loadCalibrationFile(const std::string &fileName, CoinSettings *settings, Coin *coin);
+
+class CoinDetector
+{
+public:
+    CoinDetector();
+    ~CoinDetector();
+
+    // intermediate images of 'prepare' (one set per view, so views can be prepared in parallel)
+    // one buffer per step, allocated by the first frame and reused by the following
+    // frames (the operators write into the existing buffers)
+    struct PrepareBuffers
+    {
+        RoiImage gray, grayFloat, blurHorizontal, blurVertical, thresh, eroded;
+        EdgeStream stream; // ring buffers of the streaming version
+        Canny canny;       // buffers of the bands of the Canny edge detector
+    };
+
+    // view of the input image -> prepared grayscale image -> edge image (and its edge pixels)
+    // (the origins of the outputs are their positions in the input image)
+    void prepare(const RoiImage &view, const CoinSettings &settings, RoiImage &imgBlur,
+                 RoiImage &imgEdges, EdgePoints *points, PrepareBuffers *buffers);
+
+    // find circles in the edge image (frame coordinates)
+    // points: edge pixels of the edge image (the image is scanned if nullptr)
+    // useTracker: the tracker can follow only one view
+    void findCircles(const RoiImage &edges, const EdgePoints *points, const CoinSettings &settings,
+                     const bool useTracker, std::vector<CircleItem> *circles);
+
+    // steps of the coin detection for a whole frame
+    void prepareFrame(CoinFrame *frame);
+    void detectFrame(CoinFrame *frame, Coin *coin);
+
+    Segmentation *segmentation;
+    CircleTracker *tracker;
+
+private:
+    void detectRegion(const RoiImage &edges, const EdgePoints *points, const CoinSettings &settings,
+                      const bool useTracker, Coin *coin, std::vector<CircleItem> *circles);
+
+    Threshold *threshold;
+    PointOperations *pointOperations;
+    Filter *filter;
+    Morphology *morphology;
+
+    // intermediate images (index 0: view, 1...: extra views)
+    std::vector<PrepareBuffers> buffers;
+};
+
+#endif /* COINDETECTOR_H */
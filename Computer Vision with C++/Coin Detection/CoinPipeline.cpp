@@ -0,0 +1,211 @@
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#include "CoinPipeline.h"
+
+
+////////////////////////////////////////////////////////////////////////////////////
+// constructor and destructor
+////////////////////////////////////////////////////////////////////////////////////
+CoinPipeline::CoinPipeline(Coin *coin, cv::VideoCapture *capture, ImageSource *images, const size_t queueCapacity)
+    : coin(coin), capture(capture), images(images), capturedQueue(queueCapacity), preparedQueue(queueCapacity),
+      detectedQueue(queueCapacity), classifiedQueue(queueCapacity)
+{
+    detector = new CoinDetector();
+}
+
+CoinPipeline::~CoinPipeline()
+{
+    stop();
+    delete detector;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// start and stop the threads of all stages
+////////////////////////////////////////////////////////////////////////////////////
+void CoinPipeline::start()
+{
+    if (running)
+        return;
+
+    running = true;
+    threads.push_back(std::thread(&CoinPipeline::captureStage, this));
+    threads.push_back(std::thread(&CoinPipeline::prepareStage, this));
+    threads.push_back(std::thread(&CoinPipeline::detectStage, this));
+    threads.push_back(std::thread(&CoinPipeline::classifyStage, this));
+}
+
+void CoinPipeline::stop()
+{
+    running = false;
+    capturedQueue.wakeAll();
+    preparedQueue.wakeAll();
+    detectedQueue.wakeAll();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// settings (trackbars, calibration, ...) are changed in the main thread
+// and copied to every frame when it is captured
+////////////////////////////////////////////////////////////////////////////////////
+void CoinPipeline::setSettings(const CoinSettings &newSettings)
+{
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    settings = newSettings;
+}
+
+bool CoinPipeline::tryGetFrame(CoinFrame &frame)
+{
+    if (!classifiedQueue.tryPop(frame))
+        return false;
+
+    presentStatistics.addLatency(frame.timeCaptured);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// helper functions for the stages
+////////////////////////////////////////////////////////////////////////////////////
+
+// wait for the next frame (returns false if the pipeline was stopped)
+bool CoinPipeline::waitAndPop(BoundedQueue<CoinFrame> *queue, CoinFrame &frame)
+{
+    return queue->waitPop(frame, running);
+}
+
+// pass the frame to the next stage or drop it (backpressure)
+void CoinPipeline::pushOrDrop(BoundedQueue<CoinFrame> *queue, CoinFrame &frame, StageStatistics *statistics)
+{
+    if (!queue->tryPush(frame))
+        ++statistics->dropped;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// stage 1: read a frame from the camera or from a file
+////////////////////////////////////////////////////////////////////////////////////
+void CoinPipeline::captureStage()
+{
+    long number = 0;
+    while (running)
+    {
+        // image files are always available -> do not read frames which would be dropped
+        if (!capture)
+        {
+            capturedQueue.waitNotFull(running);
+            if (!running)
+                return;
+        }
+
+        CoinFrame frame;
+        frame.number = number++;
+        frame.timeCaptured = std::chrono::high_resolution_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(settingsMutex);
+            frame.settings = settings;
+        }
+
+        if (capture)
+        {
+            if (!capture->read(frame.input))
+            {
+                std::cout << "Camera: Unable to read frame from camera.\n";
+                captureActive = false;
+                return;
+            }
+        }
+        else
+        {
+            // load image from file (cached)
+            frame.input = images->getImage(frame.settings.imageNo);
+        }
+
+        captureStatistics.addLatency(frame.timeCaptured);
+        pushOrDrop(&capturedQueue, frame, &captureStatistics);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// stage 2: grayscale, blur and edge image
+////////////////////////////////////////////////////////////////////////////////////
+void CoinPipeline::prepareStage()
+{
+    CoinFrame frame;
+    while (waitAndPop(&capturedQueue, frame))
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        detector->prepareFrame(&frame);
+        prepareStatistics.addLatency(start);
+        pushOrDrop(&preparedQueue, frame, &prepareStatistics);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// stage 3: find circles
+////////////////////////////////////////////////////////////////////////////////////
+void CoinPipeline::detectStage()
+{
+    CoinFrame frame;
+    while (waitAndPop(&preparedQueue, frame))
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        detector->detectFrame(&frame, coin);
+        detectStatistics.addLatency(start);
+        pushOrDrop(&detectedQueue, frame, &detectStatistics);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// stage 4: get the values of the coins
+////////////////////////////////////////////////////////////////////////////////////
+void CoinPipeline::classifyStage()
+{
+    CoinFrame frame;
+    while (waitAndPop(&detectedQueue, frame))
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        if (frame.settings.enableHough && frame.settings.calibrated)
+        {
+            std::lock_guard<std::mutex> lock(coinMutex);
+            frame.coins = coin->classifyAll(frame.input, frame.circles, frame.settings.adaptColors);
+        }
+        classifyStatistics.addLatency(start);
+        pushOrDrop(&classifiedQueue, frame, &classifyStatistics);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// statistics as text: queue depth (input queue of the stage), average time
+// per frame and number of dropped frames
+////////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string> CoinPipeline::getStatisticsText()
+{
+    struct
+    {
+        const char *name;
+        StageStatistics *statistics;
+        BoundedQueue<CoinFrame> *queue;
+    } stages[] = { { "capture", &captureStatistics, nullptr },
+                   { "prepare", &prepareStatistics, &capturedQueue },
+                   { "detect", &detectStatistics, &preparedQueue },
+                   { "classify", &classifyStatistics, &detectedQueue },
+                   { "total", &presentStatistics, &classifiedQueue } };
+
+    std::vector<std::string> lines;
+    for (auto stage : stages)
+    {
+        std::stringstream text;
+        text << std::fixed << std::setprecision(1);
+        text << stage.name << ": queue=" << (stage.queue ? stage.queue->size() : 0)
+             << "  " << float(stage.statistics->averageMicroseconds) / 1000.0f << " ms"
+             << "  dropped=" << stage.statistics->dropped;
+        lines.push_back(text.str());
+    }
+    if (!capture)
+        lines.push_back(images->getStatisticsText());
+    return lines;
+}
@@ -0,0 +1,73 @@
+#ifndef COINPIPELINE_H
+#define COINPIPELINE_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "Pipeline.h"
+#include "CoinDetector.h"
+#include "Coin.h"
+#include "ImageSource.h"
+
+////////////////////////////////////////////////////////////////////////////////////
+// coin detection as pipeline: every stage runs in its own thread
+//
+// capture -> preparation -> circle detection -> classification -> (presentation)
+//
+// the stages are connected by bounded queues, a stage drops its frame if the
+// queue to the next stage is full, the last queue is read by 'tryGetFrame'
+// (presentation in the main thread, because of the OpenCV windows)
+////////////////////////////////////////////////////////////////////////////////////
+class CoinPipeline
+{
+public:
+    // capture: camera (if not nullptr) or image files (cached by 'images')
+    CoinPipeline(Coin *coin, cv::VideoCapture *capture, ImageSource *images, const size_t queueCapacity = 2);
+    ~CoinPipeline();
+
+    void start();
+    void stop();
+
+    // settings for the next captured frames
+    void setSettings(const CoinSettings &settings);
+
+    // get the next processed frame (returns false if there is none yet)
+    bool tryGetFrame(CoinFrame &frame);
+
+    // queue depths and latencies of all stages (one line per stage)
+    std::vector<std::string> getStatisticsText();
+
+    // lock this while changing the coin calibration (the classification stage uses the coin)
+    std::mutex coinMutex;
+
+    // false if the camera does not deliver frames anymore
+    std::atomic<bool> captureActive{true};
+
+private:
+    void captureStage();
+    void prepareStage();
+    void detectStage();
+    void classifyStage();
+    bool waitAndPop(BoundedQueue<CoinFrame> *queue, CoinFrame &frame);
+    void pushOrDrop(BoundedQueue<CoinFrame> *queue, CoinFrame &frame, StageStatistics *statistics);
+
+    Coin *coin;
+    cv::VideoCapture *capture;
+    ImageSource *images;
+    CoinDetector *detector;
+
+    std::mutex settingsMutex;
+    CoinSettings settings;
+
+    BoundedQueue<CoinFrame> capturedQueue, preparedQueue, detectedQueue, classifiedQueue;
+    StageStatistics captureStatistics, prepareStatistics, detectStatistics, classifyStatistics;
+    StageStatistics presentStatistics; // latency: capture -> presentation
+
+    std::atomic<bool> running{false};
+    std::vector<std::thread> threads;
+};
+
+#endif /* COINPIPELINE_H */
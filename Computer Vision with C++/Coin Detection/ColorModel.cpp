@@ -0,0 +1,176 @@
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+
+#include "ColorModel.h"
+
+// the variance of a color is never smaller than this (e.g. after many updates)
+static const float minVariance = 1e-5f;
+
+ColorModel::ColorModel()
+{
+    reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// default Gaussians
+////////////////////////////////////////////////////////////////////////////////////
+void ColorModel::reset()
+{
+    const float defaultMean[3][2] = { { 0.46f, 0.32f },   // bronze
+                                      { 0.34f, 0.335f },  // silver
+                                      { 0.42f, 0.36f } }; // gold
+    for (int c = 0; c < 3; ++c)
+    {
+        gaussians[c].meanR = defaultMean[c][0];
+        gaussians[c].meanG = defaultMean[c][1];
+        setCovariance(&gaussians[c], 0.0004f, 0.0f, 0.0004f); // sigma = 0.02
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// covariance and its inverse
+////////////////////////////////////////////////////////////////////////////////////
+void ColorModel::setCovariance(Gaussian *gaussian, const float covRR, const float covRG, const float covGG)
+{
+    gaussian->covRR = std::max(covRR, minVariance);
+    gaussian->covGG = std::max(covGG, minVariance);
+
+    // keep the matrix positive definite (|correlation| < 0.99)
+    float limit = 0.99f * sqrt(gaussian->covRR * gaussian->covGG);
+    gaussian->covRG = std::max(-limit, std::min(limit, covRG));
+
+    float det = gaussian->covRR * gaussian->covGG - gaussian->covRG * gaussian->covRG;
+    gaussian->invRR = gaussian->covGG / det;
+    gaussian->invRG = -gaussian->covRG / det;
+    gaussian->invGG = gaussian->covRR / det;
+    gaussian->logDet = log(det);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// mean and covariance of the samples
+////////////////////////////////////////////////////////////////////////////////////
+bool ColorModel::fit(const CoinColor color, const std::vector<cv::Point2f> &samples)
+{
+    if (color == CoinColor::Unknown || samples.size() < 10)
+        return false;
+
+    double sumR = 0.0, sumG = 0.0;
+    for (const auto &sample : samples)
+    {
+        sumR += sample.x;
+        sumG += sample.y;
+    }
+    double meanR = sumR / samples.size();
+    double meanG = sumG / samples.size();
+
+    double covRR = 0.0, covRG = 0.0, covGG = 0.0;
+    for (const auto &sample : samples)
+    {
+        double dr = sample.x - meanR;
+        double dg = sample.y - meanG;
+        covRR += dr * dr;
+        covRG += dr * dg;
+        covGG += dg * dg;
+    }
+
+    Gaussian *gaussian = &gaussians[int(color)];
+    gaussian->meanR = float(meanR);
+    gaussian->meanG = float(meanG);
+    setCovariance(gaussian, float(covRR / samples.size()), float(covRG / samples.size()), float(covGG / samples.size()));
+    return true;
+}
+
+void ColorModel::deriveBronzeFromGold()
+{
+    const Gaussian &gold = gaussians[int(CoinColor::Gold)];
+    Gaussian *bronze = &gaussians[int(CoinColor::Bronze)];
+    *bronze = gold;
+    bronze->meanR = gold.meanR + 0.04f;
+    bronze->meanG = gold.meanG - 0.04f;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// most likely color (equal priors): min. of Mahalanobis distance + log(det(covariance))
+//
+// note: no branches, the loop is unrolled by the compiler and the selection uses
+//       conditional moves
+////////////////////////////////////////////////////////////////////////////////////
+CoinColor ColorModel::classify(const float b, const float g, const float r) const
+{
+    float sum = b + g + r;
+    float chromaR = r / sum;
+    float chromaG = g / sum;
+
+    float distance[3], score[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        const Gaussian &gaussian = gaussians[c];
+        float dr = chromaR - gaussian.meanR;
+        float dg = chromaG - gaussian.meanG;
+        distance[c] = gaussian.invRR * dr * dr + 2.0f * gaussian.invRG * dr * dg + gaussian.invGG * dg * dg;
+        score[c] = distance[c] + gaussian.logDet;
+    }
+
+    int best = score[1] < score[0] ? 1 : 0;
+    best = score[2] < score[best] ? 2 : best;
+
+    // NaN (black pixels only) is never <= max. distance
+    return distance[best] <= maxDistanceSquared ? CoinColor(best) : CoinColor::Unknown;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// exponential moving average of mean and covariance
+////////////////////////////////////////////////////////////////////////////////////
+void ColorModel::update(const CoinColor color, const float b, const float g, const float r, const float rate)
+{
+    float sum = b + g + r;
+    if (color == CoinColor::Unknown || !(sum > 0.0f))
+        return;
+
+    Gaussian *gaussian = &gaussians[int(color)];
+    float dr = r / sum - gaussian->meanR;
+    float dg = g / sum - gaussian->meanG;
+    gaussian->meanR += rate * dr;
+    gaussian->meanG += rate * dg;
+    setCovariance(gaussian, (1.0f - rate) * gaussian->covRR + rate * dr * dr,
+                  (1.0f - rate) * gaussian->covRG + rate * dr * dg,
+                  (1.0f - rate) * gaussian->covGG + rate * dg * dg);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// store the Gaussians (mean r, mean g, cov rr, cov rg, cov gg per color)
+////////////////////////////////////////////////////////////////////////////////////
+void ColorModel::write(cv::FileStorage &fs) const
+{
+    const char *names[3] = { "color_bronze", "color_silver", "color_gold" };
+    for (int c = 0; c < 3; ++c)
+    {
+        const Gaussian &gaussian = gaussians[c];
+        std::vector<float> values = { gaussian.meanR, gaussian.meanG, gaussian.covRR, gaussian.covRG, gaussian.covGG };
+        fs << names[c] << values;
+    }
+    fs << "color_max_distance" << maxDistanceSquared;
+}
+
+bool ColorModel::read(const cv::FileStorage &fs)
+{
+    const char *names[3] = { "color_bronze", "color_silver", "color_gold" };
+    std::vector<float> values[3];
+    for (int c = 0; c < 3; ++c)
+    {
+        fs[names[c]] >> values[c];
+        if (values[c].size() != 5)
+            return false;
+    }
+
+    for (int c = 0; c < 3; ++c)
+    {
+        gaussians[c].meanR = values[c][0];
+        gaussians[c].meanG = values[c][1];
+        setCovariance(&gaussians[c], values[c][2], values[c][3], values[c][4]);
+    }
+    if (!fs["color_max_distance"].empty())
+        fs["color_max_distance"] >> maxDistanceSquared;
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef COLORMODEL_H
+#define COLORMODEL_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+enum class CoinColor
+{
+    Bronze,
+    Silver,
+    Gold,
+    Unknown
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// colors of coins: one Gaussian per color in rg chromaticity (r = R / (R+G+B), g = G / (R+G+B))
+//
+// - the Gaussians are fitted from the pixels of the reference coin (calibration),
+//   colors without samples keep their default (or are derived from gold, see 'fit')
+// - a color is 'Unknown' if its Mahalanobis distance is too large
+// - 'update' moves a Gaussian towards the colors of classified coins (lighting drift)
+////////////////////////////////////////////////////////////////////////////////////
+class ColorModel
+{
+public:
+    ColorModel();
+
+    // default Gaussians (typical colors of the test images)
+    void reset();
+
+    // fit the Gaussian of a color from samples (x = r, y = g), returns false if there are too few samples
+    bool fit(const CoinColor color, const std::vector<cv::Point2f> &samples);
+
+    // bronze is not part of a 1 Euro coin: derive it from gold (same spread, more red, less green)
+    void deriveBronzeFromGold();
+
+    // color of the normalized BGR values (b + g + r = 1)
+    CoinColor classify(const float b, const float g, const float r) const;
+
+    // move the Gaussian of 'color' towards the given (normalized BGR) color
+    void update(const CoinColor color, const float b, const float g, const float r, const float rate);
+
+    void write(cv::FileStorage &fs) const;
+    bool read(const cv::FileStorage &fs);
+
+    // colors with a larger squared Mahalanobis distance are 'Unknown' (3.5 sigma)
+    float maxDistanceSquared = 12.25f;
+
+private:
+    struct Gaussian
+    {
+        float meanR, meanG;
+        float covRR, covRG, covGG;
+        float invRR, invRG, invGG; // inverse covariance
+        float logDet;              // log(det(covariance))
+    };
+
+    static void setCovariance(Gaussian *gaussian, const float covRR, const float covRG, const float covGG);
+
+    Gaussian gaussians[3]; // index: CoinColor (without Unknown)
+};
+
+#endif /* COLORMODEL_H */
@@ -0,0 +1,238 @@
+#include <iostream>
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "EdgeStream.h"
+
+
+EdgeStream::EdgeStream()
+{}
+
+EdgeStream::~EdgeStream()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////
+// grayscale, brightness, contrast and horizontal blur of one input row
+// (same arithmetic as PointOperations and Filter::convolve_generic_normalized_float_kernel)
+////////////////////////////////////////////////////////////////////////////////////
+void EdgeStream::prepareRow(const cv::Mat &input, const int row, const int brightness, const float contrast,
+                            const cv::Mat &kernelHorizontal, float *output)
+{
+    const uchar center = 127;
+    int cols = input.cols;
+
+    const uchar *pGray = input.ptr<uchar>(row);
+    if (input.channels() == 3)
+    {
+        cv::cvtColor(input.row(row), grayRow, cv::COLOR_BGR2GRAY);
+        pGray = grayRow.ptr<uchar>(0);
+    }
+
+    float *pFloat = floatRow.ptr<float>(0);
+    for (int c = 0; c < cols; ++c)
+    {
+        // brightness
+        int adjusted = *pGray++ + brightness;
+        if (adjusted > 255)
+            adjusted = 255;
+        else if (adjusted < 0)
+            adjusted = 0;
+
+        // contrast
+        float value = contrast*((uchar) adjusted-center)+center;
+        if (value > 255)
+            value = 255;
+        else if (value < 0)
+            value = 0;
+
+        *pFloat++ = (float) (uchar) value;
+    }
+
+    // horizontal blur (cropped edges)
+    int kCols = kernelHorizontal.cols;
+    const float *pKernel = kernelHorizontal.ptr<float>(0);
+    for (int c = 0; c < (cols - kCols + 1); ++c)
+    {
+        const float *pInput = floatRow.ptr<float>(0) + c;
+
+        float result = 0.0f;
+        for (int kc = 0; kc < kCols; ++kc)
+        {
+            result += pInput[kc] * pKernel[kc];
+        }
+        *output++ = result;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// erode and subtract: edge row 'row' from the threshold rows row .. row + kRows - 1
+// (same pixels as Morphology::erode and Morphology::subtract)
+////////////////////////////////////////////////////////////////////////////////////
+void EdgeStream::erodeRow(const int row, const cv::Mat &erodeKernel, const bool fullKernel, uchar *output)
+{
+    int ringRows = thresholdRing.rows;
+    int kRows = erodeKernel.rows;
+    int kCols = erodeKernel.cols;
+    int refPointX = (kCols - 1) / 2;
+    int refPointY = (kRows - 1) / 2;
+    int cols = thresholdRing.cols - kCols;
+
+    const uchar *pCenter = thresholdRing.ptr<uchar>((row + refPointY) % ringRows) + refPointX;
+
+    if (fullKernel)
+    {
+        // the threshold image is binary: erode = minimum of the window,
+        // separated into the minimum of each column and the minimum of kCols columns
+        uchar *pMin = columnMin.ptr<uchar>(0);
+        const uchar *pFirst = thresholdRing.ptr<uchar>(row % ringRows);
+        std::copy(pFirst, pFirst + thresholdRing.cols, pMin);
+        for (int kr = 1; kr < kRows; ++kr)
+        {
+            const uchar *pInput = thresholdRing.ptr<uchar>((row + kr) % ringRows);
+            for (int c = 0; c < thresholdRing.cols; ++c)
+            {
+                pMin[c] = std::min(pMin[c], pInput[c]);
+            }
+        }
+
+        for (int c = 0; c < cols; ++c)
+        {
+            uchar eroded = pMin[c];
+            for (int kc = 1; kc < kCols; ++kc)
+            {
+                eroded = std::min(eroded, pMin[c + kc]);
+            }
+
+            int value = pCenter[c] - eroded;
+            *output++ = value > 0 ? value : 0;
+        }
+        return;
+    }
+
+    for (int c = 0; c < cols; ++c)
+    {
+        bool found = false;
+
+        for (int kr = 0; kr < kRows && !found; ++kr)
+        {
+            const uchar *pInput = thresholdRing.ptr<uchar>((row + kr) % ringRows) + c;
+            const uchar *pKernel = erodeKernel.ptr<uchar>(kr);
+
+            for (int kc = 0; kc < kCols; ++kc)
+            {
+                if (pKernel[kc] > 0 && pInput[kc] == 0)
+                {
+                    found = true;
+                    break;
+                }
+            }
+        }
+
+        int value = pCenter[c] - (found ? 0 : 255);
+        *output++ = value > 0 ? value : 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// push the rows of the view through the chain
+//
+// input row y -> horizontal blur row y -> (if kV rows are available) blur row
+// y - kV + 1 -> threshold row -> (if kE rows are available) edge row
+////////////////////////////////////////////////////////////////////////////////////
+bool EdgeStream::run(const RoiImage &view, const int brightness, const float contrast,
+                     const cv::Mat &kernelHorizontal, const cv::Mat &kernelVertical, const uchar threshold,
+                     const cv::Mat &erodeKernel, RoiImage *imgBlur, RoiImage &imgEdges, EdgePoints *points)
+{
+    if (view.empty() || kernelHorizontal.empty() || kernelVertical.empty() || erodeKernel.empty())
+    {
+        std::cout << "One ore more inputs are empty!" << std::endl;
+        return false;
+    }
+
+    if (kernelHorizontal.rows != 1 || kernelVertical.cols != 1 ||
+        kernelHorizontal.type() != CV_32F || kernelVertical.type() != CV_32F)
+        return false;
+
+    int rows = view.mat.rows;
+    int cols = view.mat.cols;
+    int kH = kernelHorizontal.cols;
+    int kV = kernelVertical.rows;
+    int kRows = erodeKernel.rows;
+    int kCols = erodeKernel.cols;
+
+    // sizes and origins of the cropped outputs (see the borders of the operators)
+    int blurCols = std::max(0, cols - kH + 1);
+    int blurRows = std::max(0, rows - kV + 1);
+    int edgeCols = std::max(0, blurCols - kCols);
+    int edgeRows = std::max(0, blurRows - kRows);
+    cv::Point blurOrigin = view.origin + cv::Point(kH / 2, kV / 2);
+    cv::Point edgeOrigin = blurOrigin + cv::Point((kCols - 1) / 2, (kRows - 1) / 2);
+
+    if (imgBlur)
+    {
+        RoiImage::reuseBuffer(imgBlur->mat, cv::Size(blurCols, blurRows), CV_8U);
+        imgBlur->origin = blurOrigin;
+    }
+    RoiImage::reuseBuffer(imgEdges.mat, cv::Size(edgeCols, edgeRows), CV_8U);
+    imgEdges.origin = edgeOrigin;
+    if (points)
+        points->reset(imgEdges.mat.size(), edgeOrigin);
+
+    if (blurCols == 0 || blurRows == 0)
+        return true;
+
+    bool fullKernel = erodeKernel.type() == CV_8U && cv::countNonZero(erodeKernel) == kRows * kCols;
+
+    floatRow.create(1, cols, CV_32F);
+    horizontalRing.create(kV, blurCols, CV_32F);
+    thresholdRing.create(kRows, blurCols, CV_8U);
+    blurRow.create(1, blurCols, CV_8U);
+    columnMin.create(1, blurCols, CV_8U);
+    verticalRows.resize(kV);
+
+    const float *pKernelVertical = kernelVertical.ptr<float>(0);
+    int kernelStep = (int) (kernelVertical.step / sizeof(float));
+
+    for (int y = 0; y < rows; ++y)
+    {
+        prepareRow(view.mat, y, brightness, contrast, kernelHorizontal, horizontalRing.ptr<float>(y % kV));
+
+        // vertical blur needs kV rows of the horizontal blur
+        int b = y - kV + 1;
+        if (b < 0)
+            continue;
+
+        uchar *pBlur = imgBlur ? imgBlur->mat.ptr<uchar>(b) : blurRow.ptr<uchar>(0);
+        uchar *pThreshold = thresholdRing.ptr<uchar>(b % kRows);
+        for (int kr = 0; kr < kV; ++kr)
+        {
+            verticalRows[kr] = horizontalRing.ptr<float>((b + kr) % kV);
+        }
+
+        for (int c = 0; c < blurCols; ++c)
+        {
+            float result = 0.0f;
+            for (int kr = 0; kr < kV; ++kr)
+            {
+                result += verticalRows[kr][c] * pKernelVertical[kr * kernelStep];
+            }
+
+            // convert back to uchar and threshold
+            uchar blur = cv::saturate_cast<uchar>(result);
+            pBlur[c] = blur;
+            pThreshold[c] = blur >= threshold ? 255 : 0;
+        }
+
+        // erode needs kRows rows of the threshold (the last one is never used, see erode)
+        int e = b - kRows + 1;
+        if (e >= 0 && e < edgeRows && edgeCols > 0)
+        {
+            erodeRow(e, erodeKernel, fullKernel, imgEdges.mat.ptr<uchar>(e));
+            if (points)
+                points->appendRow(imgEdges.mat.ptr<uchar>(e), e);
+        }
+    }
+
+    return true;
+}
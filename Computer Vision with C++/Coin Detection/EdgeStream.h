@@ -0,0 +1,52 @@
+#ifndef EDGESTREAM_H
+#define EDGESTREAM_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include "../Core/RoiImage.h"
+#include "../Core/EdgePoints.h"
+
+////////////////////////////////////////////////////////////////////////////////////
+// edge extraction of a view, computed row by row
+//
+// grayscale -> brightness -> contrast -> horizontal blur -> vertical blur ->
+// threshold -> erode -> subtract
+//
+// every step needs only the last few rows of the step before (at most the kernel
+// height), so each step keeps a ring buffer of a few rows instead of a whole image.
+// the working set stays in the cache and the result is the same (bit for bit) as
+// the chain of operators in CoinDetector::prepare.
+////////////////////////////////////////////////////////////////////////////////////
+class EdgeStream
+{
+public:
+    EdgeStream();
+    ~EdgeStream();
+
+    // same outputs as the chain of operators (origins in frame coordinates)
+    // imgBlur: prepared grayscale image, not stored if nullptr
+    // points: optional list of the edge pixels, collected while the edge rows are computed
+    // returns false if the kernels are not supported (the blur must be separated
+    // into a float row kernel and a float column kernel)
+    bool run(const RoiImage &view, const int brightness, const float contrast,
+             const cv::Mat &kernelHorizontal, const cv::Mat &kernelVertical, const uchar threshold,
+             const cv::Mat &erodeKernel, RoiImage *imgBlur, RoiImage &imgEdges, EdgePoints *points = nullptr);
+
+private:
+    void prepareRow(const cv::Mat &input, const int row, const int brightness, const float contrast,
+                    const cv::Mat &kernelHorizontal, float *output);
+    void erodeRow(const int row, const cv::Mat &erodeKernel, const bool fullKernel, uchar *output);
+
+    // one row of the input (grayscale and float)
+    cv::Mat grayRow, floatRow;
+
+    // ring buffers (row i is stored in row i % rows)
+    cv::Mat horizontalRing; // horizontal blur, height of the vertical kernel
+    cv::Mat thresholdRing;  // threshold, height of the erode kernel
+
+    cv::Mat blurRow;        // prepared grayscale row (if it is not stored)
+    cv::Mat columnMin;      // minimum of each column of the threshold ring
+    std::vector<const float *> verticalRows; // rows of the horizontal ring for one blur row
+};
+
+#endif /* EDGESTREAM_H */
@@ -0,0 +1,309 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <opencv2/highgui/highgui.hpp>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "ImageSource.h"
+
+// header of a raw image file
+struct RawImageHeader
+{
+    char magic[4]; // "CVRI"
+    int rows;
+    int cols;
+    int type;
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// memory mapped raw file (read into memory if mmap is not available)
+////////////////////////////////////////////////////////////////////////////////////
+struct ImageSource::MappedFile
+{
+    void *data = nullptr;
+    size_t size = 0;
+    std::vector<char> buffer;
+
+    bool open(const std::string &fileName)
+    {
+#ifndef _WIN32
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(RawImageHeader))
+        {
+            ::close(fd);
+            return false;
+        }
+        void *map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED)
+            return false;
+        data = map;
+        size = info.st_size;
+        return true;
+#else
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file)
+            return false;
+        buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        size = buffer.size();
+        return size >= sizeof(RawImageHeader);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifndef _WIN32
+        if (data)
+            munmap(data, size);
+#endif
+    }
+};
+
+ImageSource::ImageSource(const size_t cacheCapacity, const int prefetchCount)
+    : cacheCapacity(std::max<size_t>(1, cacheCapacity)), prefetchCount(prefetchCount)
+{
+    thread = std::thread(&ImageSource::prefetchThread, this);
+}
+
+ImageSource::~ImageSource()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    requested.notify_all();
+    thread.join();
+}
+
+void ImageSource::setSequence(const std::string &directory, const std::string &prefix, const std::string &extension,
+                              const int count)
+{
+    this->directory = directory;
+    this->prefix = prefix;
+    this->extension = extension;
+    sequenceCount = count;
+}
+
+std::string ImageSource::getFileName(const int imageNo) const
+{
+    return directory + "/" + prefix + std::to_string(imageNo) + extension;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// image of the sequence, the next images are decoded in the background
+////////////////////////////////////////////////////////////////////////////////////
+cv::Mat ImageSource::getImage(const int imageNo)
+{
+    cv::Mat image = getImage(getFileName(imageNo));
+
+    for (int i = 1; i <= prefetchCount && i < sequenceCount; ++i)
+    {
+        prefetch(getFileName((imageNo + i) % sequenceCount));
+    }
+    return image;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// cached image, decoded in this thread if it is neither cached nor being prefetched
+////////////////////////////////////////////////////////////////////////////////////
+cv::Mat ImageSource::getImage(const std::string &fileName)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    auto it = cache.find(fileName);
+    if (it != cache.end())
+    {
+        // wait if the prefetch thread is decoding this image
+        // (the entry is gone if the decoding failed or it was evicted meanwhile -> decode it here)
+        loaded.wait(lock, [&] {
+            it = cache.find(fileName);
+            return it == cache.end() || it->second.ready;
+        });
+        if (it != cache.end())
+        {
+            ++hits;
+            touch(fileName);
+            return it->second.image;
+        }
+    }
+
+    // not cached: decode it here
+    ++misses;
+    cache[fileName].ready = false;
+    lock.unlock();
+
+    cv::Mat image = load(fileName);
+
+    lock.lock();
+    if (image.empty())
+    {
+        // failed images are not cached (the next call tries again)
+        cache.erase(fileName);
+    }
+    else
+    {
+        CacheEntry &entry = cache[fileName];
+        entry.image = image;
+        entry.ready = true;
+        touch(fileName);
+        evict();
+    }
+    lock.unlock();
+    loaded.notify_all();
+
+    return image;
+}
+
+void ImageSource::prefetch(const std::string &fileName)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cache.count(fileName) || std::find(requests.begin(), requests.end(), fileName) != requests.end())
+            return;
+        requests.push_back(fileName);
+    }
+    requested.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// background thread: decode the requested images
+////////////////////////////////////////////////////////////////////////////////////
+void ImageSource::prefetchThread()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        requested.wait(lock, [this] { return !running || !requests.empty(); });
+        if (!running)
+            return;
+
+        std::string fileName = requests.front();
+        requests.pop_front();
+        if (cache.count(fileName))
+            continue;
+
+        cache[fileName].ready = false;
+        lock.unlock();
+
+        cv::Mat image = load(fileName);
+
+        lock.lock();
+        if (image.empty())
+        {
+            cache.erase(fileName);
+        }
+        else
+        {
+            CacheEntry &entry = cache[fileName];
+            entry.image = image;
+            entry.ready = true;
+            ++prefetched;
+            touch(fileName);
+            evict();
+        }
+        loaded.notify_all();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// read the raw file (mapped) or decode the image file
+//
+// the pixels of a raw file are copied out of the mapping: a cv::Mat on foreign data
+// does not keep the mapping alive, the callers keep their images after the eviction
+////////////////////////////////////////////////////////////////////////////////////
+cv::Mat ImageSource::load(const std::string &fileName)
+{
+    MappedFile file;
+    if (file.open(getRawFileName(fileName)))
+    {
+        // check the header before the image is read from the file (truncated or corrupt files)
+        const RawImageHeader *header = (const RawImageHeader *)file.data;
+        bool valid = std::equal(header->magic, header->magic + 4, "CVRI") && header->rows > 0 && header->cols > 0 &&
+                     (header->type & ~CV_MAT_TYPE_MASK) == 0 && CV_MAT_DEPTH(header->type) <= CV_64F;
+        if (valid && double(header->rows) * header->cols * CV_ELEM_SIZE(header->type) <=
+                         double(file.size - sizeof(RawImageHeader)))
+        {
+            ++mapped;
+            cv::Mat pixels(header->rows, header->cols, header->type, (char *)file.data + sizeof(RawImageHeader));
+            return pixels.clone();
+        }
+        std::cout << "ImageSource: invalid raw file '" << getRawFileName(fileName) << "'\n";
+    }
+
+    cv::Mat image = cv::imread(fileName, CV_LOAD_IMAGE_COLOR);
+    if (image.empty())
+        std::cout << "ImageSource: unable to read '" << fileName << "'\n";
+    else if (createRawFiles)
+        writeRawImage(getRawFileName(fileName), image);
+    return image;
+}
+
+std::string ImageSource::getRawFileName(const std::string &fileName)
+{
+    size_t dot = fileName.find_last_of('.');
+    size_t slash = fileName.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        return fileName + ".raw";
+    return fileName.substr(0, dot) + ".raw";
+}
+
+bool ImageSource::writeRawImage(const std::string &fileName, const cv::Mat &image)
+{
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file)
+        return false;
+
+    RawImageHeader header = { { 'C', 'V', 'R', 'I' }, image.rows, image.cols, image.type() };
+    file.write((const char *)&header, sizeof(header));
+    for (int y = 0; y < image.rows; ++y)
+    {
+        file.write((const char *)image.ptr(y), image.cols * image.elemSize());
+    }
+    return bool(file);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// LRU order (mutex must be locked)
+////////////////////////////////////////////////////////////////////////////////////
+void ImageSource::touch(const std::string &fileName)
+{
+    lru.remove(fileName);
+    lru.push_front(fileName);
+}
+
+void ImageSource::evict()
+{
+    // all images count (also the ones which are being decoded, they are not evicted)
+    size_t count = cache.size();
+
+    for (auto it = lru.end(); it != lru.begin() && count > cacheCapacity;)
+    {
+        --it;
+        CacheEntry &entry = cache[*it];
+        if (entry.ready)
+        {
+            // the callers keep their own reference of the image data
+            cache.erase(*it);
+            it = lru.erase(it);
+            --count;
+        }
+    }
+}
+
+std::string ImageSource::getStatisticsText()
+{
+    std::stringstream text;
+    text << "images: hits " << hits << ", misses " << misses << ", prefetched " << prefetched << ", mapped " << mapped;
+    return text.str();
+}
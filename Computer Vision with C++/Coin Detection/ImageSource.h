@@ -0,0 +1,86 @@
+#ifndef IMAGESOURCE_H
+#define IMAGESOURCE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////
+// image files as input: decoded images are kept in a LRU cache and the next images
+// of the sequence are decoded in a background thread
+//
+// if a raw file (same name, extension ".raw") exists it is memory mapped and copied
+// instead of decoding the image, see 'writeRawImage'
+//
+// the returned images share the cached data -> do not modify them (clone before drawing)
+////////////////////////////////////////////////////////////////////////////////////
+class ImageSource
+{
+public:
+    // cacheCapacity: number of images in the cache (decoded or read from raw files)
+    // prefetchCount: number of following images which are decoded in the background
+    ImageSource(const size_t cacheCapacity = 16, const int prefetchCount = 2);
+    ~ImageSource();
+
+    // image sequence: directory/<prefix><number><extension>, number = 0 ... count - 1
+    void setSequence(const std::string &directory, const std::string &prefix, const std::string &extension, const int count);
+    std::string getFileName(const int imageNo) const;
+
+    // image of the sequence (the following images are prefetched)
+    cv::Mat getImage(const int imageNo);
+
+    // any image file (empty if unable to read, failed images are not cached)
+    cv::Mat getImage(const std::string &fileName);
+
+    // decode an image in the background
+    void prefetch(const std::string &fileName);
+
+    // write a decoded image as raw file after decoding (next time it is read from the raw file)
+    bool createRawFiles = false;
+
+    // raw file: header (magic, rows, cols, type) + pixel data, rows without padding
+    static std::string getRawFileName(const std::string &fileName);
+    static bool writeRawImage(const std::string &fileName, const cv::Mat &image);
+
+    // statistics
+    std::atomic<long> hits{0}, misses{0}, prefetched{0}, mapped{0};
+    std::string getStatisticsText();
+
+private:
+    struct MappedFile;
+
+    struct CacheEntry
+    {
+        cv::Mat image;
+        bool ready = false; // false while decoding
+    };
+
+    cv::Mat load(const std::string &fileName);
+    void prefetchThread();
+    void touch(const std::string &fileName);
+    void evict();
+
+    std::string directory, prefix, extension;
+    int sequenceCount = 0;
+
+    size_t cacheCapacity;
+    int prefetchCount;
+
+    std::mutex mutex;
+    std::condition_variable loaded, requested;
+    std::map<std::string, CacheEntry> cache;
+    std::list<std::string> lru; // most recently used first
+    std::deque<std::string> requests;
+
+    bool running = true;
+    std::thread thread;
+};
+
+#endif /* IMAGESOURCE_H */
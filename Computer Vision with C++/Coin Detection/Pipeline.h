@@ -0,0 +1,125 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////
+// bounded lock-free queue for exactly one producer and one consumer thread
+//
+// note: the producer does not wait if the queue is full, 'tryPush' fails and
+//       the producer drops the element (backpressure: drop frames, do not stall)
+// note: the elements are passed without a lock, the mutex and the condition variable
+//       are only used to sleep in 'waitPop' and 'waitNotFull' (woken by every push
+//       and pop and by 'wakeAll')
+////////////////////////////////////////////////////////////////////////////////////
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(const size_t capacity) : slots(capacity + 1) {}
+
+    bool tryPush(T &item)
+    {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        size_t next = (tail + 1) % slots.size();
+        if (next == headIndex.load(std::memory_order_acquire))
+            return false; // full
+
+        slots[tail] = std::move(item);
+        tailIndex.store(next, std::memory_order_release);
+        wakeAll();
+        return true;
+    }
+
+    bool tryPop(T &item)
+    {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire))
+            return false; // empty
+
+        item = std::move(slots[head]);
+        headIndex.store((head + 1) % slots.size(), std::memory_order_release);
+        wakeAll();
+        return true;
+    }
+
+    // consumer: wait for the next element (returns false if 'running' was set to false)
+    bool waitPop(T &item, const std::atomic<bool> &running)
+    {
+        while (running)
+        {
+            if (tryPop(item))
+                return true;
+
+            std::unique_lock<std::mutex> lock(waitMutex);
+            changed.wait(lock, [&]() { return !running || size() > 0; });
+        }
+        return false;
+    }
+
+    // producer: wait until there is a free slot (or 'running' was set to false)
+    void waitNotFull(const std::atomic<bool> &running)
+    {
+        std::unique_lock<std::mutex> lock(waitMutex);
+        changed.wait(lock, [&]() { return !running || size() < capacity(); });
+    }
+
+    // wake the waiting thread (e.g. after 'running' was set to false)
+    // (the mutex is locked once, so a thread which just checked the queue is already waiting)
+    void wakeAll()
+    {
+        {
+            std::lock_guard<std::mutex> lock(waitMutex);
+        }
+        changed.notify_all();
+    }
+
+    // number of elements (approximation if called while other threads push or pop)
+    size_t size() const
+    {
+        size_t head = headIndex.load(std::memory_order_acquire);
+        size_t tail = tailIndex.load(std::memory_order_acquire);
+        return (tail + slots.size() - head) % slots.size();
+    }
+
+    size_t capacity() const
+    {
+        return slots.size() - 1;
+    }
+
+private:
+    std::vector<T> slots; // one slot stays empty to distinguish 'full' from 'empty'
+    std::atomic<size_t> headIndex{0}; // next element to pop (written by consumer)
+    std::atomic<size_t> tailIndex{0}; // next free slot (written by producer)
+    std::mutex waitMutex;
+    std::condition_variable changed;
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// statistics of a pipeline stage (written by the stage, read by any thread)
+////////////////////////////////////////////////////////////////////////////////////
+struct StageStatistics
+{
+    std::atomic<long> processed{0}; // number of processed elements
+    std::atomic<long> dropped{0};   // number of elements dropped because the next queue was full
+    std::atomic<long> latencyMicroseconds{0}; // processing time of the last element
+    std::atomic<long> averageMicroseconds{0}; // smoothed processing time
+
+    void addLatency(const std::chrono::high_resolution_clock::time_point start)
+    {
+        long latency = long(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start).count());
+        latencyMicroseconds = latency;
+
+        // exponential moving average
+        long average = averageMicroseconds;
+        averageMicroseconds = processed == 0 ? latency : (average * 7 + latency) / 8;
+        ++processed;
+    }
+};
+
+#endif /* PIPELINE_H */
@@ -9,21 +9,22 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
-#include "Threshold.h"
-#include "Histogram.h"
-#include "PointOperations.h"
-#include "Filter.h"
-#include "Morphology.h"
-#include "Segmentation.h"
+#include "../Core/Filter.h"
+#include "../Core/Segmentation.h"
 #include "Timer.h"
 #include "imshow_multiple.h"
 #include "Coin.h"
+#include "CoinDetector.h"
+#include "CoinPipeline.h"
+#include "Batch.h"
+#include "ImageSource.h"
 
 //
 // function
 //
-bool calibrate(Segmentation *segmentation, Coin *coinClass, const cv::Mat imgEdges, const float cellStep,
-               const float phiStep, int *rMin, int *rMax, cv::Mat imgInput);
+bool calibrate(Segmentation *segmentation, Coin *coinClass, const RoiImage &imgEdges, const float cellStep,
+               const float phiStep, int *rMin, int *rMax, const cv::Mat &imgInput);
+void showFrame(const CoinFrame &frame, const bool showFps, const float fps, CoinPipeline *pipeline);
 
 //
 // for trackbar
@@ -65,6 +66,8 @@ void trackbarCallbackKernelSize(int, void*)
 {
     globalBlurKernelSize = (trackbarBlurKernelSize + 1) * 2 + 1;
     std::cout << "BLUR changed: new kernel size = " << globalBlurKernelSize << "\n";
+    if (Filter::useRecursiveGaussian(globalBlurSigma, globalBlurKernelSize))
+        std::cout << "BLUR: recursive Gaussian (cost independent of the kernel size)\n";
 
     if (globalBlurSigma < 0.0)
         return; // do not calculate kernels if sigma is not initialized yet
@@ -76,6 +79,8 @@ void trackbarCallbackBlurSigma(int, void*)
 {
     globalBlurSigma = double(trackbarBlurSigma) / 10.0;
     std::cout << "BLUR changed: new sigma = " << globalBlurSigma << "\n";
+    if (Filter::useRecursiveGaussian(globalBlurSigma, globalBlurKernelSize))
+        std::cout << "BLUR: recursive Gaussian (cost independent of sigma, the kernel size is not used)\n";
 
     calculateBlurKernels();
 }
@@ -88,6 +93,11 @@ int valueBrightness = 0;
 int valueContrastInt = 636;
 float valueContrast = 0.0f;
 int valueEdgeThInt = 90;
+int enableCanny = 0;
+int valueCannyLow = 40;
+int valueCannyHigh = 100;
+int smoothing = 0;
+int valueBilateralRange = 30;
 
 void updateTrackbarValues(int, void*)
 {
@@ -102,6 +112,9 @@ int cameraWidth, cameraHeight;
 int viewX1, viewX2, viewY1, viewY2, viewXtmp, viewYtmp;
 bool viewOnePointSet = false;
 
+// more views (key 'a' adds the current view, key 'c' removes all)
+std::vector<cv::Rect> extraViews;
+
 void setViewToFullCameraSize()
 {
     viewX1 = 0;
@@ -182,28 +195,34 @@ void mouseCallback(int event, int x, int y, int flags, void* userdata)
 
 int main(int argc, char *argv[])
 {
+    // headless mode: process image files, no windows
+    if (argc > 1 && std::string(argv[1]) == "--batch")
+        return runBatch(argc, argv);
+
     // initialize: trackbar values
     trackbarCallbackCalibration(0, nullptr);
     trackbarCallbackKernelSize(0, nullptr);
     trackbarCallbackBlurSigma(0, nullptr);
     updateTrackbarValues(0, nullptr);
     
+    // pipeline mode: capture, preparation, detection and classification run in parallel threads
+    // raw files: decoded images are written as raw files next to the input images (memory mapped next time)
+    // coins: other coins than Euro coins can be defined in a file ("--coins <file>")
+    bool usePipeline = false, createRawFiles = false;
+    std::string coinFileName;
+    for (int i = 1; i < argc; ++i)
+    {
+        usePipeline |= std::string(argv[i]) == "--pipeline";
+        createRawFiles |= std::string(argv[i]) == "--raw";
+        if (std::string(argv[i]) == "--coins" && i + 1 < argc)
+            coinFileName = argv[++i];
+    }
+
     // initiate class instances
-    Threshold *threshold = new Threshold();
-    PointOperations *pointOperations = new PointOperations();
-    Filter *filter = new Filter();
-    Morphology *morphology = new Morphology();
-    Segmentation *segmentation = new Segmentation();
+    CoinDetector *detector = new CoinDetector();
     Coin *coinClass = new Coin();
-
-    // define names for BGR colors
-    cv::Scalar colorGreen = cv::Scalar(0, 255, 0);
-    cv::Scalar colorBlue = cv::Scalar(255, 0, 0);
-    cv::Scalar colorRed = cv::Scalar(0, 0, 255);
-    cv::Scalar colorWhite = cv::Scalar(255, 255, 255);
-    cv::Scalar colorBlack = cv::Scalar(0, 0, 0);
-    cv::Scalar colorYellow = cv::Scalar(0, 255, 255);
-    cv::Scalar colorOrange = cv::Scalar(0, 165, 255);
+    if (!coinFileName.empty() && !coinClass->loadCoinDefinitions(coinFileName))
+        return -1;
 
     // default step sizes
     float cellStep = 1.0f;  // size of accumulator cell
@@ -287,7 +306,56 @@ int main(int argc, char *argv[])
     
     
     
+    //
+    // load the last calibration (settings, reference coin) -> no calibration needed after a restart
+    //
+    std::string calibrationFileName = "coin_calibration.yml";
+    int enableHough = 0;
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        CoinSettings stored;
+        if (loadCalibrationFile(calibrationFileName, &stored, coinClass))
+        {
+            // trackbar values
+            valueBrightnessInt = stored.brightness + 255;
+            valueContrastInt = cvRound(stored.contrast * 100.0f);
+            trackbarBlurKernelSize = std::max(0, (stored.blurKernelSize - 1) / 2 - 1);
+            trackbarBlurSigma = cvRound(stored.blurSigma * 10.0);
+            valueEdgeThInt = stored.edgeThreshold;
+            enableCanny = stored.canny;
+            valueCannyLow = stored.cannyLow;
+            valueCannyHigh = stored.cannyHigh;
+            smoothing = int(stored.smoothing);
+            valueBilateralRange = cvRound(stored.bilateralSigmaRange);
+            updateTrackbarValues(0, nullptr);
+            trackbarCallbackKernelSize(0, nullptr);
+            trackbarCallbackBlurSigma(0, nullptr);
+
+            // view (if it fits into the camera image)
+            if (stored.view.area() > 0 && stored.view.br().x < cameraWidth && stored.view.br().y < cameraHeight)
+            {
+                viewX1 = stored.view.x;
+                viewY1 = stored.view.y;
+                viewX2 = stored.view.br().x;
+                viewY2 = stored.view.br().y;
+            }
+            extraViews = stored.extraViews;
+
+            cellStep = stored.cellStep;
+            phiStep = stored.phiStep;
+            rMin = stored.radiusMin;
+            rMax = stored.radiusMax;
+            calibrated = true;
+            enableHough = 1;
+            std::cout << "Calibration loaded from '" << calibrationFileName << "' ("
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::high_resolution_clock::now() - start).count() << " ms), search radius: "
+                      << rMin << " ... " << rMax << " px\n";
+        }
+    }
+
     std::cout << "Press ENTER to calibrate for 1 Euro coin ... or ANY other key to end program.\n";
+    std::cout << "Key 'a' adds the view as extra view (views are processed in parallel), key 'c' removes the extra views.\n";
 
     
     //
@@ -295,7 +363,6 @@ int main(int argc, char *argv[])
     //
     cv::imshow("Input", imgInput);
     
-    int enableHough = 0;
     cv::createTrackbar("Enable Hough", "Main", &enableHough, 1, nullptr);
     
     cv::createTrackbar("Calibration radius min", "Main", &globalRadiusCalibMin, 200, trackbarCallbackCalibration);
@@ -309,22 +376,52 @@ int main(int argc, char *argv[])
 
     cv::createTrackbar("Threshold 1", "Main", &valueEdgeThInt, 255, nullptr);
 
+    // Canny edge detector instead of the threshold (thresholds of the gradient magnitude)
+    cv::createTrackbar("Canny", "Main", &enableCanny, 1, nullptr);
+    cv::createTrackbar("Canny low", "Main", &valueCannyLow, 1000, nullptr);
+    cv::createTrackbar("Canny high", "Main", &valueCannyHigh, 1000, nullptr);
+
+    // edge-preserving smoothing: 0: Gaussian, 1: median (radius: kernel size / 2), 2: bilateral (sigma)
+    cv::createTrackbar("Smoothing", "Main", &smoothing, 2, nullptr);
+    cv::createTrackbar("Bilateral range", "Main", &valueBilateralRange, 100, nullptr);
+
     // add trackbar for image selection (only if no camera was found)
     int imageNo = 0;
+    const int imageCount = 13;
     if (!cameraActive)
-        cv::createTrackbar("Image selection", "Main", &imageNo, 12, nullptr);
+        cv::createTrackbar("Image selection", "Main", &imageNo, imageCount - 1, nullptr);
+
+    // input images: decoded once, the next images are decoded in the background
+    ImageSource *images = new ImageSource();
+    images->setSequence(INPUTIMAGEDIR, "coin", ".tiff", imageCount);
+    images->createRawFiles = createRawFiles;
 
     // add trackbar for alternative versions of functions (e.g usage of threads to improve speed)
     // note: you do not have to use this
     int alternative = 1;
     cv::createTrackbar("Use threads", "Main", &alternative, 1, nullptr);
 
+    // edge image row by row with small ring buffers instead of full-frame intermediates
+    int streamEdges = 1;
+    cv::createTrackbar("Stream edges", "Main", &streamEdges, 1, nullptr);
+
+    // coarse-to-fine circle detection: number of pyramid levels (0: full resolution only)
+    int pyramidLevels = 0;
+    cv::createTrackbar("Pyramid levels", "Main", &pyramidLevels, 2, nullptr);
+
+    // temporal tracking: run the Hough transformation only in regions that changed since the last frame
+    int enableTracking = 0;
+    cv::createTrackbar("Tracking", "Main", &enableTracking, 1, nullptr);
+
+    // color model follows slow changes of the lighting (colors of the found coins)
+    int adaptColors = 0;
+    cv::createTrackbar("Adapt colors", "Main", &adaptColors, 1, nullptr);
+
     // add mouse callback to input window
     cv::setMouseCallback("Input", mouseCallback, NULL);
 
     // create other output windows
-    cv::Mat imgGray, imgBrightness, imgContrast, imgBlur, imgThresh, imgEroded, imgEdges, imgHough, imgResult;
-    cv::Mat imgSubtracted;
+    cv::Mat imgBlur, imgEdges;
     imgBlur = cv::Mat::zeros(cv::Size(cameraWidth, cameraHeight), CV_8U);
     imgEdges = cv::Mat::zeros(cv::Size(cameraWidth, cameraHeight), CV_8U);
     cv::imshow("Prepared grayscale", imgBlur);
@@ -332,89 +429,113 @@ int main(int argc, char *argv[])
     imgMain = cv::Mat::zeros(cv::Size(350, 1), CV_8U); // bugfix for MS Windows (part 2/2)
     cv::imshow("Main", imgMain);
 
-
-    while (true) // endless loop
+    // start the pipeline threads
+    CoinPipeline *pipeline = nullptr;
+    if (usePipeline)
     {
-        // meassure time (for calculation of fps)
-        auto timerStart = std::chrono::high_resolution_clock::now();
-
-        // get image
-        if (cameraActive)
-        {
-            // capture picture
-            if (!capture.read(imgInput))
-            {
-                std::cout << "Camera: Unable to read frame from camera.\n";
-                return 0;
-            }
-        }
-        else
-        {
-            // load image from file
-            std::string fileName(INPUTIMAGEDIR);
-            fileName += "/coin" + std::to_string(imageNo) + ".tiff";
-            imgInput = cv::imread(fileName, CV_LOAD_IMAGE_COLOR);
-        }
-
-
-        //
-        // apply view and convert to grayscale
-        //
-        cv::cvtColor(imgInput(cv::Rect(viewX1, viewY1, viewX2 - viewX1, viewY2 - viewY1)), imgGray, cv::COLOR_BGR2GRAY);
-
-
-        //
-        // adjust brightness
-        //
-        pointOperations->adjustBrightness(imgGray, imgBrightness, valueBrightness);
+        std::cout << "Pipeline mode: capture, preparation, detection and classification run in parallel.\n";
+        pipeline = new CoinPipeline(coinClass, cameraActive ? &capture : nullptr, images);
+        pipeline->start();
+    }
 
+    // last frame which was shown
+    CoinFrame frame;
+    auto timeLastFrame = std::chrono::high_resolution_clock::now();
+    float fps = 0.0f;
 
+    while (true) // endless loop
+    {
         //
-        // adjust contrast
+        // collect the settings (trackbars, calibration, view)
         //
-        pointOperations->adjustContrast(imgBrightness, imgContrast, valueContrast);
-
+        CoinSettings settings;
+        settings.view = cv::Rect(viewX1, viewY1, viewX2 - viewX1, viewY2 - viewY1);
+        settings.extraViews = extraViews;
+        settings.brightness = valueBrightness;
+        settings.contrast = valueContrast;
+        settings.blurKernelHorizontal = globalBlurKernelHorizontal;
+        settings.blurKernelVertical = globalBlurKernelVertical;
+        settings.blurKernelSize = globalBlurKernelSize;
+        settings.blurSigma = globalBlurSigma;
+        settings.edgeThreshold = valueEdgeThInt;
+        settings.streamEdges = streamEdges;
+        settings.canny = enableCanny;
+        settings.cannyLow = valueCannyLow;
+        settings.cannyHigh = valueCannyHigh;
+        settings.smoothing = Smoothing(smoothing);
+        settings.bilateralSigmaRange = float(std::max(1, valueBilateralRange));
+        settings.cellStep = cellStep;
+        settings.phiStep = phiStep;
+        settings.radiusMin = rMin;
+        settings.radiusMax = rMax;
+        settings.maxCountPerRadius = calibrated ? maxCoinCountCalibrated : maxCoinCountUncalibrated;
+        settings.pyramidLevels = pyramidLevels;
+        settings.useThreads = alternative;
+        settings.tracking = enableTracking && calibrated;
+        settings.adaptColors = adaptColors;
+        settings.enableHough = enableHough;
+        settings.calibrated = calibrated;
+        settings.imageNo = imageNo;
 
         //
-        // blur
+        // get the next frame with all results
         //
+        bool newFrame = false;
+        if (usePipeline)
+        {
+            pipeline->setSettings(settings);
+            if (!pipeline->captureActive)
+                break; // no more frames (camera error)
+            newFrame = pipeline->tryGetFrame(frame);
+        }
+        else
+        {
+            // all steps in this thread
+            frame.settings = settings;
+            frame.timeCaptured = std::chrono::high_resolution_clock::now();
 
-        // convloution uses float -> convert to float
-        cv::Mat imgContrastFloat;
-        imgContrast.convertTo(imgContrastFloat, CV_32F);
-        
-        // 2x convolution with 1D kernel
-        cv::Mat blurHorizontal, blurVertical;
-        filter->convolve_generic_normalized_float_kernel(imgContrastFloat, blurHorizontal, globalBlurKernelHorizontal);
-        filter->convolve_generic_normalized_float_kernel(blurHorizontal, blurVertical, globalBlurKernelVertical);
+            // get image
+            if (cameraActive)
+            {
+                // capture picture
+                if (!capture.read(frame.input))
+                {
+                    std::cout << "Camera: Unable to read frame from camera.\n";
+                    break;
+                }
+            }
+            else
+            {
+                // load image from file (cached)
+                frame.input = images->getImage(imageNo);
+            }
 
-        // convert back to uchar and remove cropped edges
-        int borderSize = globalBlurKernelSize / 2 + 1;
-        blurVertical(cv::Rect(borderSize, borderSize, blurVertical.cols - borderSize - borderSize,
-                              blurVertical.rows - borderSize - borderSize)).convertTo(imgBlur, CV_8U);
+            // grayscale, blur and edges
+            detector->prepareFrame(&frame);
 
-        // show image
-        cv::imshow("Prepared grayscale", imgBlur);
+            // find cirlces
+            detector->detectFrame(&frame, coinClass);
 
+            // classify all coins
+            if (settings.enableHough && settings.calibrated)
+            {
+                frame.coins = coinClass->classifyAll(frame.input, frame.circles, settings.adaptColors);
+            }
+            newFrame = true;
+        }
 
-        //
-        // edge detection (threshold -> erode -> substract)
-        //
-        threshold->loop_ptr2(imgBlur, imgThresh, valueEdgeThInt);
-        morphology->erode(imgThresh, imgEroded, morphology->getKernelFull(3));
-        morphology->subtract(imgThresh, imgSubtracted, imgEroded);
-        
-        // subtraction can creeate a (white) border -> use part of image without border
-        imgEdges = imgSubtracted(cv::Rect(2, 2, imgSubtracted.cols - 4, imgSubtracted.rows - 4));
-        
-        // show image
-        cv::imshow("Edges", imgEdges);
-
-        // create empty list of circles
-        std::vector<CircleItem> circles;
-
-        // add view indicator to camera window
-        cv::rectangle(imgInput, cv::Point(viewX1, viewY1), cv::Point(viewX2, viewY2), colorGreen);
+        if (newFrame)
+        {
+            auto timeFrame = std::chrono::high_resolution_clock::now();
+            auto time = std::chrono::duration_cast<std::chrono::microseconds>(timeFrame - timeLastFrame).count();
+            fps = 1000000.0f / float(time);
+            timeLastFrame = timeFrame;
+
+            // show images
+            cv::imshow("Prepared grayscale", frame.blur.mat);
+            cv::imshow("Edges", frame.edges.mat);
+            showFrame(frame, showFps, fps, pipeline);
+        }
 
         //
         // program is operated by keyboard
@@ -424,12 +545,44 @@ int main(int argc, char *argv[])
         //
         // as long as no key is pressed input images will be read (from file or camera)
 
-        int key = cv::waitKey(20); // catch pressed key and wait for some time to draw the images
+        int key = cv::waitKey(usePipeline ? 1 : 20); // catch pressed key and wait for some time to draw the images
         if (key == 10 || key == 13 || key == 1048586 || key == 1113997 || key == 65421) // key 'ENTER' (code depends on the system)
         {
+            if (frame.edges.empty())
+                continue; // no frame yet
+
             // calibrate: detect reference coin (1 Euro)
-            calibrated = calibrate(segmentation, coinClass, imgEdges, cellStep, phiStep, &rMin, &rMax, imgInput);
-            continue;
+            if (usePipeline)
+            {
+                // note: the pipeline's tracker is reset automatically by the new search radius
+                std::lock_guard<std::mutex> lock(pipeline->coinMutex);
+                calibrated = calibrate(detector->segmentation, coinClass, frame.edges, cellStep, phiStep, &rMin, &rMax, frame.input);
+            }
+            else
+            {
+                detector->tracker->reset();
+                calibrated = calibrate(detector->segmentation, coinClass, frame.edges, cellStep, phiStep, &rMin, &rMax, frame.input);
+            }
+
+            // store the calibration (e.g. for the batch mode)
+            if (calibrated)
+            {
+                settings.radiusMin = rMin;
+                settings.radiusMax = rMax;
+                settings.maxCountPerRadius = maxCoinCountCalibrated;
+                if (saveCalibrationFile(calibrationFileName, settings, coinClass))
+                    std::cout << "Calibration saved to '" << calibrationFileName << "'\n";
+            }
+        }
+        else if (key == 97 || key == 1048673) // key 'a'
+        {
+            extraViews.push_back(settings.view);
+            std::cout << "View added as extra view (" << extraViews.size() << " extra views). Select the next view.\n";
+        }
+        else if (key == 99 || key == 1048675) // key 'c'
+        {
+            extraViews.clear();
+            std::cout << "Extra views removed.\n";
         }
         else if ((key == 102 || key == 1048678) || (key == 115 || key == 1048691)) // key 'f' or key 's'
         {
@@ -438,146 +591,143 @@ int main(int argc, char *argv[])
         else if (key >= 0) // any other key -> end program
         {
             std::cout<<"unknown key pressed (" << key << ") -> end program.\n";
-            return 0;
+            break;
         }
+    } // endless loop
 
-        std::stringstream mainWindowText;
-        if (enableHough)
-        {
-            coinClass->setImageNo(imageNo); // image number is used as a (very simple) color calibration
-            
-            if (calibrated)
-            {
-                //
-                // detect coins, count sum and mark coins in camera image
-                //
+    // the pipeline first: its threads use the detector, the coins and the images
+    delete pipeline;
+    delete images;
+    delete detector;
+    delete coinClass;
+    return 0;
+}
 
-                // find cirlces
-                if (!alternative)
-                    segmentation->findCircles(imgEdges, &circles, rMin, rMax, cellStep, phiStep, maxCoinCountCalibrated);
-                else;
-                    segmentation->findCirclesThread(imgEdges, &circles, rMin, rMax, cellStep, phiStep, maxCoinCountCalibrated);
+////////////////////////////////////////////////////////////////////////////////////
+// draw circles, coin values and sum into (a copy of) the camera image and show it
+////////////////////////////////////////////////////////////////////////////////////
+void showFrame(const CoinFrame &frame, const bool showFps, const float fps, CoinPipeline *pipeline)
+{
+    // define names for BGR colors
+    cv::Scalar colorGreen = cv::Scalar(0, 255, 0);
+    cv::Scalar colorBlue = cv::Scalar(255, 0, 0);
+    cv::Scalar colorRed = cv::Scalar(0, 0, 255);
+    cv::Scalar colorWhite = cv::Scalar(255, 255, 255);
+    cv::Scalar colorBlack = cv::Scalar(0, 0, 0);
+    cv::Scalar colorYellow = cv::Scalar(0, 255, 255);
 
-                coinClass->removeOverlappingCircles(&circles);
+    // the camera image of the frame is used for the calibration -> do not draw into it
+    cv::Mat imgOutput = frame.input.clone();
 
-                // show list of circles
-                // coinClass->showCirleList(&circles);
+    // add view indicator to camera window
+    cv::rectangle(imgOutput, frame.settings.view, colorGreen);
+    for (auto view : frame.settings.extraViews)
+    {
+        cv::rectangle(imgOutput, view, colorGreen);
+    }
 
-                double sum = 0.0;
-                for (auto circle : circles)
-                {
-                    int x = circle.x + viewX1 + borderSize;
-                    int y = circle.y + viewY1 + borderSize;
-
-                    double value = coinClass->getCoinValue(imgInput, x, y, circle.r);
-
-                    // color depends on coin
-                    cv::Scalar color = value >= 1.0
-                        ? colorWhite
-                        : value >= 0.1
-                        ? colorYellow
-                        : value >= 0.01 ? colorRed : colorBlue;
-
-                    // draw circle
-                    cv::circle(imgInput, cv::Point(x, y), circle.r, color);
-
-                    
-                    if (value >= 0.01) {
-                        // coin detected
-                        sum += value;
-
-                        // draw value as number
-                        std::stringstream text;
-                        text << std::fixed << std::setprecision(2) << value;
-                        textToImage(imgInput, text.str().c_str(), x - 18, y + 5, color, colorBlack);
-                    }
-                }
-                mainWindowText << "SUM=" << std::fixed << std::setprecision(2) << sum;
-            }
-            else
+    std::stringstream mainWindowText;
+    if (frame.settings.enableHough)
+    {
+        if (frame.settings.calibrated)
+        {
+            //
+            // count sum and mark coins in camera image
+            //
+            double sum = 0.0;
+            for (size_t i = 0; i < frame.circles.size(); ++i)
             {
-                //
-                // no calibration yet -> mark cirles
-                //
-
-                // find cirlces
-                if (!alternative)
-                    segmentation->findCircles(imgEdges, &circles, rMin, rMax, cellStep, phiStep, maxCoinCountUncalibrated);
-                else
-                    segmentation->findCirclesThread(imgEdges, &circles, rMin, rMax, cellStep, phiStep, maxCoinCountUncalibrated);
-
-                mainWindowText << "Not calibrated yet. Use 1 Euro coin and press ENTER for calibration.";
-                for (auto circle : circles)
-                {
-                    cv::circle(imgInput,
-                            cv::Point(viewX1 + borderSize  + circle.x, viewY1 + borderSize + circle.y), circle.r, colorBlue);
+                const CircleItem &circle = frame.circles[i];
+                int x = cvRound(circle.xf);
+                int y = cvRound(circle.yf);
+                double value = frame.coins.values[i];
+
+                // color depends on coin
+                cv::Scalar color = value >= 1.0
+                    ? colorWhite
+                    : value >= 0.1
+                    ? colorYellow
+                    : value >= 0.01 ? colorRed : colorBlue;
+
+                // draw circle
+                cv::circle(imgOutput, cv::Point(x, y), cvRound(circle.rf), color);
+
+                if (value >= 0.01) {
+                    // coin detected
+                    sum += value;
+
+                    // draw value as number
+                    std::stringstream text;
+                    text << std::fixed << std::setprecision(2) << value;
+                    textToImage(imgOutput, text.str().c_str(), x - 18, y + 5, color, colorBlack);
                 }
             }
+            mainWindowText << "SUM=" << std::fixed << std::setprecision(2) << sum;
         }
-        
-        if (showFps)
+        else
         {
-            auto timerEnd = std::chrono::high_resolution_clock::now();
-            auto time = std::chrono::duration_cast<std::chrono::milliseconds>(timerEnd - timerStart).count();
+            //
+            // no calibration yet -> mark cirles
+            //
+            mainWindowText << "Not calibrated yet. Use 1 Euro coin and press ENTER for calibration.";
+            for (auto circle : frame.circles)
+            {
+                cv::circle(imgOutput, cv::Point(circle.x, circle.y), circle.r, colorBlue);
+            }
+        }
+    }
 
-            std::stringstream text;
-            text << "FPS: " << std::fixed << std::setprecision(2) << (1000.0f / float(time));
-            textToImage(imgInput, text.str().c_str(), 10, cameraHeight - 20, colorBlack, colorWhite);
+    if (showFps)
+    {
+        std::stringstream text;
+        text << "FPS: " << std::fixed << std::setprecision(2) << fps;
+        textToImage(imgOutput, text.str().c_str(), 10, imgOutput.rows - 20, colorBlack, colorWhite);
 
+        // pipeline: queue depth and time per frame of every stage
+        if (pipeline)
+        {
+            std::vector<std::string> lines = pipeline->getStatisticsText();
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                textToImage(imgOutput, lines[i], 10, imgOutput.rows - 40 - 20 * int(lines.size() - i), colorBlack, colorWhite);
+            }
         }
+    }
 
-        // show main window with text
-        textToImage(imgInput, mainWindowText.str().c_str(), 10, 15, colorBlack, colorWhite);
-        cv::imshow("Input", imgInput);
-    } // endless loop
+    // show main window with text
+    textToImage(imgOutput, mainWindowText.str().c_str(), 10, 15, colorBlack, colorWhite);
+    cv::imshow("Input", imgOutput);
 }
 
-bool calibrate(Segmentation *segmentation, Coin *coinClass, const cv::Mat imgEdges, const float cellStep,
-               const float phiStep, int *rMin, int *rMax, cv::Mat imgInput)
+bool calibrate(Segmentation *segmentation, Coin *coinClass, const RoiImage &imgEdges, const float cellStep,
+               const float phiStep, int *rMin, int *rMax, const cv::Mat &imgInput)
 {
     //
     // calibrate: detect reference coin (1 Euro)
     //
-    int referenceRadius = -1;
-    int valueMax = 0;
-    cv::Point referenceCenter;
-
     std::cout << "Start calibration ...\n";
-    for (int r = globalRadiusCalibMin; r <= globalRadiusCalibMax; ++r) {
-        // Hough Transformation
-        cv::Mat imgHough;
-        segmentation->houghCircle(imgEdges, imgHough, r, cellStep, phiStep);
-
-        // show hough space
-        cv::Mat imgHoughScaled;
-        segmentation->scaleHoughImage(imgHough, imgHoughScaled);
-
-        // find one circle
-        int value;
-        cv::Point center = segmentation->findAndRemoveMaximum(imgHough, &value, r, cellStep);
-
-        // evaluate radius
-        if (value > valueMax && referenceCenter.x < cameraWidth - r - 10 &&
-            referenceCenter.y < cameraWidth - r - 10) {
-            valueMax = value;
-            referenceRadius = r;
-            referenceCenter = center;
-        }
-    }
+    auto start = std::chrono::high_resolution_clock::now();
+    // (camera image coordinates)
+    CircleItem reference = segmentation->findStrongestCircle(imgEdges, globalRadiusCalibMin, globalRadiusCalibMax,
+                                                             cellStep, phiStep);
+    int referenceRadius = reference.r;
+    cv::Point referenceCenter(reference.x, reference.y);
     std::cout << "Calibration coin: radius=" << referenceRadius
-              << "\tx=" << referenceCenter.x << "\ty=" << referenceCenter.y << '\n';
+              << "\tx=" << referenceCenter.x << "\ty=" << referenceCenter.y << "\t("
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::high_resolution_clock::now() - start).count() << " ms)\n";
 
-    if (referenceRadius < 1 || referenceCenter.x < referenceRadius + 10 ||
-    referenceCenter.x > cameraWidth - referenceRadius - 10 ||
+    if (referenceRadius < 1 || reference.v < 1 || referenceCenter.x < referenceRadius + 10 ||
+    referenceCenter.x > imgInput.cols - referenceRadius - 10 ||
     referenceCenter.y < referenceRadius + 10 ||
-    referenceCenter.y > cameraWidth - referenceRadius - 10)
+    referenceCenter.y > imgInput.rows - referenceRadius - 10)
     {
         std::cout << "Coin not found or coin (partially) outside of camera image.\n";
     }
     else
     {
         // update coin radii (calculated in relation to reference coin)
-        coinClass->setReferenceCoin(imgInput, 1.00, referenceRadius, referenceCenter.x, referenceCenter.y);
+        coinClass->setReferenceCoin(imgInput, coinClass->referenceCoinValue, referenceRadius, referenceCenter.x, referenceCenter.y);
 
         *rMin = coinClass->radiusMinPixel;
         *rMax = coinClass->radiusMaxPixel;
@@ -588,4 +738,3 @@ bool calibrate(Segmentation *segmentation, Coin *coinClass, const cv::Mat imgEdg
     }
     return false; // calibration failed
 }
-
@@ -0,0 +1,514 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+#include <thread>
+
+#include "Canny.h"
+#include "CpuDispatch.h"
+
+#ifdef CORE_X86
+#include <immintrin.h>
+#endif
+#ifdef CORE_NEON
+#include <arm_neon.h>
+#endif
+
+Canny::Canny()
+{}
+
+Canny::~Canny()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////
+// kernels: non-maximum suppression of the pixels [first, last) of row r (see CpuDispatch.h)
+//
+// pAbove, pCenter, pBelow: magnitude of the rows r - 1, r, r + 1
+// pGx, pGy: gradient of row r
+// pEdges: 2 (above 'high'), 1 (above 'low', candidate of the hysteresis) or 0
+//
+// the direction of the gradient is quantized like in Gradient::sobel (4 bins,
+// tan(22.5 deg) ~ 13/32). a pixel is a maximum if it is larger than its neighbour
+// in front of it and not smaller than the one behind it (plateaus give one pixel)
+////////////////////////////////////////////////////////////////////////////////////
+typedef void (*SuppressRowFunction)(const short *pAbove, const short *pCenter, const short *pBelow,
+                                    const short *pGx, const short *pGy, uchar *pEdges, const int first,
+                                    const int last, const short low, const short high);
+
+static void suppressRowScalar(const short *pAbove, const short *pCenter, const short *pBelow, const short *pGx,
+                              const short *pGy, uchar *pEdges, const int first, const int last, const short low,
+                              const short high)
+{
+    for (int c = first; c < last; ++c)
+    {
+        int gx = pGx[c];
+        int gy = pGy[c];
+        int ax = std::abs(gx);
+        int ay = std::abs(gy);
+
+        int before, after;
+        if (32 * ay <= 13 * ax)
+        {
+            before = pCenter[c - 1]; // horizontal
+            after = pCenter[c + 1];
+        }
+        else if (32 * ax <= 13 * ay)
+        {
+            before = pAbove[c]; // vertical
+            after = pBelow[c];
+        }
+        else if ((gx ^ gy) >= 0)
+        {
+            before = pAbove[c - 1]; // 45 deg (y axis downwards)
+            after = pBelow[c + 1];
+        }
+        else
+        {
+            before = pAbove[c + 1]; // 135 deg
+            after = pBelow[c - 1];
+        }
+
+        int magnitude = pCenter[c];
+        uchar edge = 0;
+        if (magnitude > before && magnitude >= after && magnitude > low)
+            edge = magnitude > high ? 2 : 1;
+        pEdges[c] = edge;
+    }
+}
+
+#ifdef CORE_X86
+// mask ? a : b
+CORE_TARGET_SSE2 static inline __m128i select(const __m128i mask, const __m128i a, const __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// 8 pixels per step (16 bit)
+CORE_TARGET_SSE2 static void suppressRowSSE2(const short *pAbove, const short *pCenter, const short *pBelow,
+                                             const short *pGx, const short *pGy, uchar *pEdges, const int first,
+                                             const int last, const short low, const short high)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lowThreshold = _mm_set1_epi16(low);
+    const __m128i highThreshold = _mm_set1_epi16(high);
+    int c = first;
+    for (; c + 8 <= last; c += 8)
+    {
+        __m128i gx = _mm_loadu_si128((const __m128i *) (pGx + c));
+        __m128i gy = _mm_loadu_si128((const __m128i *) (pGy + c));
+        __m128i ax = _mm_max_epi16(gx, _mm_sub_epi16(zero, gx));
+        __m128i ay = _mm_max_epi16(gy, _mm_sub_epi16(zero, gy));
+
+        __m128i notHorizontal = _mm_cmpgt_epi16(_mm_slli_epi16(ay, 5), _mm_mullo_epi16(ax, _mm_set1_epi16(13)));
+        __m128i notVertical = _mm_cmpgt_epi16(_mm_slli_epi16(ax, 5), _mm_mullo_epi16(ay, _mm_set1_epi16(13)));
+        __m128i vertical = _mm_andnot_si128(notVertical, notHorizontal);
+        __m128i diagonal = _mm_and_si128(notHorizontal, notVertical);
+        __m128i opposite = _mm_cmpgt_epi16(zero, _mm_xor_si128(gx, gy));
+
+        // neighbours in the direction of the gradient
+        __m128i before = _mm_loadu_si128((const __m128i *) (pCenter + c - 1));
+        __m128i after = _mm_loadu_si128((const __m128i *) (pCenter + c + 1));
+        before = select(vertical, _mm_loadu_si128((const __m128i *) (pAbove + c)), before);
+        after = select(vertical, _mm_loadu_si128((const __m128i *) (pBelow + c)), after);
+        __m128i diagonalBefore = select(opposite, _mm_loadu_si128((const __m128i *) (pAbove + c + 1)),
+                                        _mm_loadu_si128((const __m128i *) (pAbove + c - 1)));
+        __m128i diagonalAfter = select(opposite, _mm_loadu_si128((const __m128i *) (pBelow + c - 1)),
+                                       _mm_loadu_si128((const __m128i *) (pBelow + c + 1)));
+        before = select(diagonal, diagonalBefore, before);
+        after = select(diagonal, diagonalAfter, after);
+
+        __m128i magnitude = _mm_loadu_si128((const __m128i *) (pCenter + c));
+        __m128i maximum = _mm_andnot_si128(_mm_cmpgt_epi16(after, magnitude), _mm_cmpgt_epi16(magnitude, before));
+        __m128i weak = _mm_and_si128(maximum, _mm_cmpgt_epi16(magnitude, lowThreshold));
+        __m128i strong = _mm_and_si128(maximum, _mm_cmpgt_epi16(magnitude, highThreshold));
+
+        // masks are -1: 0 - (weak + strong) = 0, 1 or 2
+        __m128i edge = _mm_sub_epi16(zero, _mm_add_epi16(weak, strong));
+        _mm_storel_epi64((__m128i *) (pEdges + c), _mm_packus_epi16(edge, zero));
+    }
+    suppressRowScalar(pAbove, pCenter, pBelow, pGx, pGy, pEdges, c, last, low, high);
+}
+
+// the same with 16 pixels per step
+CORE_TARGET_AVX2 static void suppressRowAVX2(const short *pAbove, const short *pCenter, const short *pBelow,
+                                             const short *pGx, const short *pGy, uchar *pEdges, const int first,
+                                             const int last, const short low, const short high)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lowThreshold = _mm256_set1_epi16(low);
+    const __m256i highThreshold = _mm256_set1_epi16(high);
+    int c = first;
+    for (; c + 16 <= last; c += 16)
+    {
+        __m256i gx = _mm256_loadu_si256((const __m256i *) (pGx + c));
+        __m256i gy = _mm256_loadu_si256((const __m256i *) (pGy + c));
+        __m256i ax = _mm256_abs_epi16(gx);
+        __m256i ay = _mm256_abs_epi16(gy);
+
+        __m256i notHorizontal = _mm256_cmpgt_epi16(_mm256_slli_epi16(ay, 5),
+                                                   _mm256_mullo_epi16(ax, _mm256_set1_epi16(13)));
+        __m256i notVertical = _mm256_cmpgt_epi16(_mm256_slli_epi16(ax, 5),
+                                                 _mm256_mullo_epi16(ay, _mm256_set1_epi16(13)));
+        __m256i vertical = _mm256_andnot_si256(notVertical, notHorizontal);
+        __m256i diagonal = _mm256_and_si256(notHorizontal, notVertical);
+        __m256i opposite = _mm256_cmpgt_epi16(zero, _mm256_xor_si256(gx, gy));
+
+        // neighbours in the direction of the gradient (the masks are 16 bit -> blend of the bytes)
+        __m256i before = _mm256_loadu_si256((const __m256i *) (pCenter + c - 1));
+        __m256i after = _mm256_loadu_si256((const __m256i *) (pCenter + c + 1));
+        before = _mm256_blendv_epi8(before, _mm256_loadu_si256((const __m256i *) (pAbove + c)), vertical);
+        after = _mm256_blendv_epi8(after, _mm256_loadu_si256((const __m256i *) (pBelow + c)), vertical);
+        __m256i diagonalBefore = _mm256_blendv_epi8(_mm256_loadu_si256((const __m256i *) (pAbove + c - 1)),
+                                                    _mm256_loadu_si256((const __m256i *) (pAbove + c + 1)), opposite);
+        __m256i diagonalAfter = _mm256_blendv_epi8(_mm256_loadu_si256((const __m256i *) (pBelow + c + 1)),
+                                                   _mm256_loadu_si256((const __m256i *) (pBelow + c - 1)), opposite);
+        before = _mm256_blendv_epi8(before, diagonalBefore, diagonal);
+        after = _mm256_blendv_epi8(after, diagonalAfter, diagonal);
+
+        __m256i magnitude = _mm256_loadu_si256((const __m256i *) (pCenter + c));
+        __m256i maximum = _mm256_andnot_si256(_mm256_cmpgt_epi16(after, magnitude),
+                                              _mm256_cmpgt_epi16(magnitude, before));
+        __m256i weak = _mm256_and_si256(maximum, _mm256_cmpgt_epi16(magnitude, lowThreshold));
+        __m256i strong = _mm256_and_si256(maximum, _mm256_cmpgt_epi16(magnitude, highThreshold));
+        __m256i edge = _mm256_sub_epi16(zero, _mm256_add_epi16(weak, strong));
+
+        // 16 bit -> 8 bit: packus interleaves the lanes, the permutation collects the results
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(edge, edge), 0x08);
+        _mm_storeu_si128((__m128i *) (pEdges + c), _mm256_castsi256_si128(packed));
+    }
+    suppressRowScalar(pAbove, pCenter, pBelow, pGx, pGy, pEdges, c, last, low, high);
+}
+#endif
+
+#ifdef CORE_NEON
+// 8 pixels per step
+static void suppressRowNEON(const short *pAbove, const short *pCenter, const short *pBelow, const short *pGx,
+                            const short *pGy, uchar *pEdges, const int first, const int last, const short low,
+                            const short high)
+{
+    const int16x8_t zero = vdupq_n_s16(0);
+    const int16x8_t lowThreshold = vdupq_n_s16(low);
+    const int16x8_t highThreshold = vdupq_n_s16(high);
+    int c = first;
+    for (; c + 8 <= last; c += 8)
+    {
+        int16x8_t gx = vld1q_s16(pGx + c);
+        int16x8_t gy = vld1q_s16(pGy + c);
+        int16x8_t ax = vabsq_s16(gx);
+        int16x8_t ay = vabsq_s16(gy);
+
+        uint16x8_t notHorizontal = vcgtq_s16(vshlq_n_s16(ay, 5), vmulq_n_s16(ax, 13));
+        uint16x8_t notVertical = vcgtq_s16(vshlq_n_s16(ax, 5), vmulq_n_s16(ay, 13));
+        uint16x8_t vertical = vbicq_u16(notHorizontal, notVertical);
+        uint16x8_t diagonal = vandq_u16(notHorizontal, notVertical);
+        uint16x8_t opposite = vcltq_s16(veorq_s16(gx, gy), zero);
+
+        // neighbours in the direction of the gradient
+        int16x8_t before = vbslq_s16(vertical, vld1q_s16(pAbove + c), vld1q_s16(pCenter + c - 1));
+        int16x8_t after = vbslq_s16(vertical, vld1q_s16(pBelow + c), vld1q_s16(pCenter + c + 1));
+        int16x8_t diagonalBefore = vbslq_s16(opposite, vld1q_s16(pAbove + c + 1), vld1q_s16(pAbove + c - 1));
+        int16x8_t diagonalAfter = vbslq_s16(opposite, vld1q_s16(pBelow + c - 1), vld1q_s16(pBelow + c + 1));
+        before = vbslq_s16(diagonal, diagonalBefore, before);
+        after = vbslq_s16(diagonal, diagonalAfter, after);
+
+        int16x8_t magnitude = vld1q_s16(pCenter + c);
+        uint16x8_t maximum = vbicq_u16(vcgtq_s16(magnitude, before), vcgtq_s16(after, magnitude));
+        uint16x8_t weak = vandq_u16(maximum, vcgtq_s16(magnitude, lowThreshold));
+        uint16x8_t strong = vandq_u16(maximum, vcgtq_s16(magnitude, highThreshold));
+        uint16x8_t one = vdupq_n_u16(1);
+        uint16x8_t edge = vaddq_u16(vandq_u16(weak, one), vandq_u16(strong, one));
+        vst1_u8(pEdges + c, vmovn_u16(edge));
+    }
+    suppressRowScalar(pAbove, pCenter, pBelow, pGx, pGy, pEdges, c, last, low, high);
+}
+#endif
+
+static SuppressRowFunction getSuppressRow()
+{
+#if defined(CORE_X86)
+    return selectKernel<SuppressRowFunction>(suppressRowScalar, suppressRowSSE2, suppressRowAVX2, nullptr);
+#elif defined(CORE_NEON)
+    return selectKernel<SuppressRowFunction>(suppressRowScalar, nullptr, nullptr, suppressRowNEON);
+#else
+    return suppressRowScalar;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// hysteresis: the pixels on the stack are edges, their candidates (1) and strong
+// pixels (2) become edges too and are followed
+// (only pixels in [pBegin, pEnd): the other bands are written at the same time)
+////////////////////////////////////////////////////////////////////////////////////
+static void followEdges(std::vector<uchar *> *stack, const int step, const uchar *pBegin, const uchar *pEnd)
+{
+    const int offsets[8] = { -step - 1, -step, -step + 1, -1, 1, step - 1, step, step + 1 };
+    while (!stack->empty())
+    {
+        uchar *p = stack->back();
+        stack->pop_back();
+        for (int i = 0; i < 8; ++i)
+        {
+            uchar *q = p + offsets[i];
+            if (q >= pBegin && q < pEnd && (*q == 1 || *q == 2))
+            {
+                *q = 255;
+                stack->push_back(q);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// gradient of one row: 5x5 binomial blur and 3x3 Sobel as one 7x7 kernel
+//
+// binomial [1 4 6 4 1] * Sobel [1 2 1] = [1 6 15 20 15 6 1] (smoothing)
+// binomial [1 4 6 4 1] * Sobel [-1 0 1] = [-1 -4 -5 0 5 4 1] (derivative)
+// gx = derivative (horizontal) x smoothing (vertical), gy the other way round,
+// divided by 256 (the sum of the binomial kernel) -> Sobel of the blurred image
+////////////////////////////////////////////////////////////////////////////////////
+void Canny::gradientRow(const cv::Mat &input, const int row, const GradientNorm norm, Band *band)
+{
+    int cols = input.cols;
+    const uchar *p0 = input.ptr<uchar>(row - 3);
+    const uchar *p1 = input.ptr<uchar>(row - 2);
+    const uchar *p2 = input.ptr<uchar>(row - 1);
+    const uchar *p3 = input.ptr<uchar>(row);
+    const uchar *p4 = input.ptr<uchar>(row + 1);
+    const uchar *p5 = input.ptr<uchar>(row + 2);
+    const uchar *p6 = input.ptr<uchar>(row + 3);
+
+    // vertical part (16 bit: at most 64 * 255 and 10 * 255)
+    short *pSmooth = band->smooth.ptr<short>(0);
+    short *pDerivative = band->derivative.ptr<short>(0);
+    for (int c = 0; c < cols; ++c)
+    {
+        pSmooth[c] = short((p0[c] + p6[c]) + 6 * (p1[c] + p5[c]) + 15 * (p2[c] + p4[c]) + 20 * p3[c]);
+        pDerivative[c] = short((p6[c] - p0[c]) + 4 * (p5[c] - p1[c]) + 5 * (p4[c] - p2[c]));
+    }
+
+    // horizontal part
+    short *pGx = band->gx.ptr<short>(row % 3);
+    short *pGy = band->gy.ptr<short>(row % 3);
+    short *pMagnitude = band->magnitude.ptr<short>(row % 3);
+    for (int c = 3; c < cols - 3; ++c)
+    {
+        int gx = (pSmooth[c + 3] - pSmooth[c - 3]) + 4 * (pSmooth[c + 2] - pSmooth[c - 2]) +
+                 5 * (pSmooth[c + 1] - pSmooth[c - 1]);
+        int gy = (pDerivative[c - 3] + pDerivative[c + 3]) + 6 * (pDerivative[c - 2] + pDerivative[c + 2]) +
+                 15 * (pDerivative[c - 1] + pDerivative[c + 1]) + 20 * pDerivative[c];
+        gx = (gx + 128) >> 8;
+        gy = (gy + 128) >> 8;
+        pGx[c] = short(gx);
+        pGy[c] = short(gy);
+
+        int ax = std::abs(gx);
+        int ay = std::abs(gy);
+        if (norm == GradientNorm::L1)
+            pMagnitude[c] = short(ax + ay);
+        else if (norm == GradientNorm::FastL2)
+            pMagnitude[c] = short((8 * std::max(ax, ay) + 3 * std::min(ax, ay) + 4) >> 3);
+        else
+            pMagnitude[c] = short(std::lrint(std::sqrt(float(gx * gx + gy * gy))));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// gradient, non-maximum suppression and hysteresis of the rows of one band
+// (the rows above and below the band are read, but only the band is written)
+// orientation: optional, the orientation bin (8 bins) of every candidate pixel
+////////////////////////////////////////////////////////////////////////////////////
+void Canny::detectBand(const cv::Mat &input, cv::Mat &edges, const short low, const short high,
+                       const GradientNorm norm, cv::Mat *orientation, Band *band)
+{
+    int cols = input.cols;
+    band->smooth.create(1, cols, CV_16S);
+    band->derivative.create(1, cols, CV_16S);
+    band->gx.create(3, cols, CV_16S);
+    band->gy.create(3, cols, CV_16S);
+    band->magnitude.create(3, cols, CV_16S);
+
+    // kernel of the CPU (selected at the first call)
+    static const SuppressRowFunction suppressRow = getSuppressRow();
+
+    // every row is suppressed as soon as the gradient of the row below it is available
+    gradientRow(input, band->rowBegin - 1, norm, band);
+    gradientRow(input, band->rowBegin, norm, band);
+    for (int r = band->rowBegin; r < band->rowEnd; ++r)
+    {
+        gradientRow(input, r + 1, norm, band);
+        suppressRow(band->magnitude.ptr<short>((r - 1) % 3), band->magnitude.ptr<short>(r % 3),
+                    band->magnitude.ptr<short>((r + 1) % 3), band->gx.ptr<short>(r % 3), band->gy.ptr<short>(r % 3),
+                    edges.ptr<uchar>(r), 4, cols - 4, low, high);
+
+        // the gradient of the row is overwritten 3 rows later -> keep the orientation of the candidates
+        if (orientation)
+        {
+            const uchar *pEdges = edges.ptr<uchar>(r);
+            const short *pGx = band->gx.ptr<short>(r % 3);
+            const short *pGy = band->gy.ptr<short>(r % 3);
+            uchar *pOrientation = orientation->ptr<uchar>(r);
+            for (int c = 4; c < cols - 4; ++c)
+            {
+                if (pEdges[c])
+                    pOrientation[c] = uchar(Gradient::binOf(pGx[c], pGy[c], 8));
+            }
+        }
+    }
+
+    // hysteresis: follow the edges from every strong pixel
+    uchar *pBegin = edges.ptr<uchar>(band->rowBegin);
+    uchar *pEnd = edges.ptr<uchar>(band->rowEnd - 1) + cols;
+    int step = int(edges.step);
+    band->stack.clear();
+    for (int r = band->rowBegin; r < band->rowEnd; ++r)
+    {
+        uchar *pEdges = edges.ptr<uchar>(r);
+        for (int c = 4; c < cols - 4; ++c)
+        {
+            if (pEdges[c] != 2)
+                continue;
+            pEdges[c] = 255;
+            band->stack.push_back(pEdges + c);
+            followEdges(&band->stack, step, pBegin, pEnd);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Canny edge detection (see Canny.h)
+////////////////////////////////////////////////////////////////////////////////////
+void Canny::detect(const cv::Mat &input, cv::Mat &edges, int lowThreshold, int highThreshold, EdgePoints *points,
+                   const int threads, const GradientNorm norm)
+{
+    if (input.empty() || input.type() != CV_8U)
+    {
+        std::cout << "Canny: the input must be a grayscale image (CV_8U)!" << std::endl;
+        return;
+    }
+    if (edges.data == input.data)
+    {
+        std::cout << "Canny: can not run in place!" << std::endl;
+        return;
+    }
+
+    int rows = input.rows;
+    int cols = input.cols;
+    edges.create(rows, cols, CV_8U);
+    getBorder().clear(edges);
+    if (points)
+    {
+        points->reset(edges.size());
+        orientation.create(rows, cols, CV_8U);
+    }
+    cv::Mat *pOrientation = points ? &orientation : nullptr;
+
+    cv::Rect valid = getBorder().valid(edges.size());
+    if (valid.width == 0 || valid.height == 0)
+        return;
+
+    // like cv::Canny: the thresholds are swapped if 'low' is larger (16 bit magnitudes)
+    if (lowThreshold > highThreshold)
+        std::swap(lowThreshold, highThreshold);
+    short low = short(std::min(std::max(lowThreshold, 0), SHRT_MAX));
+    short high = short(std::min(std::max(highThreshold, 0), SHRT_MAX));
+
+    // bands of at least 16 rows
+    int bandCount = std::max(1, std::min(threads, valid.height / 16));
+    bands.resize(bandCount);
+    for (int i = 0; i < bandCount; ++i)
+    {
+        bands[i].rowBegin = valid.y + valid.height * i / bandCount;
+        bands[i].rowEnd = valid.y + valid.height * (i + 1) / bandCount;
+    }
+
+    // band 0 in this thread, the others in their own threads
+    std::vector<std::thread> workers;
+    for (int i = 1; i < bandCount; ++i)
+    {
+        workers.push_back(std::thread(&Canny::detectBand, this, std::cref(input), std::ref(edges), low, high, norm,
+                                      pOrientation, &bands[i]));
+    }
+    detectBand(input, edges, low, high, norm, pOrientation, &bands[0]);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    // stitching: edges which end at the border of a band and continue with candidates in the next band
+    if (bandCount > 1)
+    {
+        std::vector<uchar *> &stack = bands[0].stack;
+        for (int i = 1; i < bandCount; ++i)
+        {
+            uchar *pUpper = edges.ptr<uchar>(bands[i].rowBegin - 1);
+            uchar *pLower = edges.ptr<uchar>(bands[i].rowBegin);
+            for (int c = valid.x; c < valid.x + valid.width; ++c)
+            {
+                for (int d = -1; d <= 1; ++d)
+                {
+                    if (pUpper[c] == 255 && pLower[c + d] == 1)
+                    {
+                        pLower[c + d] = 255;
+                        stack.push_back(pLower + c + d);
+                    }
+                    if (pLower[c] == 255 && pUpper[c + d] == 1)
+                    {
+                        pUpper[c + d] = 255;
+                        stack.push_back(pUpper + c + d);
+                    }
+                }
+            }
+        }
+        // (all threads are finished -> the whole image)
+        followEdges(&stack, int(edges.step), edges.ptr<uchar>(0), edges.ptr<uchar>(rows - 1) + cols);
+    }
+
+    // candidates which are not connected to a strong pixel are no edges
+    for (int r = valid.y; r < valid.y + valid.height; ++r)
+    {
+        uchar *pEdges = edges.ptr<uchar>(r);
+        for (int c = valid.x; c < valid.x + valid.width; ++c)
+        {
+            pEdges[c] = pEdges[c] == 255 ? 255 : 0;
+        }
+        if (points)
+            points->appendRow(pEdges, r);
+    }
+
+    // gradient direction of the edge pixels (all of them were candidates)
+    if (points)
+    {
+        points->direction.resize(points->count);
+        for (int i = 0; i < points->count; ++i)
+        {
+            int bin = orientation.ptr<uchar>(points->y[i])[points->x[i]];
+            points->direction[i] = Gradient::binDirection(bin, 8);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Canny edge detection of a region of interest, the edges are not part of the output
+////////////////////////////////////////////////////////////////////////////////////
+void Canny::detect(const RoiImage &input, RoiImage &edges, const int lowThreshold, const int highThreshold,
+                   EdgePoints *points, const int threads, const GradientNorm norm)
+{
+    RoiImage::reuseBuffer(edges.mat, input.mat.size(), CV_8U);
+    detect(input.mat, edges.mat, lowThreshold, highThreshold, points, threads, norm);
+
+    cv::Rect valid = getBorder().valid(input.mat.size());
+    edges = RoiImage(edges.mat, input.origin).cropLocal(valid);
+
+    // points: coordinates of the cropped image
+    if (points)
+    {
+        for (int i = 0; i < points->count; ++i)
+        {
+            points->x[i] = short(points->x[i] - valid.x);
+            points->y[i] = short(points->y[i] - valid.y);
+        }
+        points->size = edges.mat.size();
+        points->origin = edges.origin;
+    }
+}
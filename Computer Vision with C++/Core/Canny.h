@@ -0,0 +1,62 @@
+#ifndef CANNY_H
+#define CANNY_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+#include "EdgePoints.h"
+#include "Gradient.h"
+
+////////////////////////////////////////////////////////////////////////////////////
+// Canny edge detector: 1 px wide edges along the maxima of the gradient
+//
+// 5x5 binomial blur + 3x3 Sobel in one separable 7x7 kernel -> non-maximum
+// suppression (SIMD, see CpuDispatch.h) -> hysteresis with a stack of pixels.
+// the image is split into horizontal bands (one thread per band), edges which
+// cross the border between two bands are connected by a stitching pass.
+// (compared to threshold -> erode -> subtract: no fixed gray level, thinner edges
+// and, therefore, fewer votes in the Hough transformation)
+////////////////////////////////////////////////////////////////////////////////////
+class Canny
+{
+public:
+    Canny();
+    ~Canny();
+
+    // input: CV_8U grayscale image (not blurred, the blur is part of the gradient)
+    // edges: CV_8U, 255: edge, 0: no edge (the edges of the image (4 px) are 0)
+    // lowThreshold, highThreshold: magnitude of the 3x3 Sobel gradient of the blurred image
+    //   (not scaled, like cv::Canny: up to 4 * 255 for each of gx, gy), edges start at pixels
+    //   above 'highThreshold' and are continued along pixels above 'lowThreshold'
+    // points: optional list of the edge pixels with their gradient direction (8 orientation bins,
+    //   see Gradient::binDirection)
+    // threads: number of bands (at least 16 rows per band)
+    void detect(const cv::Mat &input, cv::Mat &edges, int lowThreshold, int highThreshold,
+                EdgePoints *points = nullptr, const int threads = 1, const GradientNorm norm = GradientNorm::L1);
+
+    // regions of interest: the output (and the points) contain only pixels which were computed
+    void detect(const RoiImage &input, RoiImage &edges, const int lowThreshold, const int highThreshold,
+                EdgePoints *points = nullptr, const int threads = 1, const GradientNorm norm = GradientNorm::L1);
+
+    // pixels at the edges of the input which are not computed (7x7 gradient + 3x3 suppression)
+    Border getBorder() const { return Border(4, 4, 4, 4); }
+
+private:
+    // rows [rowBegin, rowEnd) of the output and the buffers of their thread (reused by the next call)
+    struct Band
+    {
+        int rowBegin = 0, rowEnd = 0;
+        cv::Mat smooth, derivative;  // vertical part of the kernel for one row (16 bit)
+        cv::Mat gx, gy, magnitude;   // gradient, ring buffers of 3 rows (row i in i % 3)
+        std::vector<uchar *> stack;  // hysteresis
+    };
+
+    void detectBand(const cv::Mat &input, cv::Mat &edges, const short low, const short high,
+                    const GradientNorm norm, cv::Mat *orientation, Band *band);
+    void gradientRow(const cv::Mat &input, const int row, const GradientNorm norm, Band *band);
+
+    std::vector<Band> bands;
+    cv::Mat orientation; // orientation bin of the candidates (only if points are requested)
+};
+
+#endif /* CANNY_H */
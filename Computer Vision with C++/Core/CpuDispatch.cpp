@@ -0,0 +1,98 @@
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "CpuDispatch.h"
+
+#if defined(_MSC_VER) && defined(CORE_X86)
+#include <intrin.h>
+#endif
+#if defined(__linux__) && defined(__arm__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+// instruction sets of the CPU and the operating system
+////////////////////////////////////////////////////////////////////////////////////
+static CpuLevel detectCpuLevel()
+{
+#if defined(CORE_X86)
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool sse2 = (info[3] & (1 << 26)) != 0;
+    // AVX2: CPU (leaf 7) and the operating system saves the AVX registers (OSXSAVE, XCR0)
+    bool osAvx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    bool avx2 = osAvx && (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    bool sse2 = __builtin_cpu_supports("sse2");
+    bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+    if (avx2)
+        return CpuLevel::AVX2;
+    if (sse2)
+        return CpuLevel::SSE2;
+#elif defined(CORE_NEON)
+#if defined(__aarch64__) || defined(_M_ARM64)
+    return CpuLevel::NEON; // NEON is part of 64 bit ARM
+#elif defined(__linux__) && defined(__arm__)
+    if (getauxval(AT_HWCAP) & HWCAP_NEON)
+        return CpuLevel::NEON;
+#endif
+#endif
+    return CpuLevel::Scalar;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// detected level, limited by the environment variable CORE_CPU
+////////////////////////////////////////////////////////////////////////////////////
+static CpuLevel selectCpuLevel()
+{
+    CpuLevel level = detectCpuLevel();
+
+    const char *request = std::getenv("CORE_CPU");
+    if (request == nullptr || request[0] == 0)
+        return level;
+
+    const CpuLevel levels[] = { CpuLevel::Scalar, CpuLevel::SSE2, CpuLevel::AVX2, CpuLevel::NEON };
+    for (auto requested : levels)
+    {
+        if (std::strcmp(request, cpuLevelName(requested)) != 0)
+            continue;
+
+        // only a lower level of the same architecture (the CPU must support it)
+        bool supported = requested == CpuLevel::Scalar || requested == level ||
+                         (requested == CpuLevel::SSE2 && level == CpuLevel::AVX2);
+        if (supported)
+            return requested;
+        std::cout << "CpuDispatch: CORE_CPU=" << request << " is not supported, using " << cpuLevelName(level) << "\n";
+        return level;
+    }
+    std::cout << "CpuDispatch: unknown CORE_CPU=" << request << " (scalar, sse2, avx2, neon)\n";
+    return level;
+}
+
+CpuLevel cpuLevel()
+{
+    // detected once (thread safe initialization of the static variable)
+    static const CpuLevel level = selectCpuLevel();
+    return level;
+}
+
+const char *cpuLevelName(const CpuLevel level)
+{
+    switch (level)
+    {
+    case CpuLevel::SSE2:
+        return "sse2";
+    case CpuLevel::AVX2:
+        return "avx2";
+    case CpuLevel::NEON:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef CPUDISPATCH_H
+#define CPUDISPATCH_H
+
+////////////////////////////////////////////////////////////////////////////////////
+// runtime selection of the SIMD kernels
+//
+// every kernel is compiled for all instruction sets of the target architecture
+// (x86: scalar, SSE2, AVX2 / ARM: scalar, NEON) without extra compiler flags, the
+// best one for the CPU which runs the program is selected once at the first call.
+// so one binary runs on old and new CPUs (e.g. Raspberry Pi and PC)
+////////////////////////////////////////////////////////////////////////////////////
+
+// instruction sets of the kernels (the higher the faster)
+enum class CpuLevel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON
+};
+
+// best instruction set of this CPU
+// (the environment variable CORE_CPU=scalar|sse2|avx2|neon selects a lower one, e.g. for a comparison)
+CpuLevel cpuLevel();
+const char *cpuLevelName(const CpuLevel level);
+
+// x86: the kernels get the instruction set by a function attribute (GCC, Clang),
+// MSVC compiles the intrinsics of all instruction sets without flags
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CORE_X86
+#if defined(__GNUC__)
+#define CORE_TARGET_SSE2 __attribute__((target("sse2")))
+#define CORE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CORE_TARGET_SSE2
+#define CORE_TARGET_AVX2
+#endif
+#endif
+
+// ARM: NEON kernels only if the compiler may use NEON (always on 64 bit ARM)
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CORE_NEON
+#endif
+
+// kernel of the best available instruction set (nullptr: not compiled for this architecture)
+template<typename Function>
+Function selectKernel(Function scalar, Function sse2, Function avx2, Function neon)
+{
+    switch (cpuLevel())
+    {
+    case CpuLevel::AVX2:
+        if (avx2)
+            return avx2;
+        // fall through
+    case CpuLevel::SSE2:
+        if (sse2)
+            return sse2;
+        return scalar;
+    case CpuLevel::NEON:
+        if (neon)
+            return neon;
+        return scalar;
+    default:
+        return scalar;
+    }
+}
+
+#endif /* CPUDISPATCH_H */
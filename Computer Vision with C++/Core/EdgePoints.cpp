@@ -0,0 +1,214 @@
+#include <algorithm>
+
+#include "EdgePoints.h"
+#include "CpuDispatch.h"
+
+#ifdef CORE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+#ifdef CORE_NEON
+#include <arm_neon.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+// kernels: positions of the non-zero pixels of a row -> pX, pY (see CpuDispatch.h)
+// returns the number of positions
+////////////////////////////////////////////////////////////////////////////////////
+typedef int (*CompactRowFunction)(const uchar *pixels, const int cols, const short row, short *pX, short *pY);
+
+static int compactRowScalar(const uchar *pixels, const int cols, const short row, short *pX, short *pY)
+{
+    int n = 0;
+    for (int c = 0; c < cols; ++c)
+    {
+        if (pixels[c] == 0)
+            continue;
+        pX[n] = short(c);
+        pY[n] = row;
+        ++n;
+    }
+    return n;
+}
+
+#ifdef CORE_X86
+// index of the lowest set bit (mask != 0)
+static inline int lowestBit(const unsigned int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// 16 pixels are compared with zero at once, the bits of the movemask are
+// the positions of the edge pixels (most blocks have no edge pixel at all)
+CORE_TARGET_SSE2 static int compactRowSSE2(const uchar *pixels, const int cols, const short row, short *pX, short *pY)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int n = 0;
+    int c = 0;
+    for (; c + 16 <= cols; c += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *) (pixels + c));
+        unsigned int mask = ~_mm_movemask_epi8(_mm_cmpeq_epi8(block, zero)) & 0xFFFF;
+        while (mask)
+        {
+            pX[n] = short(c + lowestBit(mask));
+            pY[n] = row;
+            ++n;
+            mask &= mask - 1; // clear the lowest bit
+        }
+    }
+    int tail = compactRowScalar(pixels + c, cols - c, row, pX + n, pY + n);
+    for (int i = n; i < n + tail; ++i)
+        pX[i] = short(pX[i] + c); // positions of the tail are relative to c
+    return n + tail;
+}
+
+// the same with 32 pixels
+CORE_TARGET_AVX2 static int compactRowAVX2(const uchar *pixels, const int cols, const short row, short *pX, short *pY)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    int n = 0;
+    int c = 0;
+    for (; c + 32 <= cols; c += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (pixels + c));
+        unsigned int mask = ~(unsigned int) _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero));
+        while (mask)
+        {
+            pX[n] = short(c + lowestBit(mask));
+            pY[n] = row;
+            ++n;
+            mask &= mask - 1;
+        }
+    }
+    int tail = compactRowScalar(pixels + c, cols - c, row, pX + n, pY + n);
+    for (int i = n; i < n + tail; ++i)
+        pX[i] = short(pX[i] + c);
+    return n + tail;
+}
+#endif
+
+#ifdef CORE_NEON
+// NEON has no movemask: blocks of 16 pixels without an edge pixel are skipped,
+// the others are scanned
+static int compactRowNEON(const uchar *pixels, const int cols, const short row, short *pX, short *pY)
+{
+    int n = 0;
+    int c = 0;
+    for (; c + 16 <= cols; c += 16)
+    {
+        uint8x16_t block = vld1q_u8(pixels + c);
+        uint8x8_t any = vorr_u8(vget_low_u8(block), vget_high_u8(block));
+        if (vget_lane_u64(vreinterpret_u64_u8(any), 0) == 0)
+            continue;
+        for (int i = c; i < c + 16; ++i)
+        {
+            if (pixels[i] == 0)
+                continue;
+            pX[n] = short(i);
+            pY[n] = row;
+            ++n;
+        }
+    }
+    int tail = compactRowScalar(pixels + c, cols - c, row, pX + n, pY + n);
+    for (int i = n; i < n + tail; ++i)
+        pX[i] = short(pX[i] + c);
+    return n + tail;
+}
+#endif
+
+static CompactRowFunction getCompactRow()
+{
+#if defined(CORE_X86)
+    return selectKernel<CompactRowFunction>(compactRowScalar, compactRowSSE2, compactRowAVX2, nullptr);
+#elif defined(CORE_NEON)
+    return selectKernel<CompactRowFunction>(compactRowScalar, nullptr, nullptr, compactRowNEON);
+#else
+    return compactRowScalar;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// remove all points, the buffers are kept for the next image
+////////////////////////////////////////////////////////////////////////////////////
+void EdgePoints::reset(const cv::Size &imageSize, const cv::Point imageOrigin)
+{
+    count = 0;
+    direction.clear();
+    size = imageSize;
+    origin = imageOrigin;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// append the edge pixels (non-zero) of one row
+// (kernel of the CPU, selected at the first call)
+////////////////////////////////////////////////////////////////////////////////////
+void EdgePoints::appendRow(const uchar *pixels, const int row)
+{
+    int cols = size.width;
+
+    // room for a row full of edges (the buffers grow at most by a factor of 2)
+    if (int(x.size()) < count + cols)
+    {
+        size_t newSize = std::max(2 * x.size(), size_t(count + cols));
+        x.resize(newSize);
+        y.resize(newSize);
+    }
+
+    static const CompactRowFunction compactRow = getCompactRow();
+    count += compactRow(pixels, cols, short(row), x.data() + count, y.data() + count);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// all edge pixels of an edge image
+////////////////////////////////////////////////////////////////////////////////////
+void EdgePoints::fromImage(const cv::Mat &edges, EdgePoints *points, const cv::Point origin)
+{
+    points->reset(edges.size(), origin);
+    for (int r = 0; r < edges.rows; ++r)
+    {
+        points->appendRow(edges.ptr<uchar>(r), r);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// points inside of a rectangle (e.g. a window around a candidate circle)
+////////////////////////////////////////////////////////////////////////////////////
+void EdgePoints::crop(const cv::Rect &rect, EdgePoints *part) const
+{
+    cv::Rect inside = rect & cv::Rect(0, 0, size.width, size.height);
+    part->reset(inside.size(), origin + inside.tl());
+    if (inside.width <= 0 || inside.height <= 0)
+        return;
+
+    part->x.resize(std::max(part->x.size(), size_t(count)));
+    part->y.resize(std::max(part->y.size(), size_t(count)));
+    bool copyDirection = hasDirection();
+    if (copyDirection)
+        part->direction.resize(count);
+
+    // the points are sorted by row -> skip the rows above the rectangle
+    int first = int(std::lower_bound(y.begin(), y.begin() + count, short(inside.y)) - y.begin());
+    int n = 0;
+    for (int i = first; i < count && y[i] < inside.y + inside.height; ++i)
+    {
+        if (x[i] < inside.x || x[i] >= inside.x + inside.width)
+            continue;
+        part->x[n] = short(x[i] - inside.x);
+        part->y[n] = short(y[i] - inside.y);
+        if (copyDirection)
+            part->direction[n] = direction[i];
+        ++n;
+    }
+    part->count = n;
+    if (copyDirection)
+        part->direction.resize(n);
+}
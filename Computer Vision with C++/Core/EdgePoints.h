@@ -0,0 +1,43 @@
+#ifndef EDGEPOINTS_H
+#define EDGEPOINTS_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////
+// sparse list of the edge pixels of an edge image (structure of arrays)
+//
+// only 2-5% of the pixels of an edge image are edges, so the Hough transformations
+// iterate over this list instead of scanning the whole image for every radius.
+// the list is filled row by row while the edge image is computed (see
+// Morphology::subtract and EdgeStream), the rows are compacted with SIMD (see CpuDispatch.h).
+//
+// the buffers grow but are never released, so a list which is reused for every
+// frame allocates memory only for the first frames
+////////////////////////////////////////////////////////////////////////////////////
+struct EdgePoints
+{
+    std::vector<short> x, y;       // coordinates in the edge image (only [0, count) is valid)
+    std::vector<float> direction;  // gradient direction in rad (empty if not available, Canny: 45 deg bins)
+    int count = 0;
+
+    cv::Size size;                 // size of the edge image
+    cv::Point origin;              // frame coordinates of the edge image (see RoiImage)
+
+    // remove all points (the buffers are kept)
+    void reset(const cv::Size &imageSize, const cv::Point imageOrigin = cv::Point(0, 0));
+
+    // append the non-zero pixels of row 'row' of the edge image
+    void appendRow(const uchar *pixels, const int row);
+
+    bool empty() const { return count == 0; }
+    bool hasDirection() const { return int(direction.size()) >= count && count > 0; }
+
+    // all edge pixels of an edge image
+    static void fromImage(const cv::Mat &edges, EdgePoints *points, const cv::Point origin = cv::Point(0, 0));
+
+    // points inside of 'rect' (coordinates of the edge image), moved to the top left corner of 'rect'
+    void crop(const cv::Rect &rect, EdgePoints *part) const;
+};
+
+#endif /* EDGEPOINTS_H */
@@ -0,0 +1,1536 @@
+#include <iostream>
+#include <sstream>
+#include <stdio.h>
+#include <math.h>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <thread>
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "Filter.h"
+#include "CpuDispatch.h"
+
+#ifdef CORE_X86
+#include <immintrin.h>
+#endif
+#ifdef CORE_NEON
+#include <arm_neon.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+// constructor. Initialize the kernels
+////////////////////////////////////////////////////////////////////////////////////
+Filter::Filter()
+{
+    // Initialize Binomial kernels
+    // 3x3
+    signed char kernelB3[3 * 3] =  {1, 2, 1,
+                             2, 4, 2,
+                             1, 2, 1};
+
+    Binomial3 = cv::Mat(3, 3, CV_8S, kernelB3).clone();
+
+    // 5x5
+    signed char kernelB5[5 * 5] =  {1,  4,  6,  4, 1,
+                             4, 16, 24, 16, 4,
+                             6, 24, 36, 24, 6,
+                             4, 16, 24, 16, 4,
+                             1,  4,  6,  4, 1};
+
+    Binomial5 = cv::Mat(5, 5, CV_8S, kernelB5).clone();
+
+    // 3x1 and 1x3
+    signed char kernelB3x1[3 * 1] =  {1,  2, 1};
+
+    Binomial3x1 = cv::Mat(3, 1, CV_8S, kernelB3x1).clone();  
+    Binomial1x3 = cv::Mat(1, 3, CV_8S, kernelB3x1).clone();  
+
+    // 5x1 and 1x5
+    signed char kernelB5x1[5 * 1] =  {1,  4,  6,  4, 1};
+
+    Binomial5x1 = cv::Mat(5, 1, CV_8S, kernelB5x1).clone();  
+    Binomial1x5 = cv::Mat(1, 5, CV_8S, kernelB5x1).clone();  
+
+    // initialize Sobel kernels
+    // 3x3 in X direction
+    signed char kernelS1[3 * 3] =  {-1, 0, 1,
+                             -2, 0, 2,
+                             -1, 0, 1};
+
+    Sobel3_X = cv::Mat(3, 3, CV_8S, kernelS1).clone();
+
+    // 3x3 in Y direction
+    signed char kernelS2[3 * 3] =  {-1, -2, -1,
+                              0,  0,  0,
+                              1,  2,  1};
+
+    Sobel3_Y = cv::Mat(3, 3, CV_8S, kernelS2).clone();
+
+    // 5x5 in X direction
+    signed char kernelS3[5 * 5] =  { -2, -1, 0, 1,  2,
+                              -8, -4, 0, 4,  8,
+                             -12, -6, 0, 6, 12,
+                              -8, -4, 0, 4,  8,
+                              -2, -1, 0, 1,  2};
+
+    Sobel5_X = cv::Mat(5, 5, CV_8S, kernelS3).clone();
+
+    // 5x5 in Y direction
+    signed char kernelS4[5 * 5] =  {-2, -8, -12, -8, -2,
+                             -1, -4,  -6, -4, -1,
+                              0,  0,   0,  0,  0,
+                              1,  4,   6,  4,  1,
+                              2,  8,  12,  8,  2};
+
+    Sobel5_Y = cv::Mat(5, 5, CV_8S, kernelS4).clone();
+}
+
+Filter::~Filter(){}
+
+////////////////////////////////////////////////////////////////////////////////////
+// convolve the image with the kernel using the OpenCV function - only for reference
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::convolve_cv(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel)
+{
+
+    if (input.empty() || kernel.empty())
+    {  
+        std::cout << "One ore more inputs are empty!" << std::endl;
+        return;
+    }
+
+    int normFactor = 0;
+    
+    int rows = kernel.rows;
+    int cols = kernel.cols;
+    
+    if (kernel.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+    
+    // calculate the normalisation factor from the filter kernel
+    for (int r = 0; r < rows; ++r)
+    {
+        const signed char *pKernel = kernel.ptr<signed char>(r);
+        
+        for (int c = 0; c < cols; ++c)
+        {
+            normFactor += abs(*pKernel);
+            ++pKernel;
+        }
+    }
+
+    cv::Mat floatInput, floatKernel;
+    input.convertTo(floatInput, CV_32F);
+    kernel.convertTo(floatKernel, CV_32F);
+
+    cv::filter2D(floatInput, output, floatInput.depth(), floatKernel, cv::Point(-1,-1), 0, cv::BORDER_REPLICATE);
+
+    output /= (normFactor);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// convolve the image with the square-sized 3x3 kernel using pointer access
+///////////////////////////////////////////////////////////////////////////////
+void Filter::convolve_3x3(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel)
+{
+    if (input.empty() || kernel.empty())
+    {
+        std::cout << "One ore more inputs are empty!" << std::endl;
+        return;
+    }
+
+    int rows = input.rows;
+    int cols = input.cols;
+
+    output.release();
+    // create a float image initialized withe zeros
+    output = cv::Mat::zeros(rows, cols, CV_32F);
+
+    int kRows = kernel.rows;
+    int kCols = kernel.cols;
+    
+    if (kernel.isContinuous())
+    {
+        kCols = kRows * kCols;
+        kRows = 1;
+    }
+
+    // calculate the normalisation factor from the filter kernel
+    int normFactor = 0;
+
+    for (int r = 0; r < kRows; ++r)
+    {
+        const signed char *pKernel = kernel.ptr<signed char>(r);
+        
+        for (int c = 0; c < kCols; ++c)
+        {
+            normFactor += abs(*pKernel);
+            ++pKernel;
+        }
+    }
+
+    // perform a 3x3 convolution with cropped edges
+    for (int r = 0; r < (rows - 2); ++r)
+    {
+        float *pOutput = output.ptr<float>(r + 1) + 1;
+
+        for (int c = 0; c < (cols - 2); ++c)
+        {
+            const float *pInputAbove = input.ptr<float>(r)     + c;
+            const float *pInput      = input.ptr<float>(r + 1) + c;
+            const float *pInputBelow = input.ptr<float>(r + 2) + c;
+
+            const signed char *pKernel1stLine = kernel.ptr<signed char>(0);
+            const signed char *pKernel2ndLine = kernel.ptr<signed char>(1);
+            const signed char *pKernel3rdLine = kernel.ptr<signed char>(2);
+
+            float result = 0.0f;
+
+            for (int k = 0; k < 3; ++k)
+            {
+                result += (*pInputAbove) * (*pKernel1stLine) +
+                          (*pInput)      * (*pKernel2ndLine) +
+                          (*pInputBelow) * (*pKernel3rdLine);
+                
+                ++pInputAbove;
+                ++pInput;
+                ++pInputBelow;  
+                ++pKernel1stLine;
+                ++pKernel2ndLine;
+                ++pKernel3rdLine;      
+            }
+
+            result /= (normFactor);
+
+            *pOutput = result;
+
+            ++pOutput;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// convolve the image with any filter kernel using pointer access
+///////////////////////////////////////////////////////////////////////////////
+void Filter::convolve_generic(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel)
+{
+    if (input.empty() || kernel.empty())
+    {
+        std::cout << "One ore more inputs are empty!" << std::endl;
+        return;
+    }
+    
+    int rows = input.rows;
+    int cols = input.cols;
+    
+    output.release();
+    // create a float image initialized withe zeros
+    output = cv::Mat::zeros(rows, cols, CV_32F); 
+
+    int kRows = kernel.rows;
+    int kCols = kernel.cols;
+    
+    if (kernel.isContinuous())
+    {
+        kCols = kRows * kCols;
+        kRows = 1;
+    }
+
+    // calculate the normalisation factor from the filter kernel
+    int normFactor = 0;
+
+    for (int r = 0; r < kRows; ++r)
+    {
+        const signed char *pKernel = kernel.ptr<signed char>(r);
+        
+        for (int c = 0; c < kCols; ++c)
+        {
+            normFactor += abs(*pKernel);
+            ++pKernel;
+        }
+    }
+
+    // perform a generic convolution with cropped edges
+    kRows = kernel.rows;
+    kCols = kernel.cols;
+
+    int kHotspotX = kCols / 2;
+    int kHotspotY = kRows / 2;
+
+    // perform convolution
+    for (int r = 0; r < (rows - kRows + 1); ++r)
+    {
+        float *pOutput = output.ptr<float>(r + kHotspotY) + kHotspotX;
+
+        for (int c = 0; c < (cols - kCols + 1); ++c)
+        {
+            float result = 0.0f;
+
+            for (int kr = 0; kr < kRows; ++kr)
+            {
+                const float *pInput = input.ptr<float>(r + kr) + c;
+                const signed char *pKernel = kernel.ptr<signed char>(kr);
+
+                for (int kc = 0; kc < kCols; ++kc)
+                {
+                    result += ((*pInput) * (*pKernel));
+
+                    ++pKernel;
+                    ++pInput;
+                }
+            }
+
+            result /= (normFactor);
+
+            *pOutput = result;
+
+            ++pOutput;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// extrapolate the image's borders and perform convolution
+///////////////////////////////////////////////////////////////////////////////
+void Filter::convolve_extrapolate(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel)
+{
+    if (input.empty() || kernel.empty())
+    {
+        std::cout << "One ore more inputs are empty!" << std::endl;
+        return;
+    }
+
+    int border = kernel.rows/2;
+    int rows = input.rows;
+    int cols = input.cols;
+    int rOffset = rows + border;
+    int cOffset = cols + border;
+
+    // create new Mat to hold the extrapolated image
+    cv::Mat extrapolated(rows + 2 * border, cols + 2 * border, input.type());
+
+    // define a ROI and copy input image to it
+    cv::Rect ROI(border, border, cols, rows);
+    input.copyTo(extrapolated(ROI));
+
+    // do the extrapolation
+    // begin with the part on the left and right
+    for (int r = 0; r < rows; ++r)
+    {
+        const float *pInput = input.ptr<float>(r);
+        float *pExtrapolated = extrapolated.ptr<float>(border + r);
+
+        for (int b = 0; b < border; ++b)
+        {
+            *pExtrapolated = (*pInput);
+            *(pExtrapolated + cOffset) = *(pInput + cols - 1);
+
+            ++pExtrapolated;
+        }
+    }
+
+    // continue with upper and lower part of the image
+    for (int b = 0; b < border; ++b)
+    {
+        float *pExtrapolatedAbove = extrapolated.ptr<float>(b);
+        float *pExtrapolatedAboveExisting = extrapolated.ptr<float>(border);
+
+        float *pExtrapolatedBelow = extrapolated.ptr<float>(b + rOffset);
+        float *pExtrapolatedBelowExisting = extrapolated.ptr<float>(rOffset - 1);
+
+        for (int c = 0; c < (cols + 2 * border); ++c)
+        {
+            *pExtrapolatedAbove = *pExtrapolatedAboveExisting;
+            *pExtrapolatedBelow = *pExtrapolatedBelowExisting;
+
+            ++pExtrapolatedAbove;
+            ++pExtrapolatedAboveExisting;
+            ++pExtrapolatedBelow;
+            ++pExtrapolatedBelowExisting;
+        }
+    }
+
+    // do the convolution with the extrapolated image
+    cv::Mat extrapolatedOutput;
+    convolve_generic(extrapolated, extrapolatedOutput, kernel);
+
+    // discard the border pixels and copy the result to the output image
+    extrapolatedOutput(ROI).copyTo(output);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// calculate the abs() of the x-Sobel and y-Sobel image
+///////////////////////////////////////////////////////////////////////////////
+void Filter::getAbsOfSobel(const cv::Mat &input_1, const cv::Mat &input_2, cv::Mat &output)
+{
+    if (input_1.empty() || input_2.empty())
+    {
+        std::cout << "One ore more inputs are empty!" << std::endl;
+        return;
+    }
+
+    int rows = input_1.rows;
+    int cols = input_1.cols;
+
+    output.release();
+    // create a float image initialized withe zeros
+    output = cv::Mat::zeros(rows, cols, CV_32F);
+    
+    // calculate the abs() of the x-Sobel and y-Sobel results
+    for (int r = 0; r < rows; ++r)
+    {
+        const float *pInput_1 = input_1.ptr<float>(r);
+        const float *pInput_2 = input_2.ptr<float>(r);
+        float *pOutput = output.ptr<float>(r);
+        
+        for (int c = 0; c < cols; ++c)
+        {
+            *pOutput = sqrt( pow(*pInput_1, 2) + pow(*pInput_2, 2) );
+
+            ++pInput_1;
+            ++pInput_2;
+            ++pOutput;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// compute a binomial kernel
+///////////////////////////////////////////////////////////////////////////////
+cv::Mat Filter::calcBinomial(uchar size)
+{
+    cv::Mat series(size, 1, CV_8S);
+    cv::Mat kernel(size, size, CV_8S);
+
+    uchar order = size - 1;
+
+    // calculate a series of binomial coefficients
+    signed char *pSeries = series.ptr<signed char>(0);
+    for (int x = 0; x < size; ++x)
+    {
+        *pSeries = (signed char) calcBinomialCoefficient(order, x);
+        ++pSeries;
+    }
+
+    // form the kernel as outer product
+    for (int x = 0; x < size; ++x)
+    {
+        signed char *pKernel = kernel.ptr<signed char>(x);
+        const signed char *pSeriesX = series.ptr<signed char>(0) + x;
+        const signed char *pSeriesY = series.ptr<signed char>(0);
+
+        for (int y = 0; y < size; ++y)
+        {
+            *pKernel = (*pSeriesX * *pSeriesY);
+            ++pKernel;
+            ++pSeriesY;
+        }
+    }
+
+    return kernel;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// compute a Sobel kernel
+///////////////////////////////////////////////////////////////////////////////
+cv::Mat Filter::calcSobel(uchar size, bool transpose)
+{
+    signed char mean = (signed char) size / 2;
+
+    cv::Mat binomial(size, 1, CV_8S);
+    cv::Mat grad(size, 1, CV_8S);
+    cv::Mat kernel(size, size, CV_8S);
+    cv::Mat output;
+
+    // calculate a series of binomial coefficients
+    signed char *pBinomial = binomial.ptr<signed char>(0);
+    for (int x = 0; x < size; ++x)
+    {
+        *pBinomial = (signed char) calcBinomialCoefficient(size - 1, x);
+        ++pBinomial;
+    }
+
+    // Get gradient
+    signed char *pGrad = grad.ptr<signed char>(0);
+    for (int x = 0; x < size; ++x)
+    {
+        *pGrad = (signed char) -mean + x;
+        ++pGrad;
+    }
+
+    // form the kernel as (binomial * grad^T) or (grad * binomial^T) respectively
+    signed char *pX, *pY;
+    for (int x = 0; x < size; ++x)
+    {
+        signed char *pKernel = kernel.ptr<signed char>(x);
+
+        if (transpose)
+        {
+            pX = grad.ptr<signed char>(0) + x;
+            pY = binomial.ptr<signed char>(0);
+        }
+        else
+        {
+            pX = binomial.ptr<signed char>(0) + x;
+            pY = grad.ptr<signed char>(0);
+        }
+
+        for (int y = 0; y < size; ++y)
+        {
+            *pKernel = (*pX * *pY);
+            ++pKernel;
+            ++pY;
+        }
+    }
+    
+    return kernel;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// return the Binomial Coefficient (n over k)
+///////////////////////////////////////////////////////////////////////////////
+int Filter::calcBinomialCoefficient(int n, int k)
+{
+    if (( k == 0 ) || (n == k))
+    {
+        return 1;
+    }
+    else
+    {
+        // recursion
+        int tempN = calcBinomialCoefficient(n - 1, k);
+        int tempK = calcBinomialCoefficient(n - 1, k - 1);
+        return tempN + tempK;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// return the Binomial kernel
+///////////////////////////////////////////////////////////////////////////////
+cv::Mat Filter::getBinomial(uchar size)
+{
+    if (size == 3)
+        return Binomial3;
+    else if (size == 5)
+        return Binomial5;
+    else
+        return cv::Mat();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// return the separated Binomial kernels
+///////////////////////////////////////////////////////////////////////////////
+cv::Mat Filter::getBinomialSeparated(uchar size, bool transpose)
+{
+    if (size == 3)
+    {
+        if (transpose)
+            return Binomial3x1;
+        else
+            return Binomial1x3;
+    }
+    else if (size == 5)
+    {
+        if (transpose)
+            return Binomial5x1;
+        else
+            return Binomial1x5;
+    }
+    else
+    {
+        return cv::Mat();
+    }
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// return the Sobel kernel in X direction
+///////////////////////////////////////////////////////////////////////////////
+cv::Mat Filter::getSobelX(uchar size)
+{
+    if (size == 3)
+        return Sobel3_X;
+    else if (size == 5)
+        return Sobel5_X;
+    else
+        return cv::Mat();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// return the Sobel kernel in Y direction
+///////////////////////////////////////////////////////////////////////////////
+cv::Mat Filter::getSobelY(uchar size)
+{
+    if (size == 3)
+        return Sobel3_Y;
+    else if (size == 5)
+        return Sobel5_Y;
+    else
+        return cv::Mat();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// scale a Sobel image for better displaying
+///////////////////////////////////////////////////////////////////////////////
+void Filter::scaleSobelImage(const cv::Mat &input, cv::Mat &output)
+{
+    // find max value
+    double min, max;
+    cv::minMaxLoc(input, &min, &max);
+
+    // scale the image
+    input.convertTo(output, CV_32F, (0.5f / max), 0.5f);
+}
+
+
+
+
+
+// fr coin
+//cv::Mat Filter::getGaussianKernelOpenCV(const int size, const double sigma)
+//{
+//    cv::Mat kernel;
+//    cv::getGaussianKernel(size, sigma, CV_32F);
+//    return kernel;
+//}
+
+// entf:!!!
+void Filter::setGaussianKernel1D(cv::Mat &kernel, int size, const double sigma)
+{
+    kernel.release();
+    kernel = cv::Mat(size, 1, CV_32F);
+
+
+    double factor1 = 1.0 / (sigma * sqrt(2.0 * CV_PI));
+    double factor2 = -1.0 / (2.0 * sigma * sigma);
+    int half = size / 2;
+
+    float sum = 0.0;
+    float *pointer = kernel.ptr<float>(0);
+    for (int i = 0; i < size; ++i)
+    {
+        double x = double(i - half);
+        float gauss = factor1 * exp(x * x * factor2);
+        sum += gauss;
+        *pointer++ = gauss;
+    }
+
+    // normalize
+    pointer = kernel.ptr<float>(0);
+    for (int i = 0; i < size; ++i)
+    {
+        *pointer++ /= sum;
+    }
+}
+
+
+// entf!!::
+float Filter::sumOfMatElementsFloat(const cv::Mat &input)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    if (input.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+
+    float sum = 0.0f;
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const float *pInput = input.ptr<float>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            sum += *pInput++;
+        }
+    }
+    return sum;
+}
+
+// entf??!!::
+void Filter::setGaussianBlur(const cv::Mat &input, cv::Mat &output, const cv::Mat kernel1D)
+{
+    // input: image, grayscale, uchar
+    // output: image, grayscale, uchar
+    // kernel: 1D, normalized, float -> use 2x 1D-kernel (faster than 1x 2D kernel)
+
+    int rows = input.rows;
+    int cols = input.cols;
+
+    output.release();
+    output = cv::Mat(rows, cols, CV_8U);
+
+    int size = kernel1D.rows; // kernel size
+    int sizeHalf = size / 2;
+
+
+
+    // convolution: 1D kernel vertical
+    cv::Mat tmp = cv::Mat(rows, cols, CV_8U);
+    for (int r = 0; r < (rows - size + 1); ++r)
+    {
+        uchar *pOutput = tmp.ptr<uchar>(r + sizeHalf) + sizeHalf;
+
+        for (int c = 0; c < (cols - size + 1); ++c)
+        {
+            float result = 0.0f;
+
+            int kr = 0;
+            //for (int kr = 0; kr < size; ++kr)
+            //{
+                const uchar *pInput = input.ptr<uchar>(r + kr) + c;
+                const float *pKernel = kernel1D.ptr<float>(0);
+
+                for (int kc = 0; kc < size; ++kc)
+                {
+                    result += (float(*pInput) * (*pKernel));
+
+                    ++pKernel;
+                    ++pInput;
+                }
+            //}
+            //std::cout << result << '\t';
+            *pOutput = int(result);
+            ++pOutput;
+        }
+    }
+
+
+
+    // convolution: 1D kernel horizontal
+    for (int r = 0; r < (rows - size + 1); ++r)
+    {
+        uchar *pOutput = output.ptr<uchar>(r + sizeHalf) + sizeHalf;
+
+        for (int c = 0; c < (cols - size + 1); ++c)
+        {
+            float result = 0.0f;
+
+            for (int kr = 0; kr < size; ++kr)
+            {
+                const uchar *pInput = tmp.ptr<uchar>(r + kr) + c;
+                const float *pKernel = kernel1D.ptr<float>(0);
+
+                int kc = 0;
+                //for (int kc = 0; kc < size; ++kc)
+                //{
+                    result += (float(*pInput) * (*pKernel));
+
+                    ++pKernel;
+                    ++pInput;
+                //}
+            }
+            *pOutput = int(result);
+            ++pOutput;
+        }
+    }
+
+
+}
+
+
+
+
+
+
+
+void Filter::setGaussianKernels1D(cv::Mat &kernelHorizontal, cv::Mat &kernelVertical, int size, const double sigma)
+{
+    kernelHorizontal.release();
+    kernelVertical.release();
+
+    int half = size / 2;
+
+    if (sigma <= 0.0)
+    {
+        kernelHorizontal = cv::Mat::zeros(1, size, CV_32F);
+        kernelHorizontal.at<float>(0, half) = 1.0f;
+
+        kernelVertical = cv::Mat::zeros(size, 1, CV_32F);
+        kernelVertical.at<float>(half, 0) = 1.0f;
+
+        return;
+    }
+
+    kernelHorizontal = cv::Mat(1, size, CV_32F);
+    kernelVertical = cv::Mat(size, 1, CV_32F);
+
+    double factor1 = 1.0 / (sigma * sqrt(2.0 * CV_PI));
+    double factor2 = -1.0 / (2.0 * sigma * sigma);
+
+    // horizontal kernel
+    float sum = 0.0;
+    float *pointerH = kernelHorizontal.ptr<float>(0);
+    for (int i = 0; i < size; ++i)
+    {
+        double x = double(i - half);
+        float gauss = factor1 * exp(x * x * factor2);
+        sum += gauss;
+        *pointerH++ = gauss;
+    }
+
+    // normalize horizontal kernel
+    pointerH = kernelHorizontal.ptr<float>(0);
+    for (int i = 0; i < size; ++i)
+    {
+        *pointerH++ /= sum;
+    }
+
+    // vertical kernel (use calculated values from horizontal kernel)
+    int rows = kernelVertical.rows;
+    int cols = kernelVertical.cols;
+    if (kernelVertical.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+
+    pointerH = kernelHorizontal.ptr<float>(0);
+    for (int r = 0; r < rows; ++r)
+    {
+        float *pointerV = kernelVertical.ptr<float>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            *pointerV++ = *pointerH++;
+        }
+    }
+}
+
+
+void Filter::showMatOnConsoleFloat(const cv::Mat &input, const std::string text)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+    std::cout << "\n" << text << "  \trows=" << rows << "\tcols=" << cols << "\n";
+
+    std::cout << "row\\col";
+    for (int c = 0; c < cols; ++c)
+    {
+        std::cout << "\t#" << c << "\t";
+    }
+
+    float sum = 0.0f;
+    for (int r = 0; r < rows; ++r)
+    {
+        std::cout << "\n #" << r;
+
+        for (int c = 0; c < cols; ++c)
+        {
+            float value = input.at<float>(r, c);
+            sum += value;
+            std::cout << "\t" << value;
+        }
+    }
+    std::cout << "\t-> sum=" << sum << "\n\n";
+}
+
+void Filter::showMatOnConsoleUchar(const cv::Mat &input, const std::string text)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+    std::cout << "\n" << text << "  \trows=" << rows << "\tcols=" << cols << "\n";
+
+    std::cout << "row\\col";
+    for (int c = 0; c < cols; ++c)
+    {
+        std::cout << "\t#" << c;
+    }
+
+    int sum = 0;
+    for (int r = 0; r < rows; ++r)
+    {
+        std::cout << "\n #" << r;
+
+        for (int c = 0; c < cols; ++c)
+        {
+            int value = input.at<uchar>(r, c);
+            sum += value;
+            std::cout << "\t" << value;
+        }
+    }
+    std::cout << "\t-> sum=" << sum << "\n\n";
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+void Filter::convolve_generic_normalized_float_kernel(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel)
+{
+    if (input.empty() || kernel.empty())
+    {
+        std::cout << "One ore more inputs are empty!" << std::endl;
+        return;
+    }
+
+    int rows = input.rows;
+    int cols = input.cols;
+
+    if (output.data == input.data)
+    {
+        std::cout << "The convolution can not run in place!" << std::endl;
+        return;
+    }
+
+    // only the border is not computed (the output may be a reused buffer)
+    output.create(rows, cols, CV_32F);
+    getBorder(kernel).clear(output);
+
+    //int kRows = kernel.rows;
+    //int kCols = kernel.cols;
+
+    //if (kernel.isContinuous())
+    //{
+    //    kCols = kRows * kCols;
+    //    kRows = 1;
+    //}
+
+    // perform a generic convolution with cropped edges
+    int kRows = kernel.rows;
+    int kCols = kernel.cols;
+
+    int kHotspotX = kCols / 2;
+    int kHotspotY = kRows / 2;
+
+    // perform convolution
+    for (int r = 0; r < (rows - kRows + 1); ++r)
+    {
+        float *pOutput = output.ptr<float>(r + kHotspotY) + kHotspotX;
+
+        for (int c = 0; c < (cols - kCols + 1); ++c)
+        {
+            float result = 0.0f;
+
+            for (int kr = 0; kr < kRows; ++kr)
+            {
+                const float *pInput = input.ptr<float>(r + kr) + c;
+                const float *pKernel = kernel.ptr<float>(kr);
+
+                for (int kc = 0; kc < kCols; ++kc)
+                {
+                    result += ((*pInput) * (*pKernel));
+                    ++pKernel;
+                    ++pInput;
+                }
+            }
+            *pOutput = result;
+            ++pOutput;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// convolution of a region of interest, the cropped edges are not part of the output
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::convolve_generic_normalized_float_kernel(const RoiImage &input, RoiImage &output, const cv::Mat &kernel)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_32F);
+    convolve_generic_normalized_float_kernel(input.mat, output.mat, kernel);
+
+    cv::Rect valid = getBorder(kernel).valid(input.mat.size());
+    output = RoiImage(output.mat, input.origin).cropLocal(valid);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// border of the convolutions with cropped edges: the kernel is placed at its center
+////////////////////////////////////////////////////////////////////////////////////
+Border Filter::getBorder(const cv::Mat &kernel)
+{
+    int kHotspotX = kernel.cols / 2;
+    int kHotspotY = kernel.rows / 2;
+    return Border(kHotspotX, kHotspotY, kernel.cols - 1 - kHotspotX, kernel.rows - 1 - kHotspotY);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// recursive Gaussian (Young, van Vliet: "Recursive implementation of the Gaussian
+// filter", 1995): coefficients of the forward and the backward pass
+//
+// w[n] = B * x[n] + a[0] * w[n - 1] + a[1] * w[n - 2] + a[2] * w[n - 3]
+////////////////////////////////////////////////////////////////////////////////////
+static void recursiveGaussianCoefficients(const double sigma, float *B, float *a)
+{
+    double q;
+    if (sigma >= 2.5)
+        q = 0.98711 * sigma - 0.96330;
+    else
+        q = 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * std::max(sigma, 0.5));
+
+    double q2 = q * q;
+    double q3 = q2 * q;
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    double b3 = 0.422205 * q3;
+
+    a[0] = float(b1 / b0);
+    a[1] = float(b2 / b0);
+    a[2] = float(b3 / b0);
+    *B = 1.0f - (a[0] + a[1] + a[2]); // gain 1
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// horizontal passes of one row (the recursion runs along the row, no SIMD)
+// the pixels outside of the row are the edge pixels (gain 1 -> the filter starts in its steady state)
+////////////////////////////////////////////////////////////////////////////////////
+static void recursiveGaussianRow(const float *pInput, float *pOutput, const int cols, const float B, const float *a)
+{
+    // forward
+    float w1 = pInput[0], w2 = w1, w3 = w1;
+    for (int c = 0; c < cols; ++c)
+    {
+        float w = B * pInput[c] + a[0] * w1 + a[1] * w2 + a[2] * w3;
+        pOutput[c] = w;
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+
+    // backward
+    w1 = pOutput[cols - 1], w2 = w1, w3 = w1;
+    for (int c = cols - 1; c >= 0; --c)
+    {
+        float w = B * pOutput[c] + a[0] * w1 + a[1] * w2 + a[2] * w3;
+        pOutput[c] = w;
+        w3 = w2;
+        w2 = w1;
+        w1 = w;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// kernels: one step of the vertical recursion for all columns of a row (see CpuDispatch.h)
+// the columns are independent -> SIMD across the columns
+//
+// pOutput = B * pInput + a[0] * p1 + a[1] * p2 + a[2] * p3 (p1, p2, p3: the last 3 output rows)
+// all kernels give the same results (same order of the operations, no FMA)
+////////////////////////////////////////////////////////////////////////////////////
+typedef void (*RecursiveStepFunction)(const float *pInput, const float *p1, const float *p2, const float *p3,
+                                      float *pOutput, const int first, const int cols, const float B, const float *a);
+
+static void recursiveStepScalar(const float *pInput, const float *p1, const float *p2, const float *p3,
+                                float *pOutput, const int first, const int cols, const float B, const float *a)
+{
+    for (int c = first; c < cols; ++c)
+    {
+        pOutput[c] = B * pInput[c] + a[0] * p1[c] + a[1] * p2[c] + a[2] * p3[c];
+    }
+}
+
+#ifdef CORE_X86
+CORE_TARGET_SSE2 static void recursiveStepSSE2(const float *pInput, const float *p1, const float *p2, const float *p3,
+                                               float *pOutput, const int first, const int cols, const float B,
+                                               const float *a)
+{
+    const __m128 b = _mm_set1_ps(B);
+    const __m128 a0 = _mm_set1_ps(a[0]);
+    const __m128 a1 = _mm_set1_ps(a[1]);
+    const __m128 a2 = _mm_set1_ps(a[2]);
+    int c = first;
+    for (; c + 4 <= cols; c += 4)
+    {
+        __m128 sum = _mm_mul_ps(b, _mm_loadu_ps(pInput + c));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a0, _mm_loadu_ps(p1 + c)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_loadu_ps(p2 + c)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_loadu_ps(p3 + c)));
+        _mm_storeu_ps(pOutput + c, sum);
+    }
+    recursiveStepScalar(pInput, p1, p2, p3, pOutput, c, cols, B, a);
+}
+
+CORE_TARGET_AVX2 static void recursiveStepAVX2(const float *pInput, const float *p1, const float *p2, const float *p3,
+                                               float *pOutput, const int first, const int cols, const float B,
+                                               const float *a)
+{
+    const __m256 b = _mm256_set1_ps(B);
+    const __m256 a0 = _mm256_set1_ps(a[0]);
+    const __m256 a1 = _mm256_set1_ps(a[1]);
+    const __m256 a2 = _mm256_set1_ps(a[2]);
+    int c = first;
+    for (; c + 8 <= cols; c += 8)
+    {
+        __m256 sum = _mm256_mul_ps(b, _mm256_loadu_ps(pInput + c));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a0, _mm256_loadu_ps(p1 + c)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a1, _mm256_loadu_ps(p2 + c)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a2, _mm256_loadu_ps(p3 + c)));
+        _mm256_storeu_ps(pOutput + c, sum);
+    }
+    recursiveStepScalar(pInput, p1, p2, p3, pOutput, c, cols, B, a);
+}
+#endif
+
+#ifdef CORE_NEON
+static void recursiveStepNEON(const float *pInput, const float *p1, const float *p2, const float *p3,
+                              float *pOutput, const int first, const int cols, const float B, const float *a)
+{
+    int c = first;
+    for (; c + 4 <= cols; c += 4)
+    {
+        float32x4_t sum = vmulq_n_f32(vld1q_f32(pInput + c), B);
+        sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(p1 + c), a[0]));
+        sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(p2 + c), a[1]));
+        sum = vaddq_f32(sum, vmulq_n_f32(vld1q_f32(p3 + c), a[2]));
+        vst1q_f32(pOutput + c, sum);
+    }
+    recursiveStepScalar(pInput, p1, p2, p3, pOutput, c, cols, B, a);
+}
+#endif
+
+static RecursiveStepFunction getRecursiveStep()
+{
+#if defined(CORE_X86)
+    return selectKernel<RecursiveStepFunction>(recursiveStepScalar, recursiveStepSSE2, recursiveStepAVX2, nullptr);
+#elif defined(CORE_NEON)
+    return selectKernel<RecursiveStepFunction>(recursiveStepScalar, nullptr, nullptr, recursiveStepNEON);
+#else
+    return recursiveStepScalar;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// recursive Gaussian blur: horizontal passes row by row, vertical passes for all
+// columns of a row at once (forward from the top, backward from the bottom)
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::gaussianRecursive(const cv::Mat &input, cv::Mat &output, const double sigma)
+{
+    if (input.empty() || input.type() != CV_32F)
+    {
+        std::cout << "The recursive Gaussian needs a float image (CV_32F)!" << std::endl;
+        return;
+    }
+
+    int rows = input.rows;
+    int cols = input.cols;
+    if (output.data != input.data)
+        output.create(rows, cols, CV_32F);
+
+    float B, a[3];
+    recursiveGaussianCoefficients(sigma, &B, a);
+
+    // horizontal (in place is possible: every pixel is read before it is written)
+    for (int r = 0; r < rows; ++r)
+    {
+        recursiveGaussianRow(input.ptr<float>(r), output.ptr<float>(r), cols, B, a);
+    }
+
+    // vertical: the rows outside of the image are the first (last) row
+    // (a copy, the first row of the output is overwritten by the first step)
+    static const RecursiveStepFunction recursiveStep = getRecursiveStep();
+    cv::Mat edgeRow = output.row(0).clone();
+    for (int r = 0; r < rows; ++r)
+    {
+        const float *p1 = r >= 1 ? output.ptr<float>(r - 1) : edgeRow.ptr<float>(0);
+        const float *p2 = r >= 2 ? output.ptr<float>(r - 2) : edgeRow.ptr<float>(0);
+        const float *p3 = r >= 3 ? output.ptr<float>(r - 3) : edgeRow.ptr<float>(0);
+        recursiveStep(output.ptr<float>(r), p1, p2, p3, output.ptr<float>(r), 0, cols, B, a);
+    }
+
+    output.row(rows - 1).copyTo(edgeRow);
+    for (int r = rows - 1; r >= 0; --r)
+    {
+        const float *p1 = r + 1 < rows ? output.ptr<float>(r + 1) : edgeRow.ptr<float>(0);
+        const float *p2 = r + 2 < rows ? output.ptr<float>(r + 2) : edgeRow.ptr<float>(0);
+        const float *p3 = r + 3 < rows ? output.ptr<float>(r + 3) : edgeRow.ptr<float>(0);
+        recursiveStep(output.ptr<float>(r), p1, p2, p3, output.ptr<float>(r), 0, cols, B, a);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// recursive Gaussian of a region of interest: no border, the output has the position of the input
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::gaussianRecursive(const RoiImage &input, RoiImage &output, const double sigma)
+{
+    if (output.mat.data != input.mat.data)
+        RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_32F);
+    gaussianRecursive(input.mat, output.mat, sigma);
+    output.origin = input.origin;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Gaussian blur: 2 convolutions with the 1D kernels, for a large sigma or kernel the recursive
+// Gaussian (its cost does not grow with sigma and no edges are cropped)
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::gaussianBlur(const RoiImage &input, RoiImage &output, RoiImage &intermediate,
+                          const cv::Mat &kernelHorizontal, const cv::Mat &kernelVertical, const double sigma)
+{
+    if (useRecursiveGaussian(sigma, std::max(kernelHorizontal.cols, kernelVertical.rows)))
+    {
+        gaussianRecursive(input, output, sigma);
+        return;
+    }
+    if (sigma <= 0.0)
+    {
+        // identity kernels: the convolutions would copy the pixels, only the edges are cropped
+        Border horizontal = getBorder(kernelHorizontal);
+        Border vertical = getBorder(kernelVertical);
+        cv::Rect valid = Border(horizontal.left, vertical.top, horizontal.right, vertical.bottom).valid(input.mat.size());
+        RoiImage::reuseBuffer(output.mat, valid.size(), CV_32F);
+        input.mat(valid).copyTo(output.mat);
+        output.origin = input.origin + valid.tl();
+        return;
+    }
+    convolve_generic_normalized_float_kernel(input, intermediate, kernelHorizontal);
+    convolve_generic_normalized_float_kernel(intermediate, output, kernelVertical);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// median filter (Perreault, Hebert): histograms of 16 coarse + 256 fine bins (16 bit counts)
+//
+// each column has the histogram of its 2 radius + 1 pixels of the window rows (one add and
+// one remove per row), the histogram of the window is moved along the row by adding the
+// column which enters and subtracting the column which leaves it. both do not depend on the
+// radius. the median is found in the coarse bins first, then in the 16 fine bins of its coarse bin.
+////////////////////////////////////////////////////////////////////////////////////
+static const int medianCoarseBins = 16;
+static const int medianHistogramSize = medianCoarseBins + 256;
+
+// kernels: histogram += add - subtract (all bins, see CpuDispatch.h)
+typedef void (*HistogramUpdateFunction)(ushort *pHistogram, const ushort *pAdd, const ushort *pSubtract);
+
+static void histogramUpdateScalar(ushort *pHistogram, const ushort *pAdd, const ushort *pSubtract)
+{
+    for (int i = 0; i < medianHistogramSize; ++i)
+    {
+        pHistogram[i] = ushort(pHistogram[i] + pAdd[i] - pSubtract[i]);
+    }
+}
+
+#ifdef CORE_X86
+// 8 bins per step (272 = 34 x 8)
+CORE_TARGET_SSE2 static void histogramUpdateSSE2(ushort *pHistogram, const ushort *pAdd, const ushort *pSubtract)
+{
+    for (int i = 0; i < medianHistogramSize; i += 8)
+    {
+        __m128i h = _mm_loadu_si128((const __m128i *) (pHistogram + i));
+        h = _mm_add_epi16(h, _mm_loadu_si128((const __m128i *) (pAdd + i)));
+        h = _mm_sub_epi16(h, _mm_loadu_si128((const __m128i *) (pSubtract + i)));
+        _mm_storeu_si128((__m128i *) (pHistogram + i), h);
+    }
+}
+
+// 16 bins per step (272 = 17 x 16)
+CORE_TARGET_AVX2 static void histogramUpdateAVX2(ushort *pHistogram, const ushort *pAdd, const ushort *pSubtract)
+{
+    for (int i = 0; i < medianHistogramSize; i += 16)
+    {
+        __m256i h = _mm256_loadu_si256((const __m256i *) (pHistogram + i));
+        h = _mm256_add_epi16(h, _mm256_loadu_si256((const __m256i *) (pAdd + i)));
+        h = _mm256_sub_epi16(h, _mm256_loadu_si256((const __m256i *) (pSubtract + i)));
+        _mm256_storeu_si256((__m256i *) (pHistogram + i), h);
+    }
+}
+#endif
+
+#ifdef CORE_NEON
+static void histogramUpdateNEON(ushort *pHistogram, const ushort *pAdd, const ushort *pSubtract)
+{
+    for (int i = 0; i < medianHistogramSize; i += 8)
+    {
+        uint16x8_t h = vaddq_u16(vld1q_u16(pHistogram + i), vld1q_u16(pAdd + i));
+        vst1q_u16(pHistogram + i, vsubq_u16(h, vld1q_u16(pSubtract + i)));
+    }
+}
+#endif
+
+static HistogramUpdateFunction getHistogramUpdate()
+{
+#if defined(CORE_X86)
+    return selectKernel<HistogramUpdateFunction>(histogramUpdateScalar, histogramUpdateSSE2, histogramUpdateAVX2,
+                                                 nullptr);
+#elif defined(CORE_NEON)
+    return selectKernel<HistogramUpdateFunction>(histogramUpdateScalar, nullptr, nullptr, histogramUpdateNEON);
+#else
+    return histogramUpdateScalar;
+#endif
+}
+
+// add (count 1) or remove (count -1) the pixels of a row to the column histograms
+static void updateColumnHistograms(const uchar *pInput, const int cols, const int count, ushort *pColumns)
+{
+    for (int c = 0; c < cols; ++c)
+    {
+        ushort *pHistogram = pColumns + c * medianHistogramSize;
+        pHistogram[pInput[c] >> 4] += count;
+        pHistogram[medianCoarseBins + pInput[c]] += count;
+    }
+}
+
+// value with 'rank' smaller values in the histogram
+static inline uchar histogramRank(const ushort *pHistogram, int rank)
+{
+    int coarse = 0;
+    while (rank >= pHistogram[coarse])
+    {
+        rank -= pHistogram[coarse];
+        ++coarse;
+    }
+    const ushort *pFine = pHistogram + medianCoarseBins + coarse * 16;
+    int fine = 0;
+    while (rank >= pFine[fine])
+    {
+        rank -= pFine[fine];
+        ++fine;
+    }
+    return uchar(coarse * 16 + fine);
+}
+
+// rows [rowBegin, rowEnd) of the median, each band has its own column histograms
+static void medianBand(const cv::Mat &input, cv::Mat &output, const int radius, const int rowBegin,
+                       const int rowEnd)
+{
+    // kernel of the CPU (selected at the first call)
+    static const HistogramUpdateFunction histogramUpdate = getHistogramUpdate();
+
+    int rows = input.rows;
+    int cols = input.cols;
+    int rank = (2 * radius + 1) * (2 * radius + 1) / 2;
+    auto clampRow = [rows](int r) { return std::min(std::max(r, 0), rows - 1); };
+    auto clampCol = [cols](int c) { return std::min(std::max(c, 0), cols - 1); };
+
+    // column histograms of the window rows of the first row (the rows outside are the edge rows)
+    std::vector<ushort> columns(size_t(cols) * medianHistogramSize, 0);
+    for (int r = rowBegin - radius; r <= rowBegin + radius; ++r)
+    {
+        updateColumnHistograms(input.ptr<uchar>(clampRow(r)), cols, 1, columns.data());
+    }
+
+    std::vector<ushort> window(medianHistogramSize);
+    for (int r = rowBegin; r < rowEnd; ++r)
+    {
+        if (r > rowBegin)
+        {
+            updateColumnHistograms(input.ptr<uchar>(clampRow(r - radius - 1)), cols, -1, columns.data());
+            updateColumnHistograms(input.ptr<uchar>(clampRow(r + radius)), cols, 1, columns.data());
+        }
+
+        // histogram of the window of the first pixel (the columns outside are the edge column)
+        std::fill(window.begin(), window.end(), 0);
+        for (int c = -radius; c <= radius; ++c)
+        {
+            const ushort *pColumn = columns.data() + clampCol(c) * medianHistogramSize;
+            for (int i = 0; i < medianHistogramSize; ++i)
+            {
+                window[i] += pColumn[i];
+            }
+        }
+
+        uchar *pOutput = output.ptr<uchar>(r);
+        for (int c = 0; c < cols; ++c)
+        {
+            pOutput[c] = histogramRank(window.data(), rank);
+            if (c + 1 < cols)
+                histogramUpdate(window.data(), columns.data() + clampCol(c + radius + 1) * medianHistogramSize,
+                                columns.data() + clampCol(c - radius) * medianHistogramSize);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// median filter, the rows are split into bands (one thread per band)
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::median(const cv::Mat &input, cv::Mat &output, const int radius, const int threads)
+{
+    if (input.type() != CV_8U || radius < 1 || radius > 127)
+    {
+        std::cout << "Filter: the median needs a CV_8U input and a radius of 1...127!" << std::endl;
+        return;
+    }
+    if (output.data == input.data)
+    {
+        std::cout << "Filter: the median can not run in place!" << std::endl;
+        return;
+    }
+
+    int rows = input.rows;
+    output.create(rows, input.cols, CV_8U);
+
+    // band 0 in this thread, the others in their own threads (at least 16 rows per band)
+    int bandCount = std::max(1, std::min(threads, rows / 16));
+    std::vector<std::thread> workers;
+    for (int i = 1; i < bandCount; ++i)
+    {
+        workers.push_back(std::thread(medianBand, std::cref(input), std::ref(output), radius,
+                                      rows * i / bandCount, rows * (i + 1) / bandCount));
+    }
+    medianBand(input, output, radius, 0, rows / bandCount);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// median of a region of interest: no border, the output has the position of the input
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::median(const RoiImage &input, RoiImage &output, const int radius, const int threads)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_8U);
+    median(input.mat, output.mat, radius, threads);
+    output.origin = input.origin;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// bilateral filter, separable approximation (Pham, van Vliet): a 1D bilateral filter along
+// the rows, then one along the columns of its result. weight of a neighbour:
+// space[distance] * range[|difference of the gray values|] (tables, no exp per pixel)
+////////////////////////////////////////////////////////////////////////////////////
+struct BilateralWeights
+{
+    int radius = 0;
+    std::vector<float> space; // 0...radius
+    float range[256];
+};
+
+static void bilateralRows(const cv::Mat &input, cv::Mat &output, const BilateralWeights &weights,
+                          const int rowBegin, const int rowEnd)
+{
+    int cols = input.cols;
+    int radius = weights.radius;
+    for (int r = rowBegin; r < rowEnd; ++r)
+    {
+        const uchar *pInput = input.ptr<uchar>(r);
+        uchar *pOutput = output.ptr<uchar>(r);
+        for (int c = 0; c < cols; ++c)
+        {
+            int center = pInput[c];
+            float sum = float(center);
+            float weightSum = 1.0f;
+            for (int k = 1; k <= radius; ++k)
+            {
+                // neighbours on both sides (the pixels outside are the edge pixels)
+                int left = pInput[std::max(c - k, 0)];
+                int right = pInput[std::min(c + k, cols - 1)];
+                float weightLeft = weights.space[k] * weights.range[std::abs(left - center)];
+                float weightRight = weights.space[k] * weights.range[std::abs(right - center)];
+                sum += weightLeft * left + weightRight * right;
+                weightSum += weightLeft + weightRight;
+            }
+            pOutput[c] = uchar(sum / weightSum + 0.5f);
+        }
+    }
+}
+
+// along the columns: row by row (the rows of the window are read in order, sums of a whole row)
+static void bilateralColumns(const cv::Mat &input, cv::Mat &output, const BilateralWeights &weights,
+                             const int rowBegin, const int rowEnd)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+    int radius = weights.radius;
+    std::vector<float> sum(cols), weightSum(cols);
+    for (int r = rowBegin; r < rowEnd; ++r)
+    {
+        const uchar *pCenter = input.ptr<uchar>(r);
+        for (int c = 0; c < cols; ++c)
+        {
+            sum[c] = pCenter[c];
+            weightSum[c] = 1.0f;
+        }
+        for (int k = -radius; k <= radius; ++k)
+        {
+            if (k == 0)
+                continue;
+            const uchar *pNeighbour = input.ptr<uchar>(std::min(std::max(r + k, 0), rows - 1));
+            float space = weights.space[std::abs(k)];
+            for (int c = 0; c < cols; ++c)
+            {
+                float weight = space * weights.range[std::abs(pNeighbour[c] - pCenter[c])];
+                sum[c] += weight * pNeighbour[c];
+                weightSum[c] += weight;
+            }
+        }
+
+        uchar *pOutput = output.ptr<uchar>(r);
+        for (int c = 0; c < cols; ++c)
+        {
+            pOutput[c] = uchar(sum[c] / weightSum[c] + 0.5f);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// bilateral filter: both passes are split into bands of rows (one thread per band)
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::bilateral(const cv::Mat &input, cv::Mat &output, const double sigmaSpace, const double sigmaRange,
+                       const int threads)
+{
+    if (input.type() != CV_8U || sigmaSpace <= 0.0 || sigmaRange <= 0.0)
+    {
+        std::cout << "Filter: the bilateral filter needs a CV_8U input and sigmas > 0!" << std::endl;
+        return;
+    }
+    if (output.data == input.data)
+    {
+        std::cout << "Filter: the bilateral filter can not run in place!" << std::endl;
+        return;
+    }
+
+    // weights: 2 sigma on each side
+    BilateralWeights weights;
+    weights.radius = std::max(1, int(std::ceil(2.0 * sigmaSpace)));
+    weights.space.resize(weights.radius + 1);
+    for (int k = 0; k <= weights.radius; ++k)
+    {
+        weights.space[k] = float(std::exp(-0.5 * k * k / (sigmaSpace * sigmaSpace)));
+    }
+    for (int d = 0; d < 256; ++d)
+    {
+        weights.range[d] = float(std::exp(-0.5 * d * d / (sigmaRange * sigmaRange)));
+    }
+
+    int rows = input.rows;
+    cv::Mat horizontal;
+    horizontal.create(rows, input.cols, CV_8U);
+    output.create(rows, input.cols, CV_8U);
+
+    // band 0 in this thread, the others in their own threads (at least 16 rows per band)
+    // the vertical pass needs the rows of the other bands -> it starts when all bands are finished
+    int bandCount = std::max(1, std::min(threads, rows / 16));
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        auto band = pass == 0 ? bilateralRows : bilateralColumns;
+        const cv::Mat &passInput = pass == 0 ? input : horizontal;
+        cv::Mat &passOutput = pass == 0 ? horizontal : output;
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < bandCount; ++i)
+        {
+            workers.push_back(std::thread(band, std::cref(passInput), std::ref(passOutput), std::cref(weights),
+                                          rows * i / bandCount, rows * (i + 1) / bandCount));
+        }
+        band(passInput, passOutput, weights, 0, rows / bandCount);
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// bilateral filter of a region of interest: no border, the output has the position of the input
+////////////////////////////////////////////////////////////////////////////////////
+void Filter::bilateral(const RoiImage &input, RoiImage &output, const double sigmaSpace, const double sigmaRange,
+                       const int threads)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_8U);
+    bilateral(input.mat, output.mat, sigmaSpace, sigmaRange, threads);
+    output.origin = input.origin;
+}
@@ -0,0 +1,97 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+
+class Filter
+{
+public:
+    Filter();
+
+    ~Filter();
+
+    void convolve_cv(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel);
+    void convolve_3x3(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel);
+    void convolve_generic(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel);
+    void convolve_extrapolate(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel);
+    void getAbsOfSobel(const cv::Mat &input_1, const cv::Mat &input_2, cv::Mat &output);
+    void scaleSobelImage(const cv::Mat &input, cv::Mat &output);
+    
+    cv::Mat calcBinomial(uchar size);
+    cv::Mat calcSobel(uchar size, bool transpose);
+
+    cv::Mat getBinomial(uchar size);
+    cv::Mat getBinomialSeparated(uchar size, bool transpose);
+    cv::Mat getSobelX(uchar size);
+    cv::Mat getSobelY(uchar size);
+
+
+
+
+    //cv::Mat Filter::getGaussianKernelOpenCV(const int size, const double sigma);
+    //cv::Mat Filter::getGaussianKernel(const int size, const double sigma);
+    void setGaussianKernel1D(cv::Mat &kernel, int size, const double sigma);
+    float sumOfMatElementsFloat(const cv::Mat &input);
+    void setGaussianBlur(const cv::Mat &input, cv::Mat &output, const cv::Mat kernel1D);
+
+
+    void setGaussianKernels1D(cv::Mat &kernelHorizontal, cv::Mat &kernelVertical, int size, const double sigma);
+    void showMatOnConsoleFloat(const cv::Mat &input, const std::string text);
+    void showMatOnConsoleUchar(const cv::Mat &input, const std::string text);
+    void convolve_generic_normalized_float_kernel(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel);
+
+    // output: only the pixels for which the kernel lies completely inside of the input
+    void convolve_generic_normalized_float_kernel(const RoiImage &input, RoiImage &output, const cv::Mat &kernel);
+
+    // pixels at the edges of the input which are not computed by the convolution
+    Border getBorder(const cv::Mat &kernel);
+
+    // recursive Gaussian blur (Young, van Vliet) of a float image: the cost per pixel does not depend
+    // on sigma (and the Gaussian is not truncated by a kernel size). the whole image is computed (the
+    // pixels outside are the edge pixels), in place is possible
+    void gaussianRecursive(const cv::Mat &input, cv::Mat &output, const double sigma);
+    void gaussianRecursive(const RoiImage &input, RoiImage &output, const double sigma);
+
+    // Gaussian blur with the kernels of setGaussianKernels1D (2 convolutions, cropped edges) or, for a
+    // large sigma or kernel, with the recursive Gaussian (intermediate: buffer of the horizontal convolution).
+    // sigma <= 0 (identity kernels): the same cropped part of the input without convolution
+    void gaussianBlur(const RoiImage &input, RoiImage &output, RoiImage &intermediate,
+                      const cv::Mat &kernelHorizontal, const cv::Mat &kernelVertical, const double sigma);
+
+    // the recursive Gaussian is used if it is accurate (sigma >= 1) and faster than the kernels of
+    // setGaussianKernels1D: 16 multiplications per pixel instead of 2 x kernelSize, e.g. 2 x 13 for
+    // sigma = 2 or 2 x 23 for the largest kernel of the coin detection. a kernel of 11 taps or more
+    // covers +/- 5 sigma for sigma = 1, so the result is the same up to the truncated tails
+    static bool useRecursiveGaussian(const double sigma, const int kernelSize)
+    {
+        return sigma >= 2.0 || (sigma >= 1.0 && kernelSize >= 11);
+    }
+
+    // median of the (2 radius + 1) x (2 radius + 1) window of a CV_8U image (radius 1...127): the cost
+    // per pixel does not depend on the radius (column histograms, Perreault and Hebert). edge-preserving
+    // smoothing: the rims of the coins stay sharp. the whole image is computed (the pixels outside are
+    // the edge pixels), not in place. threads: number of bands of rows (at least 16 rows per band)
+    void median(const cv::Mat &input, cv::Mat &output, const int radius, const int threads = 1);
+    void median(const RoiImage &input, RoiImage &output, const int radius, const int threads = 1);
+
+    // bilateral filter of a CV_8U image, separable approximation (1D bilateral filter along the rows,
+    // then along the columns): a neighbour (up to 2 sigmaSpace px away) is weighted by its distance and
+    // by its difference of gray values (sigmaRange), so edges are not blurred. whole image, not in place
+    void bilateral(const cv::Mat &input, cv::Mat &output, const double sigmaSpace, const double sigmaRange,
+                   const int threads = 1);
+    void bilateral(const RoiImage &input, RoiImage &output, const double sigmaSpace, const double sigmaRange,
+                   const int threads = 1);
+
+
+private:
+    cv::Mat Binomial3, Binomial5;
+    cv::Mat Binomial5x1, Binomial1x5;
+    cv::Mat Binomial3x1, Binomial1x3;
+    cv::Mat Sobel3_X, Sobel3_Y;
+    cv::Mat Sobel5_X, Sobel5_Y;
+
+    int calcBinomialCoefficient(int n, int k);
+};
+
+#endif /* FILTER_H */
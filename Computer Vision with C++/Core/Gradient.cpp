@@ -0,0 +1,418 @@
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+#include "Gradient.h"
+#include "CpuDispatch.h"
+
+#ifdef CORE_X86
+#include <immintrin.h>
+#endif
+#ifdef CORE_NEON
+#include <arm_neon.h>
+#endif
+
+Gradient::Gradient()
+{}
+
+Gradient::~Gradient()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////
+// kernels: gradient of the pixels [first, cols - 1) of a row (see CpuDispatch.h)
+//
+// pAbove, pCenter, pBelow: rows r - 1, r, r + 1 of the input
+// pOrientation: nullptr if the orientation is not needed
+//
+// all kernels give the same results: integer gradients (16 bit), the square root
+// of L2 in float (IEEE, rounded to nearest), the orientation from comparisons
+// with tan(22.5 deg) ~ 13/32 (no atan2)
+////////////////////////////////////////////////////////////////////////////////////
+typedef void (*SobelRowFunction)(const uchar *pAbove, const uchar *pCenter, const uchar *pBelow, uchar *pMagnitude,
+                                 uchar *pOrientation, const int first, const int cols, const GradientNorm norm,
+                                 const int orientationBins);
+
+static inline uchar magnitudeOf(const int gx, const int gy, const GradientNorm norm)
+{
+    int ax = std::abs(gx);
+    int ay = std::abs(gy);
+    switch (norm)
+    {
+    case GradientNorm::L1:
+        return uchar((ax + ay + 4) >> 3);
+    case GradientNorm::FastL2:
+        return uchar((8 * std::max(ax, ay) + 3 * std::min(ax, ay) + 32) >> 6);
+    default:
+        return uchar(std::lrint(std::sqrt(float(gx * gx + gy * gy)) * 0.125f)); // nearest even, like the SIMD kernels
+    }
+}
+
+static inline uchar orientationOf(const int gx, const int gy, const int orientationBins)
+{
+    int ax = std::abs(gx);
+    int ay = std::abs(gy);
+    int bin;
+    bool flip; // 8 bins: direction in the opposite half
+    if (32 * ay <= 13 * ax)
+    {
+        bin = 0;
+        flip = gx < 0;
+    }
+    else if (32 * ax <= 13 * ay)
+    {
+        bin = 2;
+        flip = gy < 0;
+    }
+    else if ((gx ^ gy) >= 0)
+    {
+        bin = 1; // same sign
+        flip = gx < 0;
+    }
+    else
+    {
+        bin = 3;
+        flip = gx > 0;
+    }
+    return uchar(orientationBins == 8 && flip ? bin + 4 : bin);
+}
+
+static void sobelRowScalar(const uchar *pAbove, const uchar *pCenter, const uchar *pBelow, uchar *pMagnitude,
+                           uchar *pOrientation, const int first, const int cols, const GradientNorm norm,
+                           const int orientationBins)
+{
+    for (int c = first; c < cols - 1; ++c)
+    {
+        int gx = (pAbove[c + 1] - pAbove[c - 1]) + 2 * (pCenter[c + 1] - pCenter[c - 1]) + (pBelow[c + 1] - pBelow[c - 1]);
+        int gy = (pBelow[c - 1] + 2 * pBelow[c] + pBelow[c + 1]) - (pAbove[c - 1] + 2 * pAbove[c] + pAbove[c + 1]);
+        pMagnitude[c] = magnitudeOf(gx, gy, norm);
+        if (pOrientation)
+            pOrientation[c] = orientationOf(gx, gy, orientationBins);
+    }
+}
+
+#ifdef CORE_X86
+// 8 pixels per step (16 bit)
+CORE_TARGET_SSE2 static void sobelRowSSE2(const uchar *pAbove, const uchar *pCenter, const uchar *pBelow,
+                                          uchar *pMagnitude, uchar *pOrientation, const int first, const int cols,
+                                          const GradientNorm norm, const int orientationBins)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int c = first;
+    for (; c + 8 <= cols - 1; c += 8)
+    {
+        __m128i a0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pAbove + c - 1)), zero);
+        __m128i a1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pAbove + c)), zero);
+        __m128i a2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pAbove + c + 1)), zero);
+        __m128i m0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pCenter + c - 1)), zero);
+        __m128i m2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pCenter + c + 1)), zero);
+        __m128i b0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pBelow + c - 1)), zero);
+        __m128i b1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pBelow + c)), zero);
+        __m128i b2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pBelow + c + 1)), zero);
+
+        __m128i gx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(a2, a0), _mm_sub_epi16(b2, b0)),
+                                   _mm_slli_epi16(_mm_sub_epi16(m2, m0), 1));
+        __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(b0, b2), _mm_slli_epi16(b1, 1)),
+                                   _mm_add_epi16(_mm_add_epi16(a0, a2), _mm_slli_epi16(a1, 1)));
+        __m128i ax = _mm_max_epi16(gx, _mm_sub_epi16(zero, gx));
+        __m128i ay = _mm_max_epi16(gy, _mm_sub_epi16(zero, gy));
+
+        __m128i magnitude;
+        if (norm == GradientNorm::L1)
+            magnitude = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(ax, ay), _mm_set1_epi16(4)), 3);
+        else if (norm == GradientNorm::FastL2)
+        {
+            __m128i large = _mm_max_epi16(ax, ay);
+            __m128i small = _mm_min_epi16(ax, ay);
+            __m128i sum = _mm_add_epi16(_mm_slli_epi16(large, 3), _mm_add_epi16(small, _mm_slli_epi16(small, 1)));
+            magnitude = _mm_srli_epi16(_mm_add_epi16(sum, _mm_set1_epi16(32)), 6);
+        }
+        else
+        {
+            // gx^2 + gy^2 (32 bit) with one multiply-add of the interleaved gradients
+            __m128i low = _mm_unpacklo_epi16(gx, gy);
+            __m128i high = _mm_unpackhi_epi16(gx, gy);
+            __m128 scale = _mm_set1_ps(0.125f);
+            __m128i lengthLow = _mm_cvtps_epi32(_mm_mul_ps(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(low, low))), scale));
+            __m128i lengthHigh = _mm_cvtps_epi32(_mm_mul_ps(_mm_sqrt_ps(_mm_cvtepi32_ps(_mm_madd_epi16(high, high))), scale));
+            magnitude = _mm_packs_epi32(lengthLow, lengthHigh);
+        }
+        _mm_storel_epi64((__m128i *) (pMagnitude + c), _mm_packus_epi16(magnitude, zero));
+
+        if (pOrientation)
+        {
+            __m128i notHorizontal = _mm_cmpgt_epi16(_mm_slli_epi16(ay, 5), _mm_mullo_epi16(ax, _mm_set1_epi16(13)));
+            __m128i notVertical = _mm_cmpgt_epi16(_mm_slli_epi16(ax, 5), _mm_mullo_epi16(ay, _mm_set1_epi16(13)));
+            __m128i vertical = _mm_andnot_si128(notVertical, notHorizontal);
+            __m128i diagonal = _mm_and_si128(notHorizontal, notVertical);
+            __m128i opposite = _mm_cmpgt_epi16(zero, _mm_xor_si128(gx, gy));
+
+            __m128i two = _mm_set1_epi16(2);
+            __m128i diagonalBin = _mm_or_si128(_mm_set1_epi16(1), _mm_and_si128(opposite, two));
+            __m128i bin = _mm_or_si128(_mm_and_si128(vertical, two), _mm_and_si128(diagonal, diagonalBin));
+
+            if (orientationBins == 8)
+            {
+                __m128i gxNegative = _mm_cmpgt_epi16(zero, gx);
+                __m128i gxPositive = _mm_cmpgt_epi16(gx, zero);
+                __m128i gyNegative = _mm_cmpgt_epi16(zero, gy);
+                // horizontal and diagonal (same sign): gx < 0, vertical: gy < 0, diagonal (opposite sign): gx > 0
+                __m128i flip = _mm_or_si128(_mm_andnot_si128(notHorizontal, gxNegative), _mm_and_si128(vertical, gyNegative));
+                flip = _mm_or_si128(flip, _mm_and_si128(diagonal, _mm_andnot_si128(opposite, gxNegative)));
+                flip = _mm_or_si128(flip, _mm_and_si128(diagonal, _mm_and_si128(opposite, gxPositive)));
+                bin = _mm_add_epi16(bin, _mm_and_si128(flip, _mm_set1_epi16(4)));
+            }
+            _mm_storel_epi64((__m128i *) (pOrientation + c), _mm_packus_epi16(bin, zero));
+        }
+    }
+    sobelRowScalar(pAbove, pCenter, pBelow, pMagnitude, pOrientation, c, cols, norm, orientationBins);
+}
+
+// the same with 16 pixels per step
+CORE_TARGET_AVX2 static void sobelRowAVX2(const uchar *pAbove, const uchar *pCenter, const uchar *pBelow,
+                                          uchar *pMagnitude, uchar *pOrientation, const int first, const int cols,
+                                          const GradientNorm norm, const int orientationBins)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    int c = first;
+    for (; c + 16 <= cols - 1; c += 16)
+    {
+        __m256i a0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pAbove + c - 1)));
+        __m256i a1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pAbove + c)));
+        __m256i a2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pAbove + c + 1)));
+        __m256i m0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pCenter + c - 1)));
+        __m256i m2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pCenter + c + 1)));
+        __m256i b0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pBelow + c - 1)));
+        __m256i b1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pBelow + c)));
+        __m256i b2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (pBelow + c + 1)));
+
+        __m256i gx = _mm256_add_epi16(_mm256_add_epi16(_mm256_sub_epi16(a2, a0), _mm256_sub_epi16(b2, b0)),
+                                      _mm256_slli_epi16(_mm256_sub_epi16(m2, m0), 1));
+        __m256i gy = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(b0, b2), _mm256_slli_epi16(b1, 1)),
+                                      _mm256_add_epi16(_mm256_add_epi16(a0, a2), _mm256_slli_epi16(a1, 1)));
+        __m256i ax = _mm256_abs_epi16(gx);
+        __m256i ay = _mm256_abs_epi16(gy);
+
+        __m256i magnitude;
+        if (norm == GradientNorm::L1)
+            magnitude = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(ax, ay), _mm256_set1_epi16(4)), 3);
+        else if (norm == GradientNorm::FastL2)
+        {
+            __m256i large = _mm256_max_epi16(ax, ay);
+            __m256i small = _mm256_min_epi16(ax, ay);
+            __m256i sum = _mm256_add_epi16(_mm256_slli_epi16(large, 3),
+                                           _mm256_add_epi16(small, _mm256_slli_epi16(small, 1)));
+            magnitude = _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(32)), 6);
+        }
+        else
+        {
+            // unpack/pack work within the 128 bit lanes -> the order of the pixels is kept
+            __m256i low = _mm256_unpacklo_epi16(gx, gy);
+            __m256i high = _mm256_unpackhi_epi16(gx, gy);
+            __m256 scale = _mm256_set1_ps(0.125f);
+            __m256i lengthLow = _mm256_cvtps_epi32(
+                _mm256_mul_ps(_mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(low, low))), scale));
+            __m256i lengthHigh = _mm256_cvtps_epi32(
+                _mm256_mul_ps(_mm256_sqrt_ps(_mm256_cvtepi32_ps(_mm256_madd_epi16(high, high))), scale));
+            magnitude = _mm256_packs_epi32(lengthLow, lengthHigh);
+        }
+        // 16 bit -> 8 bit: packus interleaves the lanes, the permutation collects the results
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(magnitude, magnitude), 0x08);
+        _mm_storeu_si128((__m128i *) (pMagnitude + c), _mm256_castsi256_si128(packed));
+
+        if (pOrientation)
+        {
+            __m256i notHorizontal = _mm256_cmpgt_epi16(_mm256_slli_epi16(ay, 5),
+                                                       _mm256_mullo_epi16(ax, _mm256_set1_epi16(13)));
+            __m256i notVertical = _mm256_cmpgt_epi16(_mm256_slli_epi16(ax, 5),
+                                                     _mm256_mullo_epi16(ay, _mm256_set1_epi16(13)));
+            __m256i vertical = _mm256_andnot_si256(notVertical, notHorizontal);
+            __m256i diagonal = _mm256_and_si256(notHorizontal, notVertical);
+            __m256i opposite = _mm256_cmpgt_epi16(zero, _mm256_xor_si256(gx, gy));
+
+            __m256i two = _mm256_set1_epi16(2);
+            __m256i diagonalBin = _mm256_or_si256(_mm256_set1_epi16(1), _mm256_and_si256(opposite, two));
+            __m256i bin = _mm256_or_si256(_mm256_and_si256(vertical, two), _mm256_and_si256(diagonal, diagonalBin));
+
+            if (orientationBins == 8)
+            {
+                __m256i gxNegative = _mm256_cmpgt_epi16(zero, gx);
+                __m256i gxPositive = _mm256_cmpgt_epi16(gx, zero);
+                __m256i gyNegative = _mm256_cmpgt_epi16(zero, gy);
+                __m256i flip = _mm256_or_si256(_mm256_andnot_si256(notHorizontal, gxNegative),
+                                               _mm256_and_si256(vertical, gyNegative));
+                flip = _mm256_or_si256(flip, _mm256_and_si256(diagonal, _mm256_andnot_si256(opposite, gxNegative)));
+                flip = _mm256_or_si256(flip, _mm256_and_si256(diagonal, _mm256_and_si256(opposite, gxPositive)));
+                bin = _mm256_add_epi16(bin, _mm256_and_si256(flip, _mm256_set1_epi16(4)));
+            }
+            packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(bin, bin), 0x08);
+            _mm_storeu_si128((__m128i *) (pOrientation + c), _mm256_castsi256_si128(packed));
+        }
+    }
+    sobelRowScalar(pAbove, pCenter, pBelow, pMagnitude, pOrientation, c, cols, norm, orientationBins);
+}
+#endif
+
+#ifdef CORE_NEON
+// 8 pixels per step (L2 needs the square root of 64 bit ARM)
+static void sobelRowNEON(const uchar *pAbove, const uchar *pCenter, const uchar *pBelow, uchar *pMagnitude,
+                         uchar *pOrientation, const int first, const int cols, const GradientNorm norm,
+                         const int orientationBins)
+{
+#ifndef __aarch64__
+    if (norm == GradientNorm::L2)
+    {
+        sobelRowScalar(pAbove, pCenter, pBelow, pMagnitude, pOrientation, first, cols, norm, orientationBins);
+        return;
+    }
+#endif
+    const int16x8_t zero = vdupq_n_s16(0);
+    int c = first;
+    for (; c + 8 <= cols - 1; c += 8)
+    {
+        int16x8_t a0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pAbove + c - 1)));
+        int16x8_t a1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pAbove + c)));
+        int16x8_t a2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pAbove + c + 1)));
+        int16x8_t m0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pCenter + c - 1)));
+        int16x8_t m2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pCenter + c + 1)));
+        int16x8_t b0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pBelow + c - 1)));
+        int16x8_t b1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pBelow + c)));
+        int16x8_t b2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(pBelow + c + 1)));
+
+        int16x8_t gx = vaddq_s16(vaddq_s16(vsubq_s16(a2, a0), vsubq_s16(b2, b0)), vshlq_n_s16(vsubq_s16(m2, m0), 1));
+        int16x8_t gy = vsubq_s16(vaddq_s16(vaddq_s16(b0, b2), vshlq_n_s16(b1, 1)),
+                                 vaddq_s16(vaddq_s16(a0, a2), vshlq_n_s16(a1, 1)));
+        int16x8_t ax = vabsq_s16(gx);
+        int16x8_t ay = vabsq_s16(gy);
+
+        int16x8_t magnitude = zero;
+        if (norm == GradientNorm::L1)
+            magnitude = vshrq_n_s16(vaddq_s16(vaddq_s16(ax, ay), vdupq_n_s16(4)), 3);
+        else if (norm == GradientNorm::FastL2)
+        {
+            int16x8_t large = vmaxq_s16(ax, ay);
+            int16x8_t small = vminq_s16(ax, ay);
+            int16x8_t sum = vaddq_s16(vshlq_n_s16(large, 3), vaddq_s16(small, vshlq_n_s16(small, 1)));
+            magnitude = vshrq_n_s16(vaddq_s16(sum, vdupq_n_s16(32)), 6);
+        }
+        else
+        {
+#ifdef __aarch64__
+            int32x4_t squaresLow = vmlal_s16(vmull_s16(vget_low_s16(gx), vget_low_s16(gx)), vget_low_s16(gy), vget_low_s16(gy));
+            int32x4_t squaresHigh = vmlal_s16(vmull_s16(vget_high_s16(gx), vget_high_s16(gx)), vget_high_s16(gy), vget_high_s16(gy));
+            int32x4_t lengthLow = vcvtnq_s32_f32(vmulq_n_f32(vsqrtq_f32(vcvtq_f32_s32(squaresLow)), 0.125f));
+            int32x4_t lengthHigh = vcvtnq_s32_f32(vmulq_n_f32(vsqrtq_f32(vcvtq_f32_s32(squaresHigh)), 0.125f));
+            magnitude = vcombine_s16(vqmovn_s32(lengthLow), vqmovn_s32(lengthHigh));
+#endif
+        }
+        vst1_u8(pMagnitude + c, vqmovun_s16(magnitude));
+
+        if (pOrientation)
+        {
+            uint16x8_t notHorizontal = vcgtq_s16(vshlq_n_s16(ay, 5), vmulq_n_s16(ax, 13));
+            uint16x8_t notVertical = vcgtq_s16(vshlq_n_s16(ax, 5), vmulq_n_s16(ay, 13));
+            uint16x8_t vertical = vbicq_u16(notHorizontal, notVertical);
+            uint16x8_t diagonal = vandq_u16(notHorizontal, notVertical);
+            uint16x8_t opposite = vcltq_s16(veorq_s16(gx, gy), zero);
+
+            uint16x8_t two = vdupq_n_u16(2);
+            uint16x8_t diagonalBin = vorrq_u16(vdupq_n_u16(1), vandq_u16(opposite, two));
+            uint16x8_t bin = vorrq_u16(vandq_u16(vertical, two), vandq_u16(diagonal, diagonalBin));
+
+            if (orientationBins == 8)
+            {
+                uint16x8_t gxNegative = vcltq_s16(gx, zero);
+                uint16x8_t gxPositive = vcgtq_s16(gx, zero);
+                uint16x8_t gyNegative = vcltq_s16(gy, zero);
+                uint16x8_t flip = vorrq_u16(vbicq_u16(gxNegative, notHorizontal), vandq_u16(vertical, gyNegative));
+                flip = vorrq_u16(flip, vandq_u16(diagonal, vbicq_u16(gxNegative, opposite)));
+                flip = vorrq_u16(flip, vandq_u16(diagonal, vandq_u16(opposite, gxPositive)));
+                bin = vaddq_u16(bin, vandq_u16(flip, vdupq_n_u16(4)));
+            }
+            vst1_u8(pOrientation + c, vmovn_u16(bin));
+        }
+    }
+    sobelRowScalar(pAbove, pCenter, pBelow, pMagnitude, pOrientation, c, cols, norm, orientationBins);
+}
+#endif
+
+static SobelRowFunction getSobelRow()
+{
+#if defined(CORE_X86)
+    return selectKernel<SobelRowFunction>(sobelRowScalar, sobelRowSSE2, sobelRowAVX2, nullptr);
+#elif defined(CORE_NEON)
+    return selectKernel<SobelRowFunction>(sobelRowScalar, nullptr, nullptr, sobelRowNEON);
+#else
+    return sobelRowScalar;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Sobel gradient: magnitude and orientation in one pass over the input
+////////////////////////////////////////////////////////////////////////////////////
+void Gradient::sobel(const cv::Mat &input, cv::Mat &magnitude, cv::Mat *orientation, const GradientNorm norm,
+                     const int orientationBins)
+{
+    if (input.empty() || input.type() != CV_8U)
+    {
+        std::cout << "Gradient: the input must be a grayscale image (CV_8U)!" << std::endl;
+        return;
+    }
+    if (orientationBins != 4 && orientationBins != 8)
+    {
+        std::cout << "Gradient: 4 or 8 orientation bins!" << std::endl;
+        return;
+    }
+    if (magnitude.data == input.data || (orientation && orientation->data == input.data))
+    {
+        std::cout << "Gradient: can not run in place!" << std::endl;
+        return;
+    }
+
+    int rows = input.rows;
+    int cols = input.cols;
+    magnitude.create(rows, cols, CV_8U);
+    getBorder().clear(magnitude);
+    if (orientation)
+    {
+        orientation->create(rows, cols, CV_8U);
+        getBorder().clear(*orientation);
+    }
+
+    // kernel of the CPU (selected at the first call)
+    static const SobelRowFunction sobelRow = getSobelRow();
+    for (int r = 1; r < rows - 1; ++r)
+    {
+        sobelRow(input.ptr<uchar>(r - 1), input.ptr<uchar>(r), input.ptr<uchar>(r + 1), magnitude.ptr<uchar>(r),
+                 orientation ? orientation->ptr<uchar>(r) : nullptr, 1, cols, norm, orientationBins);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Sobel gradient of a region of interest, the edges are not part of the outputs
+////////////////////////////////////////////////////////////////////////////////////
+void Gradient::sobel(const RoiImage &input, RoiImage &magnitude, RoiImage *orientation, const GradientNorm norm,
+                     const int orientationBins)
+{
+    RoiImage::reuseBuffer(magnitude.mat, input.mat.size(), CV_8U);
+    if (orientation)
+        RoiImage::reuseBuffer(orientation->mat, input.mat.size(), CV_8U);
+    sobel(input.mat, magnitude.mat, orientation ? &orientation->mat : nullptr, norm, orientationBins);
+
+    cv::Rect valid = getBorder().valid(input.mat.size());
+    magnitude = RoiImage(magnitude.mat, input.origin).cropLocal(valid);
+    if (orientation)
+        *orientation = RoiImage(orientation->mat, input.origin).cropLocal(valid);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// direction of the center of a bin (4 and 8 bins: 45 deg per bin)
+////////////////////////////////////////////////////////////////////////////////////
+float Gradient::binDirection(const int bin, const int orientationBins)
+{
+    return float(bin % orientationBins) * float(CV_PI / 4);
+}
+
+int Gradient::binOf(const int gx, const int gy, const int orientationBins)
+{
+    return orientationOf(gx, gy, orientationBins);
+}
@@ -0,0 +1,48 @@
+#ifndef GRADIENT_H
+#define GRADIENT_H
+
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+
+// norm of the gradient (gx, gy)
+enum class GradientNorm
+{
+    L1,    // |gx| + |gy|
+    L2,    // sqrt(gx^2 + gy^2)
+    FastL2 // max + 3/8 min (at most 7% too large, no square root)
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// 3x3 Sobel gradient in one pass: every neighbourhood is read once and gives
+// magnitude and orientation (instead of 2 convolutions + getAbsOfSobel + scaleSobelImage)
+////////////////////////////////////////////////////////////////////////////////////
+class Gradient
+{
+public:
+    Gradient();
+    ~Gradient();
+
+    // input: CV_8U
+    // magnitude (CV_8U): norm(gx, gy) / 8, rounded (the scale of convolve_3x3 with getSobelX/Y)
+    // orientation (CV_8U, optional): bin of the direction of (gx, gy), 45 deg per bin
+    //   4 bins (0..180 deg, e.g. for non-maximum suppression): 0: horizontal, 1: 45 deg, 2: vertical, 3: 135 deg
+    //   8 bins (0..360 deg, e.g. for the Hough transformation): bin = angle / 45 deg (y axis downwards)
+    // the pixels at the edges (1 px) are set to 0
+    void sobel(const cv::Mat &input, cv::Mat &magnitude, cv::Mat *orientation,
+               const GradientNorm norm = GradientNorm::L2, const int orientationBins = 4);
+
+    // regions of interest: the outputs contain only pixels which were computed
+    void sobel(const RoiImage &input, RoiImage &magnitude, RoiImage *orientation,
+               const GradientNorm norm = GradientNorm::L2, const int orientationBins = 4);
+
+    // direction (rad) of the center of an orientation bin
+    static float binDirection(const int bin, const int orientationBins);
+
+    // orientation bin of a gradient (gx, gy), see 'sobel'
+    static int binOf(const int gx, const int gy, const int orientationBins);
+
+    // pixels at the edges of the input which are not computed
+    Border getBorder() const { return Border(1, 1, 1, 1); }
+};
+
+#endif /* GRADIENT_H */
@@ -0,0 +1,341 @@
+#include <iostream>
+#include <climits>
+#include <algorithm>
+#include <thread>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "HoughAccumulator.h"
+
+// key of a cell of the sparse accumulator (64 bit: fine grids of large images have more than 2^32 cells)
+static inline uint64_t cellKey(const int row, const int col, const int cols)
+{
+    return uint64_t(int64_t(row) * cols + col);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// one vote for each cell type (the vote loop is a template, so each type gets its own loop)
+////////////////////////////////////////////////////////////////////////////////////
+struct VoteInt32
+{
+    typedef int Cell;
+    static inline void add(Cell *pCell, const Cell *, std::unordered_map<int, int> *) { ++*pCell; }
+};
+
+struct VoteUInt16
+{
+    typedef ushort Cell;
+    // saturated: +1 unless the cell is full (no branch)
+    static inline void add(Cell *pCell, const Cell *, std::unordered_map<int, int> *)
+    {
+        *pCell += Cell(*pCell != USHRT_MAX);
+    }
+};
+
+struct VoteUInt8
+{
+    typedef uchar Cell;
+    // a full cell counts the next votes in the side table (rare: only near the centers of circles)
+    static inline void add(Cell *pCell, const Cell *pCells, std::unordered_map<int, int> *spill)
+    {
+        if (*pCell != UCHAR_MAX)
+            ++*pCell;
+        else
+            ++(*spill)[int(pCell - pCells)];
+    }
+};
+
+template <typename Vote>
+static void voteCells(cv::Mat &cells, std::unordered_map<int, int> *spill, const short *pX, const short *pY,
+                      const int count, const int scale, const std::vector<int> &offsets)
+{
+    typedef typename Vote::Cell Cell;
+    Cell *pCells = cells.ptr<Cell>(0);
+    int cols = cells.cols;
+    for (int i = 0; i < count; ++i)
+    {
+        Cell *pCenter = pCells + ptrdiff_t(scale * pY[i]) * cols + scale * pX[i];
+        for (auto offset : offsets)
+        {
+            Vote::add(pCenter + offset, pCells, spill);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// allocate and clear the cells
+////////////////////////////////////////////////////////////////////////////////////
+void HoughAccumulator::reset(const int accumulatorRows, const int accumulatorCols,
+                             const AccumulatorType accumulatorType)
+{
+    type = accumulatorType;
+    rows = accumulatorRows;
+    cols = accumulatorCols;
+    spill.clear();
+
+    if (type == AccumulatorType::Sparse)
+    {
+        cells.release();
+        tables.resize(std::max(1, threads));
+        for (auto &table : tables)
+        {
+            table.clear();
+        }
+        return;
+    }
+
+    int cellType = type == AccumulatorType::UInt16 ? CV_16U : type == AccumulatorType::UInt8 ? CV_8U : CV_32S;
+    cells.create(rows, cols, cellType);
+    cells.setTo(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// add the votes of edge pixels
+////////////////////////////////////////////////////////////////////////////////////
+void HoughAccumulator::vote(const short *pX, const short *pY, const int count, const int scale,
+                            const std::vector<int> &offsets)
+{
+    if (type == AccumulatorType::Sparse)
+        voteSparse(pX, pY, count, scale, offsets);
+    else if (type == AccumulatorType::UInt16)
+        voteCells<VoteUInt16>(cells, &spill, pX, pY, count, scale, offsets);
+    else if (type == AccumulatorType::UInt8)
+        voteCells<VoteUInt8>(cells, &spill, pX, pY, count, scale, offsets);
+    else
+        voteCells<VoteInt32>(cells, &spill, pX, pY, count, scale, offsets);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// number of votes of a cell (CV_8U: + side table)
+////////////////////////////////////////////////////////////////////////////////////
+int HoughAccumulator::value(const int row, const int col) const
+{
+    if (type == AccumulatorType::Sparse)
+    {
+        const SparseCells::Entry *pEntry = tables[0].find(cellKey(row, col, cols));
+        return pEntry ? pEntry->votes : 0;
+    }
+    if (type == AccumulatorType::UInt16)
+        return cells.ptr<ushort>(row)[col];
+    if (type == AccumulatorType::Int32)
+        return cells.ptr<int>(row)[col];
+
+    int votes = cells.ptr<uchar>(row)[col];
+    if (votes == UCHAR_MAX)
+    {
+        auto extra = spill.find(row * cells.cols + col);
+        if (extra != spill.end())
+            votes += extra->second;
+    }
+    return votes;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// maximum of a region of the accumulator
+////////////////////////////////////////////////////////////////////////////////////
+cv::Point HoughAccumulator::findMaximum(const cv::Rect &region, int *value) const
+{
+    // sparse: only the entries (equal votes: the first cell in row order, like minMaxLoc)
+    if (type == AccumulatorType::Sparse)
+    {
+        uint64_t bestKey = SparseCells::emptyKey;
+        int bestVotes = 0;
+        for (const auto &entry : tables[0].entries)
+        {
+            if (entry.key == SparseCells::emptyKey || entry.votes < bestVotes ||
+                (entry.votes == bestVotes && entry.key > bestKey))
+                continue;
+            if (!region.contains(cv::Point(int(entry.key % cols), int(entry.key / cols))))
+                continue;
+            bestKey = entry.key;
+            bestVotes = entry.votes;
+        }
+        *value = bestVotes;
+        if (bestVotes < 1)
+            return region.tl();
+        return cv::Point(int(bestKey % cols), int(bestKey / cols));
+    }
+
+    cv::Point point;
+    double max = 0.0;
+    cv::minMaxLoc(cells(region), nullptr, &max, nullptr, &point);
+    point += region.tl();
+    *value = int(max);
+
+    // full 8 bit cells: the one with the most votes in the side table (cells which were removed
+    // are 0, so their entries are ignored). equal votes: the first cell in row order, like minMaxLoc
+    if (type != AccumulatorType::UInt8 || *value != UCHAR_MAX || spill.empty())
+        return point;
+
+    const uchar *pCells = cells.ptr<uchar>(0);
+    int bestIndex = -1;
+    int bestVotes = 0;
+    for (const auto &extra : spill)
+    {
+        int row = extra.first / cells.cols;
+        int col = extra.first % cells.cols;
+        if (pCells[extra.first] != UCHAR_MAX || !region.contains(cv::Point(col, row)))
+            continue;
+        if (extra.second > bestVotes || (extra.second == bestVotes && extra.first < bestIndex))
+        {
+            bestIndex = extra.first;
+            bestVotes = extra.second;
+        }
+    }
+    if (bestIndex < 0)
+        return point;
+
+    *value += bestVotes;
+    return cv::Point(bestIndex % cells.cols, bestIndex / cells.cols);
+}
+
+cv::Point HoughAccumulator::findMaximum(int *value) const
+{
+    return findMaximum(cv::Rect(0, 0, cols, rows), value);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// remove a maximum and its neighbourhood
+////////////////////////////////////////////////////////////////////////////////////
+void HoughAccumulator::removeCircle(const cv::Point center, const int radius)
+{
+    if (type != AccumulatorType::Sparse)
+    {
+        cv::circle(cells, center, radius, cv::Scalar(0, 0, 0), -1);
+        return;
+    }
+
+    // sparse: the cells of the same filled circle (drawn into a mask) are set to 0
+    cv::Mat mask = cv::Mat::zeros(2 * radius + 1, 2 * radius + 1, CV_8U);
+    cv::circle(mask, cv::Point(radius, radius), radius, cv::Scalar(255, 255, 255), -1);
+    for (int dy = 0; dy < mask.rows; ++dy)
+    {
+        int row = center.y + dy - radius;
+        if (row < 0 || row >= rows)
+            continue;
+        const uchar *pMask = mask.ptr<uchar>(dy);
+        for (int dx = 0; dx < mask.cols; ++dx)
+        {
+            int col = center.x + dx - radius;
+            if (pMask[dx] == 0 || col < 0 || col >= cols)
+                continue;
+            SparseCells::Entry *pEntry = tables[0].find(cellKey(row, col, cols));
+            if (pEntry)
+                pEntry->votes = 0;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// sparse accumulator: the edge pixels are split into threads, each thread votes into
+// its own table, then the tables are merged into table 0
+////////////////////////////////////////////////////////////////////////////////////
+void HoughAccumulator::voteSparse(const short *pX, const short *pY, const int count, const int scale,
+                                  const std::vector<int> &offsets)
+{
+    // at least 256 edge pixels per thread
+    int tableCount = std::max(1, std::min(int(tables.size()), count / 256));
+    auto voteTable = [&](int i)
+    {
+        SparseCells &table = tables[i];
+        for (int p = count * i / tableCount; p < count * (i + 1) / tableCount; ++p)
+        {
+            int64_t center = int64_t(scale * pY[p]) * cols + scale * pX[p];
+            for (auto offset : offsets)
+            {
+                table.add(uint64_t(center + offset), 1);
+            }
+        }
+    };
+
+    // table 0 in this thread, the others in their own threads
+    std::vector<std::thread> workers;
+    for (int i = 1; i < tableCount; ++i)
+    {
+        workers.push_back(std::thread(voteTable, i));
+    }
+    voteTable(0);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (int i = 1; i < tableCount; ++i)
+    {
+        for (const auto &entry : tables[i].entries)
+        {
+            if (entry.key != SparseCells::emptyKey)
+                tables[0].add(entry.key, entry.votes);
+        }
+        tables[i].clear();
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// hash table of the sparse accumulator
+////////////////////////////////////////////////////////////////////////////////////
+// slot of a key: multiplicative hash, the upper bits are mixed into the lower ones
+static inline size_t sparseSlot(const uint64_t key, const size_t mask)
+{
+    uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    return size_t(hash ^ (hash >> 32)) & mask;
+}
+
+void HoughAccumulator::SparseCells::clear()
+{
+    if (entries.empty())
+        entries.resize(1024);
+    std::fill(entries.begin(), entries.end(), Entry{emptyKey, 0});
+    count = 0;
+}
+
+void HoughAccumulator::SparseCells::add(const uint64_t key, const int votes)
+{
+    // at most half full (short probe sequences)
+    if (2 * (count + 1) > int(entries.size()))
+        grow();
+
+    size_t mask = entries.size() - 1;
+    size_t slot = sparseSlot(key, mask);
+    while (entries[slot].key != key && entries[slot].key != emptyKey)
+    {
+        slot = (slot + 1) & mask;
+    }
+    if (entries[slot].key == emptyKey)
+    {
+        entries[slot].key = key;
+        ++count;
+    }
+    entries[slot].votes += votes;
+}
+
+HoughAccumulator::SparseCells::Entry *HoughAccumulator::SparseCells::find(const uint64_t key)
+{
+    size_t mask = entries.size() - 1;
+    size_t slot = sparseSlot(key, mask);
+    while (entries[slot].key != emptyKey)
+    {
+        if (entries[slot].key == key)
+            return &entries[slot];
+        slot = (slot + 1) & mask;
+    }
+    return nullptr;
+}
+
+const HoughAccumulator::SparseCells::Entry *HoughAccumulator::SparseCells::find(const uint64_t key) const
+{
+    return const_cast<SparseCells *>(this)->find(key);
+}
+
+// double the size and insert the entries again
+void HoughAccumulator::SparseCells::grow()
+{
+    std::vector<Entry> old(entries.size() * 2, Entry{emptyKey, 0});
+    old.swap(entries);
+    count = 0;
+    for (const auto &entry : old)
+    {
+        if (entry.key != emptyKey)
+            add(entry.key, entry.votes);
+    }
+}
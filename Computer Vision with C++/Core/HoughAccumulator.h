@@ -0,0 +1,89 @@
+#ifndef HOUGHACCUMULATOR_H
+#define HOUGHACCUMULATOR_H
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <opencv2/core/core.hpp>
+
+// cell type of an accumulator of the circle Hough transformation
+enum class AccumulatorType
+{
+    Int32,  // CV_32S
+    UInt16, // CV_16U: half the memory, saturated at 65535 votes
+    UInt8,  // CV_8U: a quarter of the memory, the votes above 255 are counted in a sparse side table
+    Sparse  // hash table of the cells which got votes (no dense cells, see below)
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// accumulator of the circle Hough transformation with a selectable cell type
+//
+// at cellStep = 0.2 a VGA image needs (640 + 2r) x (480 + 2r) x 25 cells per radius, i.e.
+// ~30 MB with 32 bit cells. 16 or 8 bit cells read and write 2 or 4 times less memory,
+// so more of the accumulator stays in the cache while the votes are added.
+// only a few cells (the centers of circles) get more than 255 votes, these are
+// counted exactly in the side table, so 8 bit cells give the same maxima as 32 bit cells.
+//
+// sparse: the number of votes does not depend on the cell step, the number of cells grows
+// with 1 / cellStep^2. for fine grids (and large images) most cells get no vote, so only the
+// cells with votes are stored: open addressing hash table (key: cell index, 16 byte per entry,
+// at most half full), nothing to clear and the maximum is searched in the entries only.
+// the keys have 64 bit, a fine grid of a large image can have more than 2^32 cells.
+// the votes can be split into threads (one table per thread, merged afterwards).
+// same maxima as the dense cell types.
+////////////////////////////////////////////////////////////////////////////////////
+class HoughAccumulator
+{
+public:
+    // allocate the cells (the buffer is reused if it has the same size and type) and set them to 0
+    // (sparse: the tables are emptied, their memory is kept)
+    void reset(const int rows, const int cols, const AccumulatorType type);
+
+    // votes of edge pixels: +1 in the cells (scale * y) * cols + scale * x + offset for all offsets
+    // (the offsets of the circle are added to the cell of the edge pixel, see Segmentation::houghCircle)
+    void vote(const short *pX, const short *pY, const int count, const int scale, const std::vector<int> &offsets);
+
+    // number of votes of a cell
+    int value(const int row, const int col) const;
+
+    // cell with the most votes inside of 'region' (the first in row order), value < 1: no votes
+    cv::Point findMaximum(const cv::Rect &region, int *value) const;
+    cv::Point findMaximum(int *value) const;
+
+    // set the cells of a filled circle to 0 (so the next maximum can be found)
+    void removeCircle(const cv::Point center, const int radius);
+
+    AccumulatorType type = AccumulatorType::Int32;
+    int rows = 0, cols = 0;             // size of the accumulator (cells)
+    int threads = 1;                    // sparse: number of threads (tables) of 'vote'
+    cv::Mat cells;                      // CV_32S, CV_16U or CV_8U (continuous), empty if sparse
+    std::unordered_map<int, int> spill; // CV_8U: cell index -> votes above 255
+
+private:
+    // hash table of the sparse accumulator (linear probing, the size is a power of 2)
+    struct SparseCells
+    {
+        struct Entry
+        {
+            uint64_t key; // cell index (emptyKey: free)
+            int votes;    // 0: removed
+        };
+        static const uint64_t emptyKey = UINT64_MAX;
+
+        std::vector<Entry> entries;
+        int count = 0;
+
+        void clear();
+        void add(const uint64_t key, const int votes);
+        Entry *find(const uint64_t key);
+        const Entry *find(const uint64_t key) const;
+        void grow();
+    };
+
+    void voteSparse(const short *pX, const short *pY, const int count, const int scale,
+                    const std::vector<int> &offsets);
+
+    std::vector<SparseCells> tables; // sparse: one table per thread, the votes are merged into table 0
+};
+
+#endif /* HOUGHACCUMULATOR_H */
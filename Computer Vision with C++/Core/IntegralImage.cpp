@@ -0,0 +1,424 @@
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "IntegralImage.h"
+#include "CpuDispatch.h"
+
+#ifdef CORE_X86
+#include <immintrin.h>
+#endif
+#ifdef CORE_NEON
+#include <arm_neon.h>
+#endif
+
+IntegralImage::IntegralImage()
+{}
+
+IntegralImage::~IntegralImage()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////
+// kernels: prefix sums of the pixels [first, cols) of a row (see CpuDispatch.h)
+//
+// pSums[c] = pixel 0 + ... + pixel c (pSquares the same with the squares, nullptr: not computed)
+// the SIMD kernels add a few pixels in 32 bit (exact) and continue the sum of the row in double,
+// so all kernels give the same (exact) results
+////////////////////////////////////////////////////////////////////////////////////
+typedef void (*PrefixRowFunction)(const uchar *pInput, double *pSums, double *pSquares, const int first,
+                                  const int cols);
+
+static void prefixRowScalar(const uchar *pInput, double *pSums, double *pSquares, const int first, const int cols)
+{
+    double sum = first > 0 ? pSums[first - 1] : 0.0;
+    for (int c = first; c < cols; ++c)
+    {
+        sum += pInput[c];
+        pSums[c] = sum;
+    }
+
+    if (!pSquares)
+        return;
+    double sumSquares = first > 0 ? pSquares[first - 1] : 0.0;
+    for (int c = first; c < cols; ++c)
+    {
+        sumSquares += pInput[c] * pInput[c];
+        pSquares[c] = sumSquares;
+    }
+}
+
+#ifdef CORE_X86
+// prefix sums of 4 lanes (32 bit)
+CORE_TARGET_SSE2 static inline __m128i scan4(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+    return _mm_add_epi32(v, _mm_slli_si128(v, 8));
+}
+
+// 8 pixels (32 bit) + the sum of the row before them -> 8 doubles, returns the new sum of the row
+CORE_TARGET_SSE2 static inline __m128d storeScan8(__m128i low, __m128i high, __m128d carry, double *pOutput)
+{
+    low = scan4(low);
+    high = _mm_add_epi32(scan4(high), _mm_shuffle_epi32(low, 0xFF));
+    __m128d d0 = _mm_add_pd(_mm_cvtepi32_pd(low), carry);
+    __m128d d1 = _mm_add_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(low, 0x0E)), carry);
+    __m128d d2 = _mm_add_pd(_mm_cvtepi32_pd(high), carry);
+    __m128d d3 = _mm_add_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(high, 0x0E)), carry);
+    _mm_storeu_pd(pOutput, d0);
+    _mm_storeu_pd(pOutput + 2, d1);
+    _mm_storeu_pd(pOutput + 4, d2);
+    _mm_storeu_pd(pOutput + 6, d3);
+    return _mm_unpackhi_pd(d3, d3);
+}
+
+// 8 pixels per step
+CORE_TARGET_SSE2 static void prefixRowSSE2(const uchar *pInput, double *pSums, double *pSquares, const int first,
+                                           const int cols)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128d carry = _mm_set1_pd(first > 0 ? pSums[first - 1] : 0.0);
+    __m128d carrySquares = _mm_set1_pd(first > 0 && pSquares ? pSquares[first - 1] : 0.0);
+    int c = first;
+    for (; c + 8 <= cols; c += 8)
+    {
+        __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (pInput + c)), zero);
+        __m128i low = _mm_unpacklo_epi16(pixels, zero);
+        __m128i high = _mm_unpackhi_epi16(pixels, zero);
+        carry = storeScan8(low, high, carry, pSums + c);
+        if (pSquares)
+        {
+            // (the upper 16 bit are 0 -> madd gives the square of each 32 bit lane)
+            carrySquares = storeScan8(_mm_madd_epi16(low, low), _mm_madd_epi16(high, high), carrySquares,
+                                      pSquares + c);
+        }
+    }
+    prefixRowScalar(pInput, pSums, pSquares, c, cols);
+}
+
+// 8 pixels (32 bit) + the sum of the row before them -> 8 doubles, returns the new sum of the row
+CORE_TARGET_AVX2 static inline __m256d storeScan8(__m256i v, __m256d carry, double *pOutput)
+{
+    // scan within the 128 bit lanes, then the sum of the lower lane is added to the upper one
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+    v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+    __m256i last = _mm256_shuffle_epi32(v, 0xFF);
+    v = _mm256_add_epi32(v, _mm256_permute2x128_si256(last, last, 0x08));
+
+    __m256d d0 = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(v)), carry);
+    __m256d d1 = _mm256_add_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(v, 1)), carry);
+    _mm256_storeu_pd(pOutput, d0);
+    _mm256_storeu_pd(pOutput + 4, d1);
+    return _mm256_permute4x64_pd(d1, 0xFF);
+}
+
+// the same with AVX2 (8 pixels per step, 4 doubles per register)
+CORE_TARGET_AVX2 static void prefixRowAVX2(const uchar *pInput, double *pSums, double *pSquares, const int first,
+                                           const int cols)
+{
+    __m256d carry = _mm256_set1_pd(first > 0 ? pSums[first - 1] : 0.0);
+    __m256d carrySquares = _mm256_set1_pd(first > 0 && pSquares ? pSquares[first - 1] : 0.0);
+    int c = first;
+    for (; c + 8 <= cols; c += 8)
+    {
+        __m256i pixels = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (pInput + c)));
+        carry = storeScan8(pixels, carry, pSums + c);
+        if (pSquares)
+            carrySquares = storeScan8(_mm256_mullo_epi32(pixels, pixels), carrySquares, pSquares + c);
+    }
+    prefixRowScalar(pInput, pSums, pSquares, c, cols);
+}
+#endif
+
+#if defined(CORE_NEON) && defined(__aarch64__)
+// 4 pixels (32 bit) + the sum of the row before them -> 4 doubles, returns the new sum of the row
+static inline double storeScan4(uint32x4_t v, const double carry, double *pOutput)
+{
+    const uint32x4_t zero = vdupq_n_u32(0);
+    v = vaddq_u32(v, vextq_u32(zero, v, 3));
+    v = vaddq_u32(v, vextq_u32(zero, v, 2));
+    float64x2_t d0 = vaddq_f64(vcvtq_f64_u64(vmovl_u32(vget_low_u32(v))), vdupq_n_f64(carry));
+    float64x2_t d1 = vaddq_f64(vcvtq_f64_u64(vmovl_u32(vget_high_u32(v))), vdupq_n_f64(carry));
+    vst1q_f64(pOutput, d0);
+    vst1q_f64(pOutput + 2, d1);
+    return vgetq_lane_f64(d1, 1);
+}
+
+// 4 pixels per step (doubles need 64 bit ARM)
+static void prefixRowNEON(const uchar *pInput, double *pSums, double *pSquares, const int first, const int cols)
+{
+    double carry = first > 0 ? pSums[first - 1] : 0.0;
+    double carrySquares = first > 0 && pSquares ? pSquares[first - 1] : 0.0;
+    int c = first;
+    for (; c + 8 <= cols; c += 8)
+    {
+        uint16x8_t pixels = vmovl_u8(vld1_u8(pInput + c));
+        uint32x4_t low = vmovl_u16(vget_low_u16(pixels));
+        uint32x4_t high = vmovl_u16(vget_high_u16(pixels));
+        carry = storeScan4(low, carry, pSums + c);
+        carry = storeScan4(high, carry, pSums + c + 4);
+        if (pSquares)
+        {
+            carrySquares = storeScan4(vmulq_u32(low, low), carrySquares, pSquares + c);
+            carrySquares = storeScan4(vmulq_u32(high, high), carrySquares, pSquares + c + 4);
+        }
+    }
+    prefixRowScalar(pInput, pSums, pSquares, c, cols);
+}
+#endif
+
+static PrefixRowFunction getPrefixRow()
+{
+#if defined(CORE_X86)
+    return selectKernel<PrefixRowFunction>(prefixRowScalar, prefixRowSSE2, prefixRowAVX2, nullptr);
+#elif defined(CORE_NEON) && defined(__aarch64__)
+    return selectKernel<PrefixRowFunction>(prefixRowScalar, nullptr, nullptr, prefixRowNEON);
+#else
+    return prefixRowScalar;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// run job(0) ... job(count - 1) at the same time (job 0 in this thread)
+////////////////////////////////////////////////////////////////////////////////////
+static void runStripes(const int count, const std::function<void(int)> &job)
+{
+    std::vector<std::thread> workers;
+    for (int i = 1; i < count; ++i)
+    {
+        workers.push_back(std::thread(job, i));
+    }
+    job(0);
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+// number of stripes: at least 'minimum' rows (columns) per thread
+static int stripeCount(const int threads, const int length, const int minimum)
+{
+    return std::max(1, std::min(threads, length / minimum));
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// integral image: prefix sums of the rows (row bands), then the sums of the
+// columns (column stripes, the rows of a stripe are added from top to bottom)
+////////////////////////////////////////////////////////////////////////////////////
+void IntegralImage::compute(const cv::Mat &input, const bool withSquares, const int threads)
+{
+    if (input.empty() || (input.type() != CV_8U && input.type() != CV_32F))
+    {
+        std::cout << "IntegralImage: the input must be CV_8U or CV_32F!" << std::endl;
+        return;
+    }
+
+    int rows = input.rows;
+    int cols = input.cols;
+    sums.create(rows + 1, cols + 1, CV_64F);
+    sums.row(0).setTo(0);
+    if (withSquares)
+    {
+        squares.create(rows + 1, cols + 1, CV_64F);
+        squares.row(0).setTo(0);
+    }
+    else
+        squares.release();
+
+    // kernel of the CPU (selected at the first call)
+    static const PrefixRowFunction prefixRow = getPrefixRow();
+
+    // prefix sums of the rows -> row r + 1 (column 0 is 0)
+    int bands = stripeCount(threads, rows, 64);
+    runStripes(bands, [&](int band)
+    {
+        for (int r = rows * band / bands; r < rows * (band + 1) / bands; ++r)
+        {
+            double *pSums = sums.ptr<double>(r + 1);
+            double *pSquares = withSquares ? squares.ptr<double>(r + 1) : nullptr;
+            pSums[0] = 0.0;
+            if (pSquares)
+                pSquares[0] = 0.0;
+
+            if (input.type() == CV_8U)
+            {
+                prefixRow(input.ptr<uchar>(r), pSums + 1, pSquares ? pSquares + 1 : nullptr, 0, cols);
+                continue;
+            }
+
+            const float *pInput = input.ptr<float>(r);
+            double sum = 0.0, sumSquares = 0.0;
+            for (int c = 0; c < cols; ++c)
+            {
+                sum += pInput[c];
+                pSums[c + 1] = sum;
+                if (pSquares)
+                {
+                    sumSquares += double(pInput[c]) * pInput[c];
+                    pSquares[c + 1] = sumSquares;
+                }
+            }
+        }
+    });
+
+    // sums of the columns (independent columns -> the compiler vectorizes the inner loop)
+    int stripes = stripeCount(threads, cols + 1, 256);
+    runStripes(stripes, [&](int stripe)
+    {
+        int first = (cols + 1) * stripe / stripes;
+        int last = (cols + 1) * (stripe + 1) / stripes;
+        for (int r = 2; r <= rows; ++r)
+        {
+            const double *pAbove = sums.ptr<double>(r - 1);
+            double *pSums = sums.ptr<double>(r);
+            for (int c = first; c < last; ++c)
+            {
+                pSums[c] += pAbove[c];
+            }
+            if (!withSquares)
+                continue;
+            pAbove = squares.ptr<double>(r - 1);
+            pSums = squares.ptr<double>(r);
+            for (int c = first; c < last; ++c)
+            {
+                pSums[c] += pAbove[c];
+            }
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// sum of a window: 4 values of the integral image
+////////////////////////////////////////////////////////////////////////////////////
+static inline double windowSum(const cv::Mat &integral, const cv::Rect &window)
+{
+    const double *pTop = integral.ptr<double>(window.y);
+    const double *pBottom = integral.ptr<double>(window.y + window.height);
+    return pBottom[window.x + window.width] - pBottom[window.x] - pTop[window.x + window.width] + pTop[window.x];
+}
+
+double IntegralImage::sum(const cv::Rect &window) const
+{
+    return windowSum(sums, window);
+}
+
+double IntegralImage::sumOfSquares(const cv::Rect &window) const
+{
+    return windowSum(squares, window);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// box filter: mean of the window around each pixel (constant time for any window size)
+////////////////////////////////////////////////////////////////////////////////////
+void IntegralImage::boxFilter(const cv::Mat &input, cv::Mat &output, const cv::Size &window, const int threads)
+{
+    windowMeans(input, output, nullptr, window, threads);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// box filter of a region of interest, the cropped edges are not part of the output
+////////////////////////////////////////////////////////////////////////////////////
+void IntegralImage::boxFilter(const RoiImage &input, RoiImage &output, const cv::Size &window, const int threads)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_32F);
+    boxFilter(input.mat, output.mat, window, threads);
+
+    cv::Rect valid = getBorder(window).valid(input.mat.size());
+    output = RoiImage(output.mat, input.origin).cropLocal(valid);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// local mean and variance: variance = mean of the squares - square of the mean
+////////////////////////////////////////////////////////////////////////////////////
+void IntegralImage::meanVariance(const cv::Mat &input, cv::Mat &mean, cv::Mat &variance, const cv::Size &window,
+                                 const int threads)
+{
+    windowMeans(input, mean, &variance, window, threads);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// mean (and variance, if not nullptr) of the windows, the rows are split into bands for the threads
+////////////////////////////////////////////////////////////////////////////////////
+void IntegralImage::windowMeans(const cv::Mat &input, cv::Mat &mean, cv::Mat *variance, const cv::Size &window,
+                                const int threads)
+{
+    if (window.width < 1 || window.height < 1)
+    {
+        std::cout << "IntegralImage: the window must have at least 1 pixel!" << std::endl;
+        return;
+    }
+    if (mean.data == input.data || (variance && variance->data == input.data))
+    {
+        std::cout << "IntegralImage: can not run in place (input CV_8U or CV_32F, output CV_32F)!" << std::endl;
+        return;
+    }
+
+    bool withVariance = variance != nullptr;
+    compute(input, withVariance, threads);
+    if (sums.empty())
+        return;
+
+    int rows = input.rows;
+    int cols = input.cols;
+    Border border = getBorder(window);
+    mean.create(rows, cols, CV_32F);
+    border.clear(mean);
+    if (withVariance)
+    {
+        variance->create(rows, cols, CV_32F);
+        border.clear(*variance);
+    }
+
+    cv::Rect valid = border.valid(input.size());
+    double scale = 1.0 / window.area();
+    int bands = stripeCount(threads, valid.height, 64);
+    runStripes(bands, [&](int band)
+    {
+        int first = valid.y + valid.height * band / bands;
+        int last = valid.y + valid.height * (band + 1) / bands;
+        for (int r = first; r < last; ++r)
+        {
+            // integral rows above and below the window
+            int top = r - border.top;
+            const double *pTop = sums.ptr<double>(top);
+            const double *pBottom = sums.ptr<double>(top + window.height);
+            float *pMean = mean.ptr<float>(r);
+            if (!withVariance)
+            {
+                for (int c = valid.x; c < valid.x + valid.width; ++c)
+                {
+                    int x0 = c - border.left;
+                    int x1 = x0 + window.width;
+                    pMean[c] = float((pBottom[x1] - pBottom[x0] - pTop[x1] + pTop[x0]) * scale);
+                }
+                continue;
+            }
+
+            // variance with the mean in double precision (only the results are rounded to float,
+            // the difference of the two means would lose the digits of the rounded mean)
+            const double *pTopSquares = squares.ptr<double>(top);
+            const double *pBottomSquares = squares.ptr<double>(top + window.height);
+            float *pVariance = variance->ptr<float>(r);
+            for (int c = valid.x; c < valid.x + valid.width; ++c)
+            {
+                int x0 = c - border.left;
+                int x1 = x0 + window.width;
+                double meanValue = (pBottom[x1] - pBottom[x0] - pTop[x1] + pTop[x0]) * scale;
+                double meanOfSquares = (pBottomSquares[x1] - pBottomSquares[x0] - pTopSquares[x1] + pTopSquares[x0]) * scale;
+                pMean[c] = float(meanValue);
+                pVariance[c] = float(std::max(0.0, meanOfSquares - meanValue * meanValue));
+            }
+        }
+    });
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// border of a window: placed like a kernel of its size (at its center)
+////////////////////////////////////////////////////////////////////////////////////
+Border IntegralImage::getBorder(const cv::Size &window) const
+{
+    int left = window.width / 2;
+    int top = window.height / 2;
+    return Border(left, top, window.width - 1 - left, window.height - 1 - top);
+}
@@ -0,0 +1,51 @@
+#ifndef INTEGRALIMAGE_H
+#define INTEGRALIMAGE_H
+
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+
+////////////////////////////////////////////////////////////////////////////////////
+// integral image (summed-area table) and integral of the squares
+//
+// sums(y, x) = sum of the input pixels above and left of (x, y): (rows + 1) x (cols + 1),
+// the first row and column are 0. the sum of any window needs 4 values, so box filters
+// and local mean / variance cost the same for every window size.
+//
+// 64 bit (CV_64F): exact for CV_8U inputs (integers up to 2^53, i.e. the squares of
+// more than 10^11 pixels). the prefix sums of the rows use SIMD (see CpuDispatch.h),
+// the rows and the column pass are split into stripes for the threads.
+////////////////////////////////////////////////////////////////////////////////////
+class IntegralImage
+{
+public:
+    IntegralImage();
+    ~IntegralImage();
+
+    // integral of an image (CV_8U or CV_32F), squares: integral of the squares too
+    void compute(const cv::Mat &input, const bool squares = false, const int threads = 1);
+
+    // sum of a window of the input (must be inside of the input)
+    double sum(const cv::Rect &window) const;
+    double sumOfSquares(const cv::Rect &window) const;
+
+    // mean of the window around each pixel (CV_8U or CV_32F input, CV_32F output)
+    // the window is placed like a kernel of its size (see Filter::getBorder), the edges are cropped
+    void boxFilter(const cv::Mat &input, cv::Mat &output, const cv::Size &window, const int threads = 1);
+    void boxFilter(const RoiImage &input, RoiImage &output, const cv::Size &window, const int threads = 1);
+
+    // mean and variance of the window around each pixel (CV_32F outputs, cropped edges)
+    void meanVariance(const cv::Mat &input, cv::Mat &mean, cv::Mat &variance, const cv::Size &window,
+                      const int threads = 1);
+
+    // pixels at the edges of the input which are not computed
+    Border getBorder(const cv::Size &window) const;
+
+    cv::Mat sums;    // CV_64F, (rows + 1) x (cols + 1)
+    cv::Mat squares; // CV_64F, empty if not computed
+
+private:
+    void windowMeans(const cv::Mat &input, cv::Mat &mean, cv::Mat *variance, const cv::Size &window,
+                     const int threads);
+};
+
+#endif /* INTEGRALIMAGE_H */
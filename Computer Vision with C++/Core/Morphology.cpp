@@ -54,6 +54,17 @@ cv::Mat Morphology::getKernelFull(int size)
     return kernel3x3Full;
 }
 
+////////////////////////////////////////////////////////////////////////////////////
+// border of dilate and erode (see their loops): the kernel is placed at its reference
+// point, the last row and column of the input are not computed
+////////////////////////////////////////////////////////////////////////////////////
+Border Morphology::getBorder(const cv::Mat &kernel)
+{
+    int refPointX = (kernel.cols - 1) / 2;
+    int refPointY = (kernel.rows - 1) / 2;
+    return Border(refPointX, refPointY, kernel.cols - refPointX, kernel.rows - refPointY);
+}
+
 void Morphology::dilate(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel)
 {
     if (input.empty() || kernel.empty())
@@ -71,8 +82,15 @@ void Morphology::dilate(const cv::Mat &input, cv::Mat &output, const cv::Mat &ke
     int refPointX = (kCols - 1) / 2; 
     int refPointY = (kRows - 1) / 2;
 
-    output.release();
-    output = cv::Mat::zeros(rows, cols, CV_8U);
+    if (output.data == input.data)
+    {
+        std::cout << "dilate can not run in place!" << std::endl;
+        return;
+    }
+
+    // only the border is not computed (the output may be a reused buffer)
+    output.create(rows, cols, CV_8U);
+    getBorder(kernel).clear(output);
 
     for (int r = 0; r < rows - kRows; ++r)
     {
@@ -123,8 +141,15 @@ void Morphology::erode(const cv::Mat &input, cv::Mat &output, const cv::Mat &ker
     int refPointX = (kCols - 1) / 2; 
     int refPointY = (kRows - 1) / 2;
 
-    output.release();
-    output = cv::Mat::zeros(rows, cols, CV_8U);
+    if (output.data == input.data)
+    {
+        std::cout << "erode can not run in place!" << std::endl;
+        return;
+    }
+
+    // only the border is not computed (the output may be a reused buffer)
+    output.create(rows, cols, CV_8U);
+    getBorder(kernel).clear(output);
 
     for (int r = 0; r < rows - kRows; ++r)
     {
@@ -158,7 +183,7 @@ void Morphology::erode(const cv::Mat &input, cv::Mat &output, const cv::Mat &ker
     }
 }
 
-void Morphology::subtract(const cv::Mat &input, cv::Mat &output, const cv::Mat &subtract)
+void Morphology::subtract(const cv::Mat &input, cv::Mat &output, const cv::Mat &subtract, EdgePoints *points)
 {
     if (input.empty() || subtract.empty())
     {
@@ -175,10 +200,14 @@ void Morphology::subtract(const cv::Mat &input, cv::Mat &output, const cv::Mat &
         return;
     }
 
-    output.release();
-    output = cv::Mat::zeros(rows, cols, CV_8U);
+    // every pixel is computed, can run in place (output is input or subtract)
+    output.create(rows, cols, CV_8U);
+
+    // edge point list: collected row by row while the row is in the cache
+    if (points)
+        points->reset(cv::Size(cols, rows));
 
-    if (input.isContinuous() && output.isContinuous() && subtract.isContinuous())
+    if (!points && input.isContinuous() && output.isContinuous() && subtract.isContinuous())
     {
         cols = rows * cols;
         rows = 1;
@@ -195,5 +224,46 @@ void Morphology::subtract(const cv::Mat &input, cv::Mat &output, const cv::Mat &
             int value = *pInput++ - *pSubtract++;
             *pOutput++ = value > 0 ? value : 0;
         }
+
+        if (points)
+            points->appendRow(output.ptr<uchar>(r), r);
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////////
+// morphology of regions of interest
+////////////////////////////////////////////////////////////////////////////////////
+void Morphology::dilate(const RoiImage &input, RoiImage &output, const cv::Mat &kernel)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_8U);
+    dilate(input.mat, output.mat, kernel);
+
+    cv::Rect valid = getBorder(kernel).valid(input.mat.size());
+    output = RoiImage(output.mat, input.origin).cropLocal(valid);
+}
+
+void Morphology::erode(const RoiImage &input, RoiImage &output, const cv::Mat &kernel)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_8U);
+    erode(input.mat, output.mat, kernel);
+
+    cv::Rect valid = getBorder(kernel).valid(input.mat.size());
+    output = RoiImage(output.mat, input.origin).cropLocal(valid);
+}
+
+void Morphology::subtract(const RoiImage &input, RoiImage &output, const RoiImage &subtract, EdgePoints *points)
+{
+    cv::Rect common = input.rect() & subtract.rect();
+    RoiImage part = input.crop(common);
+
+    // in place: write into the common part of the input
+    if (output.mat.data == input.mat.data && output.mat.size() == input.mat.size())
+        output.mat = part.mat;
+    else
+        RoiImage::reuseBuffer(output.mat, common.size(), CV_8U);
+
+    this->subtract(part.mat, output.mat, subtract.crop(common).mat, points);
+    output.origin = common.tl();
+    if (points)
+        points->origin = common.tl();
+}
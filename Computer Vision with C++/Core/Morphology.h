@@ -0,0 +1,38 @@
+#ifndef MORPHOLOGICLAL_H
+#define MORPHOLOGICLAL_H
+
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+#include "EdgePoints.h"
+
+class Morphology
+{
+public:
+    Morphology();
+    ~Morphology();
+
+    void dilate(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel);
+    void erode(const cv::Mat &input, cv::Mat &output, const cv::Mat &kernel);
+    // points: optional list of the non-zero pixels of the output (e.g. edge pixels)
+    void subtract(const cv::Mat &input, cv::Mat &output, const cv::Mat &subtract, EdgePoints *points = nullptr);
+
+    // regions of interest: the output contains only pixels which were computed
+    // (dilate/erode: without the border, subtract: intersection of both inputs)
+    void dilate(const RoiImage &input, RoiImage &output, const cv::Mat &kernel);
+    void erode(const RoiImage &input, RoiImage &output, const cv::Mat &kernel);
+    void subtract(const RoiImage &input, RoiImage &output, const RoiImage &subtract, EdgePoints *points = nullptr);
+
+    // pixels at the edges of the input which are not computed by dilate and erode
+    Border getBorder(const cv::Mat &kernel);
+
+    cv::Mat getKernelPlus();
+    cv::Mat getKernelLine();
+    cv::Mat getKernelFull(int size);
+
+private:
+    cv::Mat kernel3x3Plus;
+    cv::Mat kernel1x5Line;
+    cv::Mat kernel3x3Full, kernel4x4Full;
+};
+
+#endif /* MORPHOLOGICLAL_H */
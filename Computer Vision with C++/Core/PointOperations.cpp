@@ -0,0 +1,264 @@
+#include <iostream>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "PointOperations.h"
+#include "CpuDispatch.h"
+
+#ifdef CORE_NEON
+#include <arm_neon.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+// kernels for one row: BGR -> gray = (29 * b + 150 * g + 77 * r) >> 8 (see CpuDispatch.h)
+// (the weights of the OpenCV conversion scaled by 256)
+////////////////////////////////////////////////////////////////////////////////////
+typedef void (*GrayscaleRowFunction)(const uchar *pInput, uchar *pOutput, const int cols);
+
+static void grayscaleRowScalar(const uchar *pInput, uchar *pOutput, const int cols)
+{
+    for (int c = 0; c < cols; ++c)
+    {
+        int b = *pInput++;
+        int g = *pInput++;
+        int r = *pInput++;
+        *pOutput++ = uchar((29 * b + 150 * g + 77 * r) >> 8);
+    }
+}
+
+#ifdef CORE_NEON
+static void grayscaleRowNEON(const uchar *pInput, uchar *pOutput, const int cols)
+{
+    const uint8x8_t bFactor = vdup_n_u8(29);
+    const uint8x8_t gFactor = vdup_n_u8(150);
+    const uint8x8_t rFactor = vdup_n_u8(77);
+    int c = 0;
+    for (; c + 8 <= cols; c += 8)
+    {
+        uint8x8x3_t bgr = vld3_u8(pInput + 3 * c);
+        uint16x8_t sum = vmull_u8(bgr.val[0], bFactor);
+        sum = vmlal_u8(sum, bgr.val[1], gFactor);
+        sum = vmlal_u8(sum, bgr.val[2], rFactor);
+        vst1_u8(pOutput + c, vshrn_n_u16(sum, 8));
+    }
+    grayscaleRowScalar(pInput + 3 * c, pOutput + c, cols - c);
+}
+#endif
+
+static GrayscaleRowFunction getGrayscaleRow()
+{
+#if defined(CORE_NEON)
+    return selectKernel<GrayscaleRowFunction>(grayscaleRowScalar, nullptr, nullptr, grayscaleRowNEON);
+#else
+    return grayscaleRowScalar;
+#endif
+}
+
+
+PointOperations::PointOperations()
+{}
+
+PointOperations::~PointOperations()
+{}
+////////////////////////////////////////////////////////////////////////////////////
+// adjust the contrast of an image by alpha around center
+////////////////////////////////////////////////////////////////////////////////////
+void PointOperations::adjustContrast(const cv::Mat &input, cv::Mat &output, float alpha, uchar center)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    // (no new allocation if the output has the right size, e.g. in place)
+    output.create(rows, cols, CV_8U);
+
+    if (input.isContinuous() && output.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const uchar *pInput = input.ptr<uchar>(r);
+        uchar *pOutput = output.ptr<uchar>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            // calculate new brightness level for the pixel
+            float adjusted = alpha*(*pInput-center)+center;
+
+            // limit the values (saturation point and zero point)
+            if (adjusted > 255)
+                adjusted = 255;
+            else if (adjusted < 0)
+                adjusted = 0;
+
+            // set the new brightness in output image
+            *pOutput = (uchar) adjusted;
+
+            ++pInput;
+            ++pOutput;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// adjust the brightness of an image by alpha
+////////////////////////////////////////////////////////////////////////////////////
+void PointOperations::adjustBrightness(const cv::Mat &input, cv::Mat &output, int alpha)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    // (no new allocation if the output has the right size, e.g. in place)
+    output.create(rows, cols, CV_8U);
+
+    if (input.isContinuous() && output.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const uchar *pInput = input.ptr<uchar>(r);
+        uchar *pOutput = output.ptr<uchar>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            // calculate new brightness level for the pixel
+            int adjusted = *pInput+alpha;
+
+            // limit the values (saturation point and zero point)
+            if (adjusted > 255)
+                adjusted = 255;
+            else if (adjusted < 0)
+                adjusted = 0;
+
+            // set the new brightness in output image; note the implicit cast to uchar
+            *pOutput = adjusted;
+
+            ++pInput;
+            ++pOutput;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// inversion of an image
+////////////////////////////////////////////////////////////////////////////////////
+void PointOperations::invert(const cv::Mat &input, cv::Mat &output)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    // (no new allocation if the output has the right size, e.g. in place)
+    output.create(rows, cols, CV_8U);
+
+    if (input.isContinuous() && output.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const uchar *pInput = input.ptr<uchar>(r);
+        uchar *pOutput = output.ptr<uchar>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            // invert input and set the new brightness in output image
+            *pOutput = 255 - *pInput;
+
+            ++pInput;
+            ++pOutput;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// quantization of an image with n bits
+////////////////////////////////////////////////////////////////////////////////////
+void PointOperations::quantize(const cv::Mat &input, cv::Mat &output, uchar n)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    // (no new allocation if the output has the right size, e.g. in place)
+    output.create(rows, cols, CV_8U);
+
+    if (input.isContinuous() && output.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const uchar *pInput = input.ptr<uchar>(r);
+        uchar *pOutput = output.ptr<uchar>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            // calculate new brightness level for the pixel
+            // using shift operations
+            uchar shift = (8 - n);
+            // integer division and multiplication
+            uchar adjusted = (*pInput >> shift) << shift;
+            // obtain central position by adding half of the interval size
+            adjusted += (128 >> n);
+
+            // set the new brightness in output image
+            *pOutput = adjusted;
+
+            ++pInput;
+            ++pOutput;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// convert a BGR image (CV_8UC3) to grayscale
+////////////////////////////////////////////////////////////////////////////////////
+void PointOperations::grayscale(const cv::Mat &input, cv::Mat &output)
+{
+    if (input.type() != CV_8UC3)
+    {
+        std::cout << "PointOperations::grayscale: the input must be a BGR image (CV_8UC3)" << std::endl;
+        return;
+    }
+
+    static const GrayscaleRowFunction grayscaleRow = getGrayscaleRow();
+
+    int rows = input.rows;
+    int cols = input.cols;
+
+    output.create(rows, cols, CV_8U);
+
+    if (input.isContinuous() && output.isContinuous())
+    {
+        cols = rows * cols;
+        rows = 1;
+    }
+
+    for (int r = 0; r < rows; ++r)
+        grayscaleRow(input.ptr<uchar>(r), output.ptr<uchar>(r), cols);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// point operations of a region of interest (same origin, can run in place)
+////////////////////////////////////////////////////////////////////////////////////
+void PointOperations::adjustContrast(const RoiImage &input, RoiImage &output, float alpha, uchar center)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_8U);
+    adjustContrast(input.mat, output.mat, alpha, center);
+    output.origin = input.origin;
+}
+
+void PointOperations::adjustBrightness(const RoiImage &input, RoiImage &output, int alpha)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_8U);
+    adjustBrightness(input.mat, output.mat, alpha);
+    output.origin = input.origin;
+}
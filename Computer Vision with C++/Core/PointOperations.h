@@ -0,0 +1,29 @@
+#ifndef POINTOPS_H
+#define POINTOPS_H
+
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+
+class PointOperations
+{
+public:
+    PointOperations();
+
+    ~PointOperations();
+
+    // all point operations can run in place (input and output are the same image)
+    // and write into an output view of the size of the input
+    void adjustContrast(const cv::Mat &input, cv::Mat &output, float alpha, uchar center=127);
+    void adjustBrightness(const cv::Mat &input, cv::Mat &output, int alpha);
+    void adjustContrast(const RoiImage &input, RoiImage &output, float alpha, uchar center=127);
+    void adjustBrightness(const RoiImage &input, RoiImage &output, int alpha);
+    void invert(const cv::Mat &input, cv::Mat &output);
+    void quantize(const cv::Mat &input, cv::Mat &output, uchar n);
+
+    // BGR image (CV_8UC3) -> grayscale (CV_8U), integer weights (NEON kernel on ARM)
+    void grayscale(const cv::Mat &input, cv::Mat &output);
+
+private:
+};
+
+#endif /* POINTOPS_H */
@@ -0,0 +1,103 @@
+#ifndef ROIIMAGE_H
+#define ROIIMAGE_H
+
+#include <algorithm>
+
+#include <opencv2/core/core.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////
+// border requirement of an operator: number of pixels at each edge of the input
+// for which no output is computed (the kernel does not fit completely into the
+// input). point operations, threshold and subtract have no border.
+////////////////////////////////////////////////////////////////////////////////////
+struct Border
+{
+    int left, top, right, bottom;
+
+    Border(const int left = 0, const int top = 0, const int right = 0, const int bottom = 0)
+        : left(left), top(top), right(right), bottom(bottom) {}
+
+    // computed part of an output of 'size' (coordinates of the output)
+    cv::Rect valid(const cv::Size &size) const
+    {
+        return cv::Rect(left, top, std::max(0, size.width - left - right), std::max(0, size.height - top - bottom));
+    }
+
+    // set the pixels of the border to zero (the output may be a reused buffer)
+    void clear(cv::Mat &output) const
+    {
+        cv::Rect inner = valid(output.size());
+        output.rowRange(0, std::min(top, output.rows)).setTo(0);
+        output.rowRange(std::max(top, inner.y + inner.height), output.rows).setTo(0);
+        output.colRange(0, std::min(left, output.cols)).setTo(0);
+        output.colRange(std::max(left, inner.x + inner.width), output.cols).setTo(0);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////
+// image of a region of interest: the image and the position of its top left pixel
+// in the camera image (frame coordinates)
+//
+// the operators have overloads for RoiImage which return only the valid part of
+// their output (e.g. without the cropped edges of a convolution) and update the
+// origin, so results can be mapped back to the camera image without knowing
+// which borders the operators cropped
+//
+// outputs are written into the buffer of the output image if it fits, so a chain
+// of operators allocates its buffers only once. operators without a border can
+// run in place (input and output are the same image).
+////////////////////////////////////////////////////////////////////////////////////
+struct RoiImage
+{
+    cv::Mat mat;
+    cv::Point origin; // frame coordinates of mat(0, 0)
+
+    RoiImage() {}
+    RoiImage(const cv::Mat &mat, const cv::Point origin = cv::Point(0, 0)) : mat(mat), origin(origin) {}
+
+    // region 'roi' (frame coordinates) of an image with origin (0, 0)
+    static RoiImage of(const cv::Mat &frame, const cv::Rect &roi)
+    {
+        return RoiImage(frame(roi), roi.tl());
+    }
+
+    bool empty() const { return mat.empty(); }
+
+    // area of the image in frame coordinates
+    cv::Rect rect() const { return cv::Rect(origin.x, origin.y, mat.cols, mat.rows); }
+
+    // part of this image, 'roi' in frame coordinates (no copy)
+    RoiImage crop(const cv::Rect &roi) const
+    {
+        cv::Rect part = roi & rect();
+        return RoiImage(mat(part - origin), part.tl());
+    }
+
+    // part of this image, 'roi' in coordinates of this image (no copy)
+    RoiImage cropLocal(const cv::Rect &roi) const
+    {
+        return RoiImage(mat(roi), origin + roi.tl());
+    }
+
+    // make 'mat' a buffer for an output of 'size' and 'type': the allocation of a
+    // previous output is reused, even if that output was cropped to its valid part
+    static void reuseBuffer(cv::Mat &mat, const cv::Size &size, const int type)
+    {
+        if (!mat.empty() && mat.type() == type && mat.size() != size)
+        {
+            cv::Size whole;
+            cv::Point offset;
+            mat.locateROI(whole, offset);
+            if (whole == size)
+                mat.adjustROI(offset.y, whole.height - offset.y - mat.rows,
+                              offset.x, whole.width - offset.x - mat.cols);
+        }
+        mat.create(size, type);
+    }
+
+    // coordinate mapping
+    cv::Point toFrame(const cv::Point point) const { return point + origin; }
+    cv::Point toLocal(const cv::Point point) const { return point - origin; }
+};
+
+#endif /* ROIIMAGE_H */
@@ -0,0 +1,1179 @@
+#include <iostream>
+#include <math.h>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "Segmentation.h"
+#include "Filter.h"
+#include "IntegralImage.h"
+
+
+////////////////////////////////////////////////////////////////////////////////////
+// constructor and destructor
+////////////////////////////////////////////////////////////////////////////////////
+Segmentation::Segmentation() {}
+
+Segmentation::~Segmentation(){}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Cut template image from input and save as file
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::cutAndSave(const cv::Mat &input, cv::Point origin, cv::Size size, const cv::string &filename)
+{
+    // define rectangle from origin and size
+    cv::Rect rect(origin, size);
+
+    // cut the rectangle and create template
+    cv::Mat templ = input(rect);
+
+    // save template to file
+    cv::imwrite(filename, templ);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Compute normalized cross correlation function
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::crossCorrelate(const cv::Mat &input, const cv::Mat &templ, cv::Mat &output)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    int tRows = templ.rows;
+    int tCols = templ.cols;
+
+    output.release();
+
+    // create a float image
+    output = cv::Mat(rows - tRows + 1, cols - tCols + 1, CV_32F);
+
+    // calculate template part of the normalization factor
+    float normFactor_templ = 0.0f;
+
+    for (int tr = 0; tr < tRows; ++tr)
+    {
+        const float *pTempl = templ.ptr<float>(tr);
+
+        for (int tc = 0; tc < tCols; ++tc)
+        {
+            normFactor_templ += pow(*pTempl, 2);
+
+            ++pTempl;
+        }
+    }
+
+    normFactor_templ = sqrt(normFactor_templ);
+
+    // input part of the normalization factor: sum of the squares under the template
+    // from the integral image (4 values per offset instead of a second sum over the template)
+    IntegralImage integral;
+    integral.compute(input, true);
+
+    // calculate and normalize cross correlation
+    for (int r = 0; r < (rows - tRows + 1); ++r)
+    {
+        float *pOutput = output.ptr<float>(r);
+
+        for (int c = 0; c < (cols - tCols + 1); ++c)
+        {
+            float result = 0.0f;
+
+            for (int tr = 0; tr < tRows; ++tr)
+            {
+                const float *pInput = input.ptr<float>(r + tr) + c;
+                const float *pTempl = templ.ptr<float>(tr);
+
+                for (int tc = 0; tc < tCols; ++tc)
+                {
+                    result += ((*pInput) * (*pTempl));
+
+                    ++pTempl;
+                    ++pInput;
+                }
+            }
+
+            float normFactor_input = float(sqrt(integral.sumOfSquares(cv::Rect(c, r, tCols, tRows))));
+
+            // normalize the result
+            float normFactor = normFactor_input * normFactor_templ;
+            result /= (normFactor);
+
+            *pOutput = result;
+
+            ++pOutput;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Find brightest pixel and return its coordinates as Point
+////////////////////////////////////////////////////////////////////////////////////
+cv::Point Segmentation::findMaximum(const cv::Mat &input)
+{
+    // declare array to hold the indizes
+    int maxIndex[2];
+
+    // find the maximum
+    cv::minMaxIdx(input, 0, 0, 0, maxIndex);
+
+    // create Point and return
+    return cv::Point(maxIndex[1], maxIndex[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Add a black rectangle to an image
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::drawRect(const cv::Mat &input, cv::Point origin, cv::Size size, cv::Mat &output)
+{
+    // define rectangle from origin and size
+    cv::Rect rect(origin, size);
+
+    // copy input image to output
+    output = input.clone();
+
+    // draw the rectangle
+    cv::rectangle(output, rect, 0, 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Compute Hough Transformation
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::houghTransform(const cv::Mat &input, float phiStep, cv::Mat &output)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    int dMax = (int) sqrt(pow(rows, 2) + pow(cols, 2));
+    int phiMax = (int) (180.0f / phiStep);
+    float phiStepRad = phiStep * CV_PI / 180.0f;
+
+    output.release();
+
+    // create a 32bit signed integer image initialized with zeros
+    output = cv::Mat::zeros(2 * dMax, phiMax, CV_32S);
+
+    // Hough Transformation
+    for (int r = 0; r < rows; ++r)
+    {
+        const float *pInput = input.ptr<float>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            if (*pInput != 0)
+            {
+                for (int phi = 0; phi < phiMax; ++phi)
+                {
+                    // compute phi and d as floating point values
+                    float phiRad = (float) phi * phiStepRad;
+                    float dFloat = ((float) c * cos(phiRad) + (float) r * sin(phiRad));
+
+                    // round and convert to integer
+                    int dInt = (int) (dFloat > 0.0f) ? (dFloat + 0.5f) : (dFloat - 0.5f);
+
+                    // increment in output image
+                    ++output.at<int>(dMax + dInt, phi);
+                }
+            }
+
+            ++pInput;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Compute Hough Transformation of an edge point list (same votes as above)
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::houghTransform(const EdgePoints &points, float phiStep, cv::Mat &output)
+{
+    int rows = points.size.height;
+    int cols = points.size.width;
+
+    int dMax = (int) sqrt(pow(rows, 2) + pow(cols, 2));
+    int phiMax = (int) (180.0f / phiStep);
+    float phiStepRad = phiStep * CV_PI / 180.0f;
+
+    output.create(2 * dMax, phiMax, CV_32S);
+    output.setTo(0);
+
+    // cos and sin of all angles
+    std::vector<float> cosPhi(phiMax), sinPhi(phiMax);
+    for (int phi = 0; phi < phiMax; ++phi)
+    {
+        float phiRad = (float) phi * phiStepRad;
+        cosPhi[phi] = cos(phiRad);
+        sinPhi[phi] = sin(phiRad);
+    }
+
+    for (int i = 0; i < points.count; ++i)
+    {
+        float c = (float) points.x[i];
+        float r = (float) points.y[i];
+        int *pOutput = output.ptr<int>(dMax);
+
+        for (int phi = 0; phi < phiMax; ++phi)
+        {
+            float dFloat = (c * cosPhi[phi] + r * sinPhi[phi]);
+
+            // round and convert to integer
+            int dInt = (dFloat > 0.0f) ? int(dFloat + 0.5f) : int(dFloat - 0.5f);
+
+            ++pOutput[dInt * phiMax + phi];
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// scale a Hough image for better displaying
+///////////////////////////////////////////////////////////////////////////////
+void Segmentation::scaleHoughImage(const cv::Mat &input, cv::Mat &output)
+{
+    // find max value
+    double max;
+    cv::minMaxLoc(input, 0, &max);
+
+    // scale the image
+    input.convertTo(output, CV_32F, 1.0f / max, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Find the n local maxima and return the coordinates in a cv::Mat
+////////////////////////////////////////////////////////////////////////////////////
+cv::Mat Segmentation::findMaxima(const cv::Mat &input, int n)
+{
+    int yMax = input.rows - 1;
+    int xMax = input.cols - 1;
+
+    int rOffset = input.rows / 2;
+
+    // create a copy of the input image
+    cv::Mat inputCopy = input.clone();
+
+    // create a 32bit signed integer image initialized with zeros
+    cv::Mat maxima = cv::Mat::zeros(n, 2, CV_32S);
+
+    // find n local maxima
+    for (int i = 0; i < n; ++i)
+    {
+        int *pMaxima = maxima.ptr<int>(i);
+
+        // find the maximum
+        cv::Point maxPoint = findMaximum(inputCopy);
+
+        // store the maximum in output matrix
+        *pMaxima = rOffset - maxPoint.y;
+        *(pMaxima + 1) = maxPoint.x;
+
+        // clear the found maximum and all pixels around it
+        const int dist = 10;
+
+        // find the indices of the region around the found maximum
+        int xStart = maxPoint.x - dist;
+        if (xStart < 0)
+            xStart = 0;
+
+        int xEnd = maxPoint.x + dist;
+        if (xEnd > xMax)
+            xEnd = xMax;
+
+        int yStart = maxPoint.y - dist;
+        if (yStart < 0)
+            yStart = 0;
+
+        int yEnd = maxPoint.y + dist;
+        if (yEnd > yMax)
+            yEnd = yMax;
+
+        // set the pixel's values to zero
+        for (int y = yStart; y <= yEnd; ++y)
+        {
+            int *pInput = inputCopy.ptr<int>(y) + xStart;
+
+            for (int x = xStart; x <= xEnd; ++x)
+            {
+                *pInput = 0;
+                ++pInput;
+            }
+        }
+    }
+
+    // return the maxima as cv::Mat
+    return maxima;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Draw straight lines
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::drawLines(const cv::Mat &input, cv::Mat lines, float phiStep, cv::Mat &output)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    int nLines = lines.rows;
+    float phiStepRad = phiStep * CV_PI / 180.0f;
+
+    // copy input image to output
+    output = input.clone();
+
+    // convert to RGB colour image
+    cv::cvtColor(output, output, CV_GRAY2RGB);
+
+    // draw the lines
+    for (int l = 0; l < nLines; ++l)
+    {
+        int *pLines = lines.ptr<int>(l);
+
+        // get d and phi
+        int d = *pLines;
+        float phi = (float) *(pLines + 1) * phiStep;
+        float phiRad = (float) *(pLines + 1) * phiStepRad;
+
+        // find start and end point of line
+        cv::Point p1;
+        cv::Point p2;
+
+        if (phi == 0.0f)
+        {
+            // vertical line
+            p1 = cv::Point(d, 0);
+            p2 = cv::Point(d, rows - 1);
+        }
+        else if (phi == 90.0f)
+        {
+            // horizontal line
+            p1 = cv::Point(0, d);
+            p2 = cv::Point(cols - 1, d);
+        }
+        else if (phi < 90.0f)
+        {
+            // monotonically decreasing
+            int x = d / cos(phiRad);
+            int y = d / sin(phiRad);
+
+            p1 = cv::Point(0, y);
+            p2 = cv::Point(x, 0);
+        }
+        else
+        {
+            // monotonically increasing
+            int y = d / sin(phiRad);
+            int x = -1.0f * tan(phiRad) * (rows - y);
+
+            p1 = cv::Point(0, y);
+            p2 = cv::Point(x, rows - 1);
+        }
+
+        // draw a red line
+        cv::line(output, p1, p2, cv::Scalar(0.0f, 0.0f, 1.0f), 1);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Compute Hough Transformation for cirlces
+////////////////////////////////////////////////////////////////////////////////////
+
+// cellStep: accumulator cell size
+void Segmentation::houghCircle(const cv::Mat &input, cv::Mat &output,
+                               const int radius, const float cellStep,
+                               const float phiStep)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    // accumulator dimensions
+    // a: [0-radius , cols-1+radius]
+    // b: [0-radius , rows-1+radius]
+    int dimA = ceil(float(cols + radius + radius) / cellStep);
+    int dimB = ceil(float(rows + radius + radius) / cellStep);
+
+    // shift in accumulator space
+    int shift = round(float(radius) / cellStep);
+
+    // scale the accumulator cell
+    float scaleFloat = 1.0f / cellStep;
+    int scaleInt = round(scaleFloat);
+
+    // create accumulator
+    output.release();
+    output = cv::Mat::zeros(dimB, dimA, CV_32S); // 32 bit integer
+
+    // phi deg->rad
+    const float phiRadStart = 0.0f;
+    const float phiRadEnd = 360.0f * CV_PI / 180.0f;
+    const float phiRadStep = phiStep * CV_PI / 180.0f;
+
+    // radius as float
+    float r = float(radius);
+
+    // Hough Transformation (circle)
+    for (int y = 0; y < rows; ++y) {
+        const uchar *pInput = input.ptr<uchar>(y);
+        for (int x = 0; x < cols; ++x) {
+            if (*pInput++ == 0)
+                continue;
+
+            // voting for pixel(y,x)
+            for (float phiRad = phiRadStart; phiRad < phiRadEnd;
+                phiRad += phiRadStep) {
+                int a = (scaleInt * x) - round(r * cos(phiRad) * scaleFloat);
+                int b = (scaleInt * y) - round(r * sin(phiRad) * scaleFloat);
+                ++output.at<int>(b + shift, a + shift);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// Hough Transformation for circles of an edge point list
+//
+// same accumulator as above: the votes of an edge pixel are precomputed offsets
+// (same rounding), only the edge pixels are visited
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::houghCircle(const EdgePoints &points, cv::Mat &output,
+                               const int radius, const float cellStep,
+                               const float phiStep)
+{
+    // 32 bit cells in the buffer of 'output'
+    HoughAccumulator accumulator;
+    accumulator.cells = output;
+    houghCircle(points, accumulator, radius, cellStep, phiStep);
+    output = accumulator.cells;
+}
+
+// offsets (in accumulator cells) of all votes of an edge pixel, appended to 'offsets'
+// (shift: border of the accumulator in cells, base: first cell of the accumulator)
+static void circleOffsets(const int radius, const int shift, const float cellStep, const float phiStep,
+                          const int dimA, const int base, std::vector<int> *offsets)
+{
+    float scaleFloat = 1.0f / cellStep;
+    const float phiRadEnd = 360.0f * CV_PI / 180.0f;
+    const float phiRadStep = phiStep * CV_PI / 180.0f;
+    float r = float(radius);
+
+    for (float phiRad = 0.0f; phiRad < phiRadEnd; phiRad += phiRadStep) {
+        int da = shift - round(r * cos(phiRad) * scaleFloat);
+        int db = shift - round(r * sin(phiRad) * scaleFloat);
+        offsets->push_back(base + db * dimA + da);
+    }
+}
+
+void Segmentation::houghCircle(const EdgePoints &points, HoughAccumulator &accumulator,
+                               const int radius, const float cellStep,
+                               const float phiStep)
+{
+    int dimA = ceil(float(points.size.width + radius + radius) / cellStep);
+    int dimB = ceil(float(points.size.height + radius + radius) / cellStep);
+    int scaleInt = round(1.0f / cellStep);
+    accumulator.reset(dimB, dimA, accumulator.type);
+
+    std::vector<int> offsets;
+    circleOffsets(radius, round(float(radius) / cellStep), cellStep, phiStep, dimA, 0, &offsets);
+    accumulator.vote(points.x.data(), points.y.data(), points.count, scaleInt, offsets);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// strongest circle for all radii in [radiusMin, radiusMax] (e.g. for the calibration)
+//
+// all radii vote in one pass over the edge pixels into a stacked accumulator: one layer
+// per radius (size of the layer of radiusMax, every layer has the border of radiusMax),
+// the votes use precomputed offsets (same rounding as 'houghCircle' -> same values) and
+// one search of the maximum over all layers gives the circle. equal votes: the smallest
+// radius, then the first cell in row order (like the search radius by radius).
+// the layers of a pass are limited to 2^31 cells (int offsets), more radii -> more passes
+////////////////////////////////////////////////////////////////////////////////////
+CircleItem Segmentation::findStrongestCircle(const cv::Mat &input, const int radiusMin, const int radiusMax,
+                                             const float cellStep, const float phiStep, const AccumulatorType type)
+{
+    EdgePoints points;
+    EdgePoints::fromImage(input, &points);
+    return findStrongestCircle(points, radiusMin, radiusMax, cellStep, phiStep, type);
+}
+
+CircleItem Segmentation::findStrongestCircle(const EdgePoints &points, const int radiusMin, const int radiusMax,
+                                             const float cellStep, const float phiStep, const AccumulatorType type)
+{
+    CircleItem best;
+    best.x = best.y = best.r = -1;
+    best.v = 0;
+
+    if (radiusMax < radiusMin)
+        return best;
+
+    int shiftMax = round(float(radiusMax) / cellStep);
+    int dimA = ceil(float(points.size.width + radiusMax + radiusMax) / cellStep);
+    int dimB = ceil(float(points.size.height + radiusMax + radiusMax) / cellStep);
+    int scaleInt = round(1.0f / cellStep);
+    int64_t layerCells = int64_t(dimA) * dimB;
+    int layersPerPass = int(std::max<int64_t>(1, std::min<int64_t>(radiusMax - radiusMin + 1,
+                                                                  INT_MAX / layerCells)));
+
+    HoughAccumulator accumulator;
+    accumulator.type = type;
+    std::vector<int> offsets;
+    for (int first = radiusMin; first <= radiusMax; first += layersPerPass) {
+        int layers = std::min(layersPerPass, radiusMax - first + 1);
+        accumulator.reset(layers * dimB, dimA, type);
+
+        offsets.clear();
+        for (int layer = 0; layer < layers; ++layer)
+            circleOffsets(first + layer, shiftMax, cellStep, phiStep, dimA, int(layer * layerCells), &offsets);
+        accumulator.vote(points.x.data(), points.y.data(), points.count, scaleInt, offsets);
+
+        int value;
+        cv::Point cell = accumulator.findMaximum(&value);
+        if (value <= best.v)
+            continue;
+
+        // layer -> radius, cell of the layer -> cell of the accumulator of this radius -> pixel
+        int radius = first + cell.y / dimB;
+        int border = shiftMax - int(round(float(radius) / cellStep));
+        best.x = round(float(cell.x - border) * cellStep - radius);
+        best.y = round(float(cell.y % dimB - border) * cellStep - radius);
+        best.r = radius;
+        best.v = value;
+    }
+
+    best.xf = float(best.x);
+    best.yf = float(best.y);
+    best.rf = float(best.r);
+    return best;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// find maximum in cv::Mat and remove it (so the next local maximum can be found)
+////////////////////////////////////////////////////////////////////////////////////
+cv::Point Segmentation::findAndRemoveMaximum(cv::Mat &image, int *value, const int radius, const float cellStep)
+{
+    cv::Point point;
+    double min = 0.0;
+    double max = 0.0;
+    cv::minMaxLoc(image, &min, &max, nullptr, &point);
+    *value = int(max);
+
+    if (*value < 1)
+    {
+        point.x = -1;
+        point.y = -1;
+        return point;
+    }
+
+    int neighborSum =
+        image.at<int>(point.y - 1, point.x) + image.at<int>(point.y + 1, point.x) +
+        image.at<int>(point.y, point.x - 1) + image.at<int>(point.y, point.x + 1);
+
+    // remove area around maximum
+    cv::circle(image, point, 5, cv::Scalar(0, 0, 0), -1);
+
+    // convert accumulator space coordinates to pixel coordinates of the image which was hough transformed
+    point.x = round(float(point.x) * cellStep - radius);
+    point.y = round(float(point.y) * cellStep - radius);
+
+    return point;
+}
+
+cv::Point Segmentation::findAndRemoveMaximum(HoughAccumulator &accumulator, int *value, const int radius,
+                                             const float cellStep)
+{
+    cv::Point point = accumulator.findMaximum(value);
+    if (*value < 1)
+        return cv::Point(-1, -1);
+
+    // remove area around maximum
+    accumulator.removeCircle(point, 5);
+
+    // convert accumulator space coordinates to pixel coordinates of the image which was hough transformed
+    point.x = round(float(point.x) * cellStep - radius);
+    point.y = round(float(point.y) * cellStep - radius);
+
+    return point;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// a cicle (center) was found add it to the list of cirles
+// (similar: center within 'dist' pixels, radius in [r - radiusBand, r])
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::addFoundCenter(std::vector<CircleItem> *list, const int x, const int y, const int r, const int value,
+                                  const int dist, const int radiusBand)
+{
+    // search for circle with similar center and radius in list
+    bool found = false;
+    for (int i = 0; i < list->size(); ++i)
+    {
+        CircleItem *item = &list->at(i);
+        if (item->r >= r - radiusBand && item->r <= r && item->x >= x - dist
+            && item->x <= x + dist && item->y >= y - dist && item->y <= y + dist)
+        {
+            //there is a similar cirle
+            found = true;
+            if (item->v <= value)
+            {
+                // current values are more likely a circle then values in list, therefore update list
+                item->x = x;
+                item->y = y;
+                item->r = r;
+                item->v = value;
+                item->xf = float(x);
+                item->yf = float(y);
+                item->rf = float(r);
+            }
+            break;
+        }
+    }
+
+    if (found)
+        return; // something similar was found in list, therefore, no need to add it to the list again
+
+    // nothing similar found in list, therefore, add current data to list
+    CircleItem newItem;
+    newItem.x = x;
+    newItem.y = y;
+    newItem.r = r;
+    newItem.v = value;
+    newItem.xf = float(x);
+    newItem.yf = float(y);
+    newItem.rf = float(r);
+    list->push_back(newItem);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// find all circles (whose radius is in the given range) in the image
+// and add the circle to the list
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::findCircles(const cv::Mat &input, std::vector<CircleItem> *list, const int radiusMin,
+    const int radiusMax, const float cellStep,
+    const float phiStep, const int maxCountPerRadius)
+{
+    // the edge image is scanned once (not once for every radius)
+    EdgePoints points;
+    EdgePoints::fromImage(input, &points);
+    findCircles(points, list, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius);
+}
+
+void Segmentation::findCircles(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+    const int radiusMax, const float cellStep,
+    const float phiStep, const int maxCountPerRadius)
+{
+    list->clear();
+    HoughAccumulator hough;
+    hough.type = accumulatorType;
+    hough.threads = accumulatorThreads;
+    for (int r = radiusMin; r <= radiusMax; ++r)
+    {
+        houghCircle(points, hough, r, cellStep, phiStep);
+
+        int maxValue = -1;
+        int value = -1;
+        int count = 0;
+        while (true) // endless loop, left with 'break'
+        {
+            if (++count > maxCountPerRadius)
+                break;
+            cv::Point center = findAndRemoveMaximum(hough, &value, r, cellStep);
+
+            if (maxValue == -1)
+                maxValue = value;
+
+            if (value < maxValue || value < 1)
+                break;
+            // point may be a center of a circle
+            addFoundCenter(list, center.x, center.y, r, value);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// like function 'findCircles', but uses 4 threads
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::findCirclesThread(const cv::Mat &input, std::vector<CircleItem> *list, const int radiusMin,
+    const int radiusMax, const float cellStep,
+    const float phiStep, const int maxCountPerRadius)
+{
+    EdgePoints points;
+    EdgePoints::fromImage(input, &points);
+    findCirclesThread(points, list, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius);
+}
+
+void Segmentation::findCirclesThread(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+    const int radiusMax, const float cellStep,
+    const float phiStep, const int maxCountPerRadius)
+{
+    list->clear();
+
+    // note: number calculations increase with radius and, therefore, not 25% for each thread
+    int rSize = radiusMax - radiusMin;
+    int r2 = radiusMin + rSize * 0.30f;
+    int r3 = radiusMin + rSize * 0.57f;
+    int r4 = radiusMin + rSize * 0.80f;
+
+    // start thread 1
+    std::thread th1(findCirclesThreadSub, std::cref(points), list, radiusMin, r2 - 1, cellStep, phiStep, maxCountPerRadius,
+                    accumulatorType);
+
+    // create new circle lists because different threads can not write to the same list
+    std::vector<CircleItem> list2, list3, list4;
+
+    //start thread 2, 3 and 4
+    std::thread th2(findCirclesThreadSub, std::cref(points), &list2, r2, r3 - 1, cellStep, phiStep, maxCountPerRadius,
+                    accumulatorType);
+    std::thread th3(findCirclesThreadSub, std::cref(points), &list3, r3, r4 - 1, cellStep, phiStep, maxCountPerRadius,
+                    accumulatorType);
+    std::thread th4(findCirclesThreadSub, std::cref(points), &list4, r4, radiusMax, cellStep, phiStep, maxCountPerRadius,
+                    accumulatorType);
+
+
+    // wait for thread 1 to finish
+    th1.join();
+
+    // wait for thread 2 to finish
+    th2.join();
+    // add circles of thread 2 to the list of thread 1 (the original circle list)
+    for (auto circle : list2)
+    {
+        list->push_back(circle);
+    }
+
+    // do the same things for thead 3 and 4
+    th3.join();
+    for (auto circle : list3)
+    {
+        list->push_back(circle);
+    }
+    th4.join();
+    for (auto circle : list4)
+    {
+        list->push_back(circle);
+    }
+
+    // now: all circles are in the 'list'
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// for the thread version of function 'findCircles'
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::findCirclesThreadSub(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+                                         const int radiusMax, const float cellStep,
+                                         const float phiStep, const int maxCountPerRadius,
+                                         const AccumulatorType type)
+{
+    HoughAccumulator hough;
+    hough.type = type;
+    for (int r = radiusMin; r <= radiusMax; ++r)
+    {
+        houghCircle(points, hough, r, cellStep, phiStep);
+
+        int maxValue = -1;
+        int value = -1;
+        int count = 0;
+        while (true) // endless loop, left with 'break'
+        {
+            if (++count > maxCountPerRadius)
+                break;
+            cv::Point center = findAndRemoveMaximum(hough, &value, r, cellStep);
+            if (maxValue == -1)
+                maxValue = value;
+
+            if (value < maxValue || value < 1)
+                break;
+
+            // point may be a center of a circle
+            addFoundCenter(list, center.x, center.y, r, value);
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// number of edge pixels on the circumference of a circle
+//
+// note: this is the number of votes the circle would get in the Hough
+//       accumulator, but it can be evaluated at sub-pixel positions
+////////////////////////////////////////////////////////////////////////////////////
+int Segmentation::getCircleSupport(const cv::Mat &input, const float x, const float y, const float r, const float phiStep)
+{
+    const float phiRadEnd = 360.0f * CV_PI / 180.0f;
+    const float phiRadStep = phiStep * CV_PI / 180.0f;
+
+    int support = 0;
+    for (float phiRad = 0.0f; phiRad < phiRadEnd; phiRad += phiRadStep)
+    {
+        int col = round(x + r * cos(phiRad));
+        int row = round(y + r * sin(phiRad));
+        if (col < 0 || row < 0 || col >= input.cols || row >= input.rows)
+            continue;
+
+        if (input.at<uchar>(row, col) != 0)
+            ++support;
+    }
+    return support;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// fit a parabola through three samples and return the position of its vertex
+// (in units of the sample distance, relative to the center sample: -0.5 ... 0.5)
+////////////////////////////////////////////////////////////////////////////////////
+float Segmentation::interpolatePeak(const int left, const int center, const int right)
+{
+    float denominator = float(left - 2 * center + right);
+    if (denominator >= 0.0f || center < left || center < right)
+        return 0.0f; // no (local) maximum at the center sample
+
+    float offset = 0.5f * float(left - right) / denominator;
+    if (offset > 0.5f)
+        return 0.5f;
+    if (offset < -0.5f)
+        return -0.5f;
+    return offset;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// algebraic least squares circle fit (Kasa) on the edge pixels near the circle
+//
+// x^2 + y^2 + D*x + E*y + F = 0
+// center = (-D/2, -E/2), radius = sqrt(D^2/4 + E^2/4 - F)
+//
+// returns false (and does not change the circle) if the fit is not reliable
+////////////////////////////////////////////////////////////////////////////////////
+bool Segmentation::fitCircleLeastSquares(const cv::Mat &input, CircleItem *circle, const float bandWidth)
+{
+    float rOuter = circle->rf + bandWidth;
+    float rInner = circle->rf - bandWidth;
+
+    int colStart = std::max(0, int(floor(circle->xf - rOuter)));
+    int colEnd = std::min(input.cols - 1, int(ceil(circle->xf + rOuter)));
+    int rowStart = std::max(0, int(floor(circle->yf - rOuter)));
+    int rowEnd = std::min(input.rows - 1, int(ceil(circle->yf + rOuter)));
+
+    // sums (coordinates relative to the current center for numerical stability)
+    double su = 0.0, sv = 0.0, suu = 0.0, svv = 0.0, suv = 0.0;
+    double suz = 0.0, svz = 0.0, sz = 0.0;
+    int n = 0;
+
+    for (int row = rowStart; row <= rowEnd; ++row)
+    {
+        const uchar *pInput = input.ptr<uchar>(row) + colStart;
+        double v = double(row) - circle->yf;
+        for (int col = colStart; col <= colEnd; ++col)
+        {
+            if (*pInput++ == 0)
+                continue;
+
+            double u = double(col) - circle->xf;
+            double z = u * u + v * v;
+
+            // use only edge pixels in a band around the circumference
+            if (z > rOuter * rOuter || z < rInner * rInner)
+                continue;
+
+            su += u;
+            sv += v;
+            suu += u * u;
+            svv += v * v;
+            suv += u * v;
+            suz += u * z;
+            svz += v * z;
+            sz += z;
+            ++n;
+        }
+    }
+
+    // too few points for a reliable fit
+    if (n < 10)
+        return false;
+
+    double a[3 * 3] = { suu, suv, su,
+                        suv, svv, sv,
+                        su,  sv,  double(n) };
+    double b[3] = { -suz, -svz, -sz };
+    cv::Mat matA(3, 3, CV_64F, a);
+    cv::Mat matB(3, 1, CV_64F, b);
+    cv::Mat solution;
+    if (!cv::solve(matA, matB, solution, cv::DECOMP_LU))
+        return false;
+
+    double d = solution.at<double>(0, 0);
+    double e = solution.at<double>(1, 0);
+    double f = solution.at<double>(2, 0);
+    double rSquared = (d * d + e * e) / 4.0 - f;
+    if (rSquared <= 0.0)
+        return false;
+
+    float dx = float(-d / 2.0);
+    float dy = float(-e / 2.0);
+    float r = float(sqrt(rSquared));
+
+    // the fit may be pulled away by edges of neighboring objects -> accept only small corrections
+    if (fabs(dx) > bandWidth || fabs(dy) > bandWidth || fabs(r - circle->rf) > bandWidth)
+        return false;
+
+    circle->xf += dx;
+    circle->yf += dy;
+    circle->rf = r;
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// refine the circles of the list to sub-pixel accuracy
+//
+// 1. quadratic peak interpolation in a, b (step: cellStep) and r (step: 1 px)
+//    of the number of edge pixels on the circumference
+// 2. optional: least squares circle fit on the edge pixels near the circle
+//
+// note: this is much cheaper than a smaller cellStep, which increases the
+//       accumulator size quadratically
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::refineCircles(const cv::Mat &input, std::vector<CircleItem> *list, const float cellStep,
+                                 const float phiStep, const bool leastSquares)
+{
+    for (size_t i = 0; i < list->size(); ++i)
+    {
+        CircleItem *circle = &list->at(i);
+        float x = float(circle->x);
+        float y = float(circle->y);
+        float r = float(circle->r);
+
+        int center = getCircleSupport(input, x, y, r, phiStep);
+
+        // interpolate every dimension separately
+        float dx = interpolatePeak(getCircleSupport(input, x - cellStep, y, r, phiStep), center,
+                                   getCircleSupport(input, x + cellStep, y, r, phiStep));
+        float dy = interpolatePeak(getCircleSupport(input, x, y - cellStep, r, phiStep), center,
+                                   getCircleSupport(input, x, y + cellStep, r, phiStep));
+        float dr = interpolatePeak(getCircleSupport(input, x, y, r - 1.0f, phiStep), center,
+                                   getCircleSupport(input, x, y, r + 1.0f, phiStep));
+
+        circle->xf = x + dx * cellStep;
+        circle->yf = y + dy * cellStep;
+        circle->rf = r + dr;
+
+        if (leastSquares)
+            fitCircleLeastSquares(input, circle, 2.0f);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// halve the size of an edge image
+//
+// note: a output pixel is an edge if any of the 2x2 input pixels is an edge
+//       (averaging would remove thin edges)
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::downsampleEdges(const cv::Mat &input, cv::Mat &output)
+{
+    int rows = input.rows / 2;
+    int cols = input.cols / 2;
+
+    output.release();
+    output.create(rows, cols, CV_8U);
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const uchar *pInputAbove = input.ptr<uchar>(2 * r);
+        const uchar *pInputBelow = input.ptr<uchar>(2 * r + 1);
+        uchar *pOutput = output.ptr<uchar>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+            *pOutput++ = (pInputAbove[0] | pInputAbove[1] | pInputBelow[0] | pInputBelow[1]) ? 255 : 0;
+            pInputAbove += 2;
+            pInputBelow += 2;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// like function 'findCircles', but coarse-to-fine
+//
+// 1. detect candidates in an image downsampled by 2^levels (radii are scaled, too)
+// 2. for every candidate: Hough transformation of the full resolution image,
+//    but only in a small window around the candidate and only for the radii
+//    which match the candidate's radius
+//
+// note: the full resolution accumulators have the size of a window (not of the
+//       image) and only (2 * 2^levels + 1) radii are checked per candidate
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::findCirclesPyramid(const cv::Mat &input, std::vector<CircleItem> *list, const int radiusMin,
+                                      const int radiusMax, const float cellStep,
+                                      const float phiStep, const int maxCountPerRadius, const int levels)
+{
+    EdgePoints points;
+    EdgePoints::fromImage(input, &points);
+    findCirclesPyramid(points, list, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius, levels);
+}
+
+void Segmentation::findCirclesPyramid(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+                                      const int radiusMax, const float cellStep,
+                                      const float phiStep, const int maxCountPerRadius, const int levels)
+{
+    if (levels < 1)
+    {
+        findCircles(points, list, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius);
+        return;
+    }
+
+    list->clear();
+
+    // create the coarse image (same as 'levels' times downsampleEdges: an edge pixel
+    // marks its coarse pixel, the last odd row and column are dropped)
+    int scale = 1 << levels;
+    cv::Mat coarseImage = cv::Mat::zeros(points.size.height >> levels, points.size.width >> levels, CV_8U);
+    for (int i = 0; i < points.count; ++i)
+    {
+        int x = points.x[i] >> levels;
+        int y = points.y[i] >> levels;
+        if (x < coarseImage.cols && y < coarseImage.rows)
+            coarseImage.at<uchar>(y, x) = 255;
+    }
+    EdgePoints coarse;
+    EdgePoints::fromImage(coarseImage, &coarse);
+
+    // (1) find candidates in the coarse image
+    // note: the coarse image is not accurate, therefore, keep all maxima which
+    //       reach half of the best value (not only the best one)
+    int coarseRadiusMin = std::max(1, radiusMin / scale);
+    int coarseRadiusMax = (radiusMax + scale - 1) / scale;
+    // tolerances of similar candidates in coarse pixels (the full resolution ones divided by the scale)
+    int coarseDist = (10 + scale - 1) / scale;
+    int coarseRadiusBand = (5 + scale - 1) / scale;
+    std::vector<CircleItem> candidates;
+    HoughAccumulator hough;
+    hough.type = accumulatorType;
+    hough.threads = accumulatorThreads;
+    for (int r = coarseRadiusMin; r <= coarseRadiusMax; ++r)
+    {
+        houghCircle(coarse, hough, r, 1.0f, phiStep);
+
+        int maxValue = -1;
+        int value = -1;
+        for (int count = 0; count < maxCountPerRadius; ++count)
+        {
+            cv::Point center = findAndRemoveMaximum(hough, &value, r, 1.0f);
+            if (maxValue == -1)
+                maxValue = value;
+
+            if (value < maxValue / 2 || value < 1)
+                break;
+
+            addFoundCenter(&candidates, center.x, center.y, r, value, coarseDist, coarseRadiusBand);
+        }
+    }
+
+    // (2) verify candidates in full resolution
+    cv::Rect image(0, 0, points.size.width, points.size.height);
+    EdgePoints windowPoints;
+    for (auto candidate : candidates)
+    {
+        // center of the coarse pixel in full resolution
+        int centerX = candidate.x * scale + scale / 2;
+        int centerY = candidate.y * scale + scale / 2;
+
+        int rStart = std::max(radiusMin, candidate.r * scale - scale);
+        int rEnd = std::min(radiusMax, candidate.r * scale + scale);
+        if (rStart > rEnd)
+            continue;
+
+        // window: circle with the largest radius and the uncertainty of the center
+        int half = rEnd + scale + 2;
+        cv::Rect window = cv::Rect(centerX - half, centerY - half, 2 * half + 1, 2 * half + 1) & image;
+        if (window.width < 3 || window.height < 3)
+            continue;
+        points.crop(window, &windowPoints);
+
+        int bestValue = 0;
+        int bestX = 0, bestY = 0, bestR = 0;
+        for (int r = rStart; r <= rEnd; ++r)
+        {
+            houghCircle(windowPoints, hough, r, cellStep, phiStep);
+
+            // search the maximum only near the candidate's center (accumulator coordinates)
+            int searchX = round(float(centerX - window.x + r) / cellStep);
+            int searchY = round(float(centerY - window.y + r) / cellStep);
+            int searchHalf = ceil(float(scale + 1) / cellStep);
+            cv::Rect search = cv::Rect(searchX - searchHalf, searchY - searchHalf, 2 * searchHalf + 1, 2 * searchHalf + 1)
+                              & cv::Rect(0, 0, hough.cols, hough.rows);
+            if (search.width < 1 || search.height < 1)
+                continue;
+
+            int max = 0;
+            cv::Point point = hough.findMaximum(search, &max) - search.tl();
+            if (max <= bestValue)
+                continue;
+
+            // convert accumulator space coordinates to pixel coordinates of the input image
+            bestValue = max;
+            bestX = window.x + round(float(point.x + search.x) * cellStep - r);
+            bestY = window.y + round(float(point.y + search.y) * cellStep - r);
+            bestR = r;
+        }
+
+        if (bestValue > 0)
+            addFoundCenter(list, bestX, bestY, bestR, bestValue);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// move the circles [first, end) by 'offset' (e.g. region -> frame coordinates)
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::shiftCircles(std::vector<CircleItem> *list, const cv::Point offset, const size_t first)
+{
+    for (size_t i = first; i < list->size(); ++i)
+    {
+        CircleItem *circle = &list->at(i);
+        circle->x += offset.x;
+        circle->y += offset.y;
+        circle->xf += offset.x;
+        circle->yf += offset.y;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// circle detection in a region of interest: the found circles are appended to the
+// list in frame coordinates
+////////////////////////////////////////////////////////////////////////////////////
+void Segmentation::findCircles(const RoiImage &input, std::vector<CircleItem> *list, const int radiusMin,
+    const int radiusMax, const float cellStep,
+    const float phiStep, const int maxCountPerRadius)
+{
+    std::vector<CircleItem> found;
+    findCircles(input.mat, &found, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius);
+    shiftCircles(&found, input.origin);
+    list->insert(list->end(), found.begin(), found.end());
+}
+
+void Segmentation::findCirclesThread(const RoiImage &input, std::vector<CircleItem> *list, const int radiusMin,
+    const int radiusMax, const float cellStep,
+    const float phiStep, const int maxCountPerRadius)
+{
+    std::vector<CircleItem> found;
+    findCirclesThread(input.mat, &found, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius);
+    shiftCircles(&found, input.origin);
+    list->insert(list->end(), found.begin(), found.end());
+}
+
+void Segmentation::findCirclesPyramid(const RoiImage &input, std::vector<CircleItem> *list, const int radiusMin,
+    const int radiusMax, const float cellStep,
+    const float phiStep, const int maxCountPerRadius, const int levels)
+{
+    std::vector<CircleItem> found;
+    findCirclesPyramid(input.mat, &found, radiusMin, radiusMax, cellStep, phiStep, maxCountPerRadius, levels);
+    shiftCircles(&found, input.origin);
+    list->insert(list->end(), found.begin(), found.end());
+}
+
+void Segmentation::refineCircles(const RoiImage &input, std::vector<CircleItem> *list, const float cellStep,
+    const float phiStep, const bool leastSquares)
+{
+    shiftCircles(list, -input.origin);
+    refineCircles(input.mat, list, cellStep, phiStep, leastSquares);
+    shiftCircles(list, input.origin);
+}
+
+CircleItem Segmentation::findStrongestCircle(const RoiImage &input, const int radiusMin, const int radiusMax,
+    const float cellStep, const float phiStep, const AccumulatorType type)
+{
+    std::vector<CircleItem> found(1, findStrongestCircle(input.mat, radiusMin, radiusMax, cellStep, phiStep, type));
+    if (found[0].v > 0)
+        shiftCircles(&found, input.origin);
+    return found[0];
+}
@@ -0,0 +1,137 @@
+#ifndef SEGMENTATION_H
+#define SEGMENTATION_H
+
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+#include "EdgePoints.h"
+#include "HoughAccumulator.h"
+
+struct CircleItem
+{
+    int x; // center: x coordinate
+    int y; // center: y coordinate
+    int r; // radius
+    int v; // hough: max. value of center
+
+    // sub-pixel refined center and radius (equal to x, y, r if not refined)
+    float xf;
+    float yf;
+    float rf;
+};
+
+class Segmentation
+{
+public:
+    Segmentation();
+    ~Segmentation();
+
+    // Template Matching
+    void cutAndSave(const cv::Mat &input, cv::Point origin, cv::Size size, const cv::string &filename);
+    void crossCorrelate(const cv::Mat &input, const cv::Mat &templ, cv::Mat &output);
+    cv::Point findMaximum(const cv::Mat &input);
+    void drawRect(const cv::Mat &input, cv::Point origin, cv::Size size, cv::Mat &output);
+
+    // Hough Transformation
+    void houghTransform(const cv::Mat &input, float phiStep, cv::Mat &output);
+    void houghTransform(const EdgePoints &points, float phiStep, cv::Mat &output);
+    void scaleHoughImage(const cv::Mat &input, cv::Mat &output);
+    cv::Mat findMaxima(const cv::Mat &input, int n);
+    void drawLines(const cv::Mat &input, cv::Mat lines, float phiStep, cv::Mat &output);
+
+    // Hough Transformation for circles
+    static void houghCircle(const cv::Mat &input, cv::Mat &output, const int radius, const float cellStep, const float phiStep);
+    static void houghCircle(const EdgePoints &points, cv::Mat &output, const int radius, const float cellStep, const float phiStep);
+    static cv::Point findAndRemoveMaximum(cv::Mat &image, int *value, const int radius, const float cellStep);
+
+    // the same with an accumulator of the cell type 'accumulator.type' (see HoughAccumulator)
+    static void houghCircle(const EdgePoints &points, HoughAccumulator &accumulator, const int radius,
+                            const float cellStep, const float phiStep);
+    static cv::Point findAndRemoveMaximum(HoughAccumulator &accumulator, int *value, const int radius,
+                                          const float cellStep);
+
+    // strongest circle of all radii (one voting pass for all radii, votes from precomputed offsets)
+    // returns v = 0 if no circle was found
+    static CircleItem findStrongestCircle(const cv::Mat &input, const int radiusMin, const int radiusMax,
+                                          const float cellStep, const float phiStep,
+                                          const AccumulatorType type = AccumulatorType::Int32);
+    static CircleItem findStrongestCircle(const EdgePoints &points, const int radiusMin, const int radiusMax,
+                                          const float cellStep, const float phiStep,
+                                          const AccumulatorType type = AccumulatorType::Int32);
+
+    // cell type of the accumulators of findCircles, findCirclesThread and findCirclesPyramid
+    AccumulatorType accumulatorType = AccumulatorType::Int32;
+
+    // sparse accumulators of findCircles and findCirclesPyramid: number of threads which add the votes
+    // (findCirclesThread splits the radii into threads instead)
+    int accumulatorThreads = 1;
+
+    ////////////////////////////////////////////////////////////////////////////////////
+    // new functions for coin detection
+    ////////////////////////////////////////////////////////////////////////////////////
+
+    void findCircles(const cv::Mat &input, std::vector<CircleItem> *list, const int radiusMin,
+                     const int radiusMax, const float cellStep,
+                     const float phiStep, const int maxCountPerRadius);
+
+    void findCirclesThread(const cv::Mat &input, std::vector<CircleItem> *list, const int radiusMin,
+                           const int radiusMax, const float cellStep,
+                           const float phiStep, const int maxCountPerRadius);
+
+    static void findCirclesThreadSub(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+                                     const int radiusMax, const float cellStep,
+                                     const float phiStep, const int maxCountPerRadius,
+                                     const AccumulatorType type = AccumulatorType::Int32);
+
+    // coarse-to-fine circle detection
+    static void downsampleEdges(const cv::Mat &input, cv::Mat &output);
+    void findCirclesPyramid(const cv::Mat &input, std::vector<CircleItem> *list, const int radiusMin,
+                            const int radiusMax, const float cellStep,
+                            const float phiStep, const int maxCountPerRadius, const int levels);
+
+    // edge point lists (see EdgePoints): same results as the edge image versions,
+    // which create the list once and call these functions (coordinates of the edge image)
+    void findCircles(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+                     const int radiusMax, const float cellStep,
+                     const float phiStep, const int maxCountPerRadius);
+    void findCirclesThread(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+                           const int radiusMax, const float cellStep,
+                           const float phiStep, const int maxCountPerRadius);
+    void findCirclesPyramid(const EdgePoints &points, std::vector<CircleItem> *list, const int radiusMin,
+                            const int radiusMax, const float cellStep,
+                            const float phiStep, const int maxCountPerRadius, const int levels);
+
+    // sub-pixel refinement of found circles
+    static int getCircleSupport(const cv::Mat &input, const float x, const float y, const float r, const float phiStep);
+    void refineCircles(const cv::Mat &input, std::vector<CircleItem> *list, const float cellStep,
+                       const float phiStep, const bool leastSquares);
+
+    ////////////////////////////////////////////////////////////////////////////////////
+    // regions of interest: the circles are in frame coordinates (see RoiImage)
+    ////////////////////////////////////////////////////////////////////////////////////
+
+    void findCircles(const RoiImage &input, std::vector<CircleItem> *list, const int radiusMin,
+                     const int radiusMax, const float cellStep,
+                     const float phiStep, const int maxCountPerRadius);
+    void findCirclesThread(const RoiImage &input, std::vector<CircleItem> *list, const int radiusMin,
+                           const int radiusMax, const float cellStep,
+                           const float phiStep, const int maxCountPerRadius);
+    void findCirclesPyramid(const RoiImage &input, std::vector<CircleItem> *list, const int radiusMin,
+                            const int radiusMax, const float cellStep,
+                            const float phiStep, const int maxCountPerRadius, const int levels);
+    void refineCircles(const RoiImage &input, std::vector<CircleItem> *list, const float cellStep,
+                       const float phiStep, const bool leastSquares);
+    static CircleItem findStrongestCircle(const RoiImage &input, const int radiusMin, const int radiusMax,
+                                          const float cellStep, const float phiStep,
+                                          const AccumulatorType type = AccumulatorType::Int32);
+
+    // move the circles [first, end) by 'offset'
+    static void shiftCircles(std::vector<CircleItem> *list, const cv::Point offset, const size_t first = 0);
+
+  private:
+      static float interpolatePeak(const int left, const int center, const int right);
+      static bool fitCircleLeastSquares(const cv::Mat &input, CircleItem *circle, const float bandWidth);
+      static void addFoundCenter(std::vector<CircleItem> *list, const int x, const int y, const int r, const int value,
+                                 const int dist = 10, const int radiusBand = 5);
+};
+
+#endif /* SEGMENTATION_H */
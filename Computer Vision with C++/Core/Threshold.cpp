@@ -0,0 +1,226 @@
+#include <iostream>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "Threshold.h"
+#include "IntegralImage.h"
+#include "CpuDispatch.h"
+
+#ifdef CORE_X86
+#include <immintrin.h>
+#endif
+#ifdef CORE_NEON
+#include <arm_neon.h>
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////
+// kernels for one row: output = 255 if input >= threshold, else 0 (see CpuDispatch.h)
+////////////////////////////////////////////////////////////////////////////////////
+typedef void (*ThresholdRowFunction)(const uchar *pInput, uchar *pOutput, const int cols, const uchar threshold);
+
+static void thresholdRowScalar(const uchar *pInput, uchar *pOutput, const int cols, const uchar threshold)
+{
+    for (int c = 0; c < cols; ++c)
+    {
+        if (*pInput >= threshold)
+            *pOutput = 255;
+        else
+            *pOutput = 0;
+
+        ++pInput;
+        ++pOutput;
+    }
+}
+
+#ifdef CORE_X86
+// unsigned compare: max(input, threshold) == input <=> input >= threshold
+CORE_TARGET_SSE2 static void thresholdRowSSE2(const uchar *pInput, uchar *pOutput, const int cols,
+                                              const uchar threshold)
+{
+    const __m128i thresholds = _mm_set1_epi8(char(threshold));
+    int c = 0;
+    for (; c + 16 <= cols; c += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *) (pInput + c));
+        _mm_storeu_si128((__m128i *) (pOutput + c), _mm_cmpeq_epi8(_mm_max_epu8(block, thresholds), block));
+    }
+    thresholdRowScalar(pInput + c, pOutput + c, cols - c, threshold);
+}
+
+CORE_TARGET_AVX2 static void thresholdRowAVX2(const uchar *pInput, uchar *pOutput, const int cols,
+                                              const uchar threshold)
+{
+    const __m256i thresholds = _mm256_set1_epi8(char(threshold));
+    int c = 0;
+    for (; c + 32 <= cols; c += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *) (pInput + c));
+        _mm256_storeu_si256((__m256i *) (pOutput + c), _mm256_cmpeq_epi8(_mm256_max_epu8(block, thresholds), block));
+    }
+    thresholdRowScalar(pInput + c, pOutput + c, cols - c, threshold);
+}
+#endif
+
+#ifdef CORE_NEON
+static void thresholdRowNEON(const uchar *pInput, uchar *pOutput, const int cols, const uchar threshold)
+{
+    const uint8x16_t thresholds = vdupq_n_u8(threshold);
+    int c = 0;
+    for (; c + 16 <= cols; c += 16)
+    {
+        vst1q_u8(pOutput + c, vcgeq_u8(vld1q_u8(pInput + c), thresholds));
+    }
+    thresholdRowScalar(pInput + c, pOutput + c, cols - c, threshold);
+}
+#endif
+
+static ThresholdRowFunction getThresholdRow()
+{
+#if defined(CORE_X86)
+    return selectKernel<ThresholdRowFunction>(thresholdRowScalar, thresholdRowSSE2, thresholdRowAVX2, nullptr);
+#elif defined(CORE_NEON)
+    return selectKernel<ThresholdRowFunction>(thresholdRowScalar, nullptr, nullptr, thresholdRowNEON);
+#else
+    return thresholdRowScalar;
+#endif
+}
+
+Threshold::Threshold()
+{}
+
+Threshold::~Threshold()
+{}
+
+////////////////////////////////////////////////////////////////////////////////////
+// compute threshold image using the OpenCV function - only for reference
+////////////////////////////////////////////////////////////////////////////////////
+void Threshold::cv(const cv::Mat &input, cv::Mat &output, uchar threshold)
+{
+    cv::threshold(input, output, threshold, 255, cv::THRESH_BINARY);
+}
+
+////////////////////////////////////////////////////////////////////////////////////
+// compute threshold image by looping over the elements
+////////////////////////////////////////////////////////////////////////////////////
+void Threshold::loop(const cv::Mat &input, cv::Mat &output, uchar threshold)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    output.create(rows, cols, CV_8U);
+
+    for (int r = 0; r < rows; ++r)
+    {
+        for (int c = 0; c < cols; ++c)
+        {
+            if (input.at<uchar>(r, c) >= threshold)
+                output.at<uchar>(r, c) = 255;
+            else
+                output.at<uchar>(r, c) = 0;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// compute threshold image by looping over the elements (pointer access)
+///////////////////////////////////////////////////////////////////////////////
+void Threshold::loop_ptr(const cv::Mat &input, cv::Mat &output, uchar threshold)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    output.create(rows, cols, CV_8U);
+
+    if (input.isContinuous())
+    {
+
+    }
+
+    for (int r = 0; r < rows; ++r)
+    {
+        const uchar *pInput = input.ptr<uchar>(r);
+        uchar *pOutput = output.ptr<uchar>(r);
+
+        for (int c = 0; c < cols; ++c)
+        {
+
+            if (pInput[c] >= threshold)
+                pOutput[c] = 255;
+            else
+                pOutput[c] = 0;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// compute threshold image by looping over the elements (pointer access)
+///////////////////////////////////////////////////////////////////////////////
+void Threshold::loop_ptr2(const cv::Mat &input, cv::Mat &output, uchar threshold)
+{
+    int rows = input.rows;
+    int cols = input.cols;
+
+    output.create(rows, cols, CV_8U);
+
+    if (input.isContinuous() && output.isContinuous())
+    {
+        cols = rows*cols;
+        rows = 1;
+    }
+
+    // kernel of the CPU (selected at the first call)
+    static const ThresholdRowFunction thresholdRow = getThresholdRow();
+    for (int r = 0; r < rows; ++r)
+    {
+        thresholdRow(input.ptr<uchar>(r), output.ptr<uchar>(r), cols, threshold);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// threshold of a region of interest (same origin, can run in place)
+///////////////////////////////////////////////////////////////////////////////
+void Threshold::loop_ptr2(const RoiImage &input, RoiImage &output, uchar threshold)
+{
+    RoiImage::reuseBuffer(output.mat, input.mat.size(), CV_8U);
+    loop_ptr2(input.mat, output.mat, threshold);
+    output.origin = input.origin;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// adaptive threshold with the local mean of an integral image
+///////////////////////////////////////////////////////////////////////////////
+void Threshold::adaptive(const cv::Mat &input, cv::Mat &output, const int windowSize, const int offset,
+                         const int threads)
+{
+    if (input.type() != CV_8U || windowSize < 1)
+    {
+        std::cout << "Threshold: adaptive needs a CV_8U input and a window of at least 1 px!" << std::endl;
+        return;
+    }
+
+    // each output pixel reads only its input pixel (and the integral) -> can run in place
+    // (local object: the threshold can be called from several threads)
+    IntegralImage integral;
+    integral.compute(input, false, threads);
+
+    int rows = input.rows;
+    int cols = input.cols;
+    cv::Size window(windowSize, windowSize);
+    Border border = integral.getBorder(window);
+    output.create(rows, cols, CV_8U);
+
+    // compare the sums: pixel * area > sum - offset * area (no division)
+    double area = window.area();
+    cv::Rect valid = border.valid(input.size());
+    for (int r = valid.y; r < valid.y + valid.height; ++r)
+    {
+        const uchar *pInput = input.ptr<uchar>(r);
+        uchar *pOutput = output.ptr<uchar>(r);
+        for (int c = valid.x; c < valid.x + valid.width; ++c)
+        {
+            double sum = integral.sum(cv::Rect(c - border.left, r - border.top, windowSize, windowSize));
+            pOutput[c] = (pInput[c] * area > sum - offset * area) ? 255 : 0;
+        }
+    }
+    border.clear(output);
+}
@@ -0,0 +1,29 @@
+#ifndef THRESHOLD_H
+#define THRESHOLD_H
+
+#include <opencv2/core/core.hpp>
+#include "RoiImage.h"
+
+class Threshold
+{
+public:
+    Threshold();
+
+    ~Threshold();
+
+    // the thresholds can run in place and write into an output view of the size of the input
+    void cv(const cv::Mat &input, cv::Mat &output, uchar threshold);
+    void loop(const cv::Mat &input, cv::Mat &output, uchar threshold);
+    void loop_ptr(const cv::Mat &input, cv::Mat &output, uchar threshold);
+    void loop_ptr2(const cv::Mat &input, cv::Mat &output, uchar threshold);
+    void loop_ptr2(const RoiImage &input, RoiImage &output, uchar threshold);
+
+    // adaptive threshold: output = 255 if input > mean of the window around the pixel - offset, else 0
+    // (window size x size, constant time per pixel for any size, see IntegralImage)
+    // can run in place, the edges (see IntegralImage::getBorder) are set to 0
+    void adaptive(const cv::Mat &input, cv::Mat &output, const int windowSize, const int offset,
+                  const int threads = 1);
+private:
+};
+
+#endif /* THRESHOLD_H */
@@ -4,9 +4,9 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
-#include "Histogram.h"
-#include "PointOperations.h"
-#include "Threshold.h"
+#include "../Core/Histogram.h"
+#include "../Core/PointOperations.h"
+#include "../Core/Threshold.h"
 #include "Timer.h"
 
 bool trackbarChanged = true;
@@ -5,7 +5,7 @@
 #include <opencv2/imgproc/imgproc.hpp>
 
 #include "imshow_multiple.h"
-#include "Morphology.h"
+#include "../Core/Morphology.h"
 
 int main(int argc, char *argv[])
 {
@@ -4,10 +4,10 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
-#include "Threshold.h"
-#include "Histogram.h"
-#include "PointOperations.h"
-#include "Filter.h"
+#include "../Core/Threshold.h"
+#include "../Core/Histogram.h"
+#include "../Core/PointOperations.h"
+#include "../Core/Filter.h"
 #include "Timer.h"
 #include "imshow_multiple.h"
 
@@ -4,108 +4,9 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include "../Core/Threshold.h"
 #include "Timer.h"
 
-///////////////////////////////////////////////////////////////////////////////
-// compute threshold image using the OpenCV function
-///////////////////////////////////////////////////////////////////////////////
-void threshold_cv(const cv::Mat &input, cv::Mat &output, int threshold)
-{
-    cv::threshold(input, output, threshold, 255, cv::THRESH_BINARY);
-}
-
-///////////////////////////////////////////////////////////////////////////////
-// compute threshold image by looping over the elements
-///////////////////////////////////////////////////////////////////////////////
-void threshold_loop(const cv::Mat &input, cv::Mat &output, int threshold)
-{
-    int rows = input.rows;
-    int cols = input.cols;
-    
-    output.release();
-    output.create(rows, cols, CV_8U);
-    
-    for (int r = 0; r < rows; ++r)
-    {
-        for (int c = 0; c < cols; ++c)
-        {
-            if (input.at<uchar>(r, c) >= threshold)
-                output.at<uchar>(r, c) = 255;
-            else
-                output.at<uchar>(r, c) = 0;
-        }
-    }
-}
-
-///////////////////////////////////////////////////////////////////////////////
-// compute threshold image by looping over the elements (pointer access)
-///////////////////////////////////////////////////////////////////////////////
-void threshold_loop_ptr(const cv::Mat &input, cv::Mat &output, int threshold)
-{
-    int rows = input.rows;
-    int cols = input.cols;
-    
-    output.release();
-    output.create(rows, cols, CV_8U);
-    
-    if (input.isContinuous())
-    {
-        cols = rows*cols;
-        rows = 1;
-    }
-    
-    for (int r = 0; r < rows; ++r)
-    {
-        const uchar *pInput = input.ptr<uchar>(r);
-        uchar *pOutput = output.ptr<uchar>(r);
-        
-        for (int c = 0; c < cols; ++c)
-        {
-            
-            if (pInput[c] >= threshold)
-                pOutput[c] = 255;
-            else
-                pOutput[c] = 0;
-        }
-    }
-}
-
-///////////////////////////////////////////////////////////////////////////////
-// compute threshold image by looping over the elements (pointer access)
-///////////////////////////////////////////////////////////////////////////////
-void threshold_loop_ptr2(const cv::Mat &input, cv::Mat &output, int threshold)
-{
-    int rows = input.rows;
-    int cols = input.cols;
-    
-    output.release();
-    output.create(rows, cols, CV_8U);
-    
-    if (input.isContinuous())
-    {
-        cols = rows*cols;
-        rows = 1;
-    }
-    
-    for (int r = 0; r < rows; ++r)
-    {
-        const uchar *pInput = input.ptr<uchar>(r);
-        uchar *pOutput = output.ptr<uchar>(r);
-        
-        for (int c = 0; c < cols; ++c)
-        {
-            
-            if (*pInput >= threshold)
-                *pOutput = 255;
-            else
-                *pOutput = 0;
-            
-            ++pInput;
-            ++pOutput;
-        }
-    }
-}
-
 int main(int argc, char *argv[])
 {
     //default threshold value
@@ -121,7 +22,7 @@ int main(int argc, char *argv[])
     cv::imshow("Image", img);
 
     //add trackbar to the color image window
-    cv::createTrackbar("Threshold", "Image", &thresholdValue, 400, nullptr);
+    cv::createTrackbar("Threshold", "Image", &thresholdValue, 255, nullptr);
 
     //convert to grayscale
     cv::Mat imgGray;
@@ -129,6 +30,8 @@ int main(int argc, char *argv[])
     //display grayscale
     cv::imshow("Grayscale", imgGray);
 
+    Threshold threshold;
+
     //declare output variables
     cv::Mat output_cv;
     cv::Mat output_loop;
@@ -157,28 +60,28 @@ int main(int argc, char *argv[])
         INIT_TIMER
 
         START_TIMER
-        threshold_cv(imgGray, output_cv, thresholdValue);
+        threshold.cv(imgGray, output_cv, thresholdValue);
         STOP_TIMER("threshold_cv\t")
 
         cv::imshow("threshold_cv", output_cv);
 
 
         START_TIMER
-        threshold_loop(imgGray, output_loop, thresholdValue);
+        threshold.loop(imgGray, output_loop, thresholdValue);
         STOP_TIMER("threshold_loop\t")
 
         cv::imshow("threshold_loop", output_loop);
 
 
         START_TIMER
-        threshold_loop_ptr(imgGray, output_loop_ptr, thresholdValue);
+        threshold.loop_ptr(imgGray, output_loop_ptr, thresholdValue);
         STOP_TIMER("threshold_loop_ptr\t")
 
         cv::imshow("threshold_loop_ptr", output_loop_ptr);
 
 
         START_TIMER
-        threshold_loop_ptr2(imgGray, output_loop_ptr2, thresholdValue);
+        threshold.loop_ptr2(imgGray, output_loop_ptr2, thresholdValue);
         STOP_TIMER("threshold_loop_ptr2\t")
 
         cv::imshow("threshold_loop_ptr2", output_loop_ptr2);